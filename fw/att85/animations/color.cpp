@@ -65,8 +65,11 @@ uint8_t ColorAnimation::handleEvent(Event type, Param param, SharedStorage * sto
         return Result::IS_OK;
 
     case Event::LOAD_CONFIG:
-        color_ = static_cast<uint8_t>(param.loadConfigurationData().data[0]);
+    {
+        const uint8_t color = static_cast<uint8_t>(param.loadConfigurationData().data[0]);
+        color_ = (color >= FIRST_COLOR && color <= LAST_COLOR) ? color : FIRST_COLOR;
         return Result::IS_OK;
     }
+    }
     return Result::IS_OK;
 }
@@ -1,37 +1,22 @@
 #include "animations/rainbow.h"
 
-#include "tools/color.h"
-
 uint8_t RainbowAnimation::handleEvent(Event type, Param param, SharedStorage * storage)
 {
-    auto s = [=]() -> auto & { return *storage->get<Shared>(); };
+    auto s = [=]() -> auto & { return *storage->get<RainbowEffect>(); };
 
     switch (type)
     {
     case Event::START:
-        storage->create<Shared>();
+        storage->create<RainbowEffect>();
+        s().config() = config();
         return Result::IS_OK;
 
     case Event::UPDATE:
-    {
-        ++(s().step);
-        if (2 != s().step)
+        // Strip is only rendered, when the rainbow moves
+        if (!s().step())
             return Result::IGNORE_DEFAULT;
-        s().step = 0;
-
-        uint16_t hue = s().hue;
-        LedState color;
-        for (auto & led: param.ledStrip())
-        {
-            toSaturatedHue(hue, &color);
-            hue = incrementHue(hue, space_increment_);
-            led = color;
-        }
-
-        s().hue = incrementHue(s().hue, -time_increment_);
-
+        s().render(&(param.ledStrip()));
         return Result::IS_OK;
-    }
 
     case Event::STOP:
         return Result::IS_OK;
@@ -40,9 +25,10 @@ uint8_t RainbowAnimation::handleEvent(Event type, Param param, SharedStorage * s
         {
             const auto events = param.events();
             if (events.isFlagSet(Animation::Events::SETTINGS_UP))
-                ++space_increment_;
+                space_increment_ = (space_increment_ + 1) & RainbowEffect::MAX_INCREMENT;
             if (events.isFlagSet(Animation::Events::SETTINGS_DOWN))
-                ++time_increment_;
+                time_increment_ = (time_increment_ + 1) & RainbowEffect::MAX_INCREMENT;
+            s().config() = config();
         }
         return Result::IS_OK;
 
@@ -58,8 +44,8 @@ uint8_t RainbowAnimation::handleEvent(Event type, Param param, SharedStorage * s
     case Event::LOAD_CONFIG:
     {
         const auto & data = param.loadConfigurationData();
-        space_increment_ = data.data[0];
-        time_increment_ = data.data[1];
+        space_increment_ = data.data[0] & RainbowEffect::MAX_INCREMENT;
+        time_increment_ = data.data[1] & RainbowEffect::MAX_INCREMENT;
         return Result::IS_OK;
     }
     }
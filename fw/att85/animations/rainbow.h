@@ -6,26 +6,32 @@
 #define ANIMATIONS_RAINBOW_H_
 
 #include "animation.h"
+#include "effect/rainbow.hpp"
 
 class RainbowAnimation: public Animation
 {
 public:
     RainbowAnimation():
-        space_increment_(8),
-        time_increment_(4)
+        space_increment_(RainbowEffect::Configuration().space_increment),
+        time_increment_(RainbowEffect::Configuration().time_increment)
     { }
 
     uint8_t handleEvent(Event type, Param param, SharedStorage * storage) override;
 
 private:
+    // Only the configuration persists, packed into a single byte, the effect lives in the shared storage
     uint8_t space_increment_: 4;
     uint8_t time_increment_: 4;
 
-    struct Shared
+    RainbowEffect::Configuration config() const
     {
-        uint8_t step = 0;
-        uint16_t hue = 0;
-    };
+        RainbowEffect::Configuration config;
+        config.space_increment = space_increment_;
+        config.time_increment = time_increment_;
+        return config;
+    }
 };
 
+static_assert(RainbowEffect::MAX_INCREMENT <= 0x0F, "Increments need to fit into their bit fields");
+
 #endif  // ANIMATIONS_RAINBOW_H_
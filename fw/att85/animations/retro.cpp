@@ -1,12 +1,10 @@
 #include "animations/retro.h"
 
-#include <stdlib.h>
-
 #include "tools/color.h"
 
-inline void copyColors(LedState (&led)[4])
+inline void copyColors(LedState (&led)[RetroEffect::COLOR_CNT])
 {
-    for (uint8_t color = 0; color != 4; ++color)
+    for (uint8_t color = 0; color != RetroEffect::COLOR_CNT; ++color)
     {
         getColor(&(led[color]), static_cast<ColorId>(static_cast<uint8_t>(ColorId::RED) + color));
     }
@@ -15,22 +13,21 @@ inline void copyColors(LedState (&led)[4])
 
 uint8_t RetroAnimation::handleEvent(Event type, Param param, SharedStorage * storage)
 {
-    auto s = [=]() -> auto & { return *storage->get<Shared>(); };
+    auto s = [=]() -> auto & { return *storage->get<RetroEffect>(); };
 
     switch (type)
     {
     case Event::START:
-        storage->create<Shared>();
+        storage->create<RetroEffect>();
+        s().config() = config_;
         return Result::IS_OK;
 
     case Event::UPDATE:
-        if (0 != s().delay)
-        {
-            --(s().delay);
-            return Result::IGNORE_DEFAULT;
-        }
-        s().delay = static_cast<uint16_t>(render(&(param.ledStrip()), &s())) << 5;
-        return Result::IS_OK;
+    {
+        LedState ram_colors[RetroEffect::COLOR_CNT];
+        copyColors(ram_colors);
+        return s().render(&(param.ledStrip()), ram_colors) ? Result::IS_OK : Result::IGNORE_DEFAULT;
+    }
 
     case Event::STOP:
         return Result::IS_OK;
@@ -41,73 +38,33 @@ uint8_t RetroAnimation::handleEvent(Event type, Param param, SharedStorage * sto
             if (events.isFlagSet(Animation::Events::SETTINGS_UP))
             {
                 s().reset();
-                if (variant_ != (VARIANT_CNT - 1))
-                    ++variant_;
+                if (config_.variant != (RetroEffect::VARIANT_CNT - 1))
+                    ++config_.variant;
             }
             if (events.isFlagSet(Animation::Events::SETTINGS_DOWN))
             {
                 s().reset();
-                if (variant_ != 0)
-                    --variant_;
+                if (config_.variant != 0)
+                    --config_.variant;
             }
+            s().config() = config_;
             if (events.isFlagSet(Animation::Events::NOTE_CHANGED))
-            {
-                if (0 == variant_)
-                    s().delay = 0;
-                s().is_playing = true;
-            }
+                s().noteChanged();
             if (events.isFlagSet(Animation::Events::MUSIC_STOPPED))
-            {
-                if (0 == variant_)
-                    s().delay = 0;
-                s().is_playing = false;
-            }
+                s().musicStopped();
         }
         return Result::IS_OK;
 
     case Event::SAVE_CONFIG:
-        param.saveConfigurationData().data[0] = static_cast<char>(variant_);
+        param.saveConfigurationData().data[0] = static_cast<char>(config_.variant);
         return Result::IS_OK;
 
     case Event::LOAD_CONFIG:
-        variant_ = static_cast<uint8_t>(param.loadConfigurationData().data[0]);
+    {
+        const uint8_t variant = static_cast<uint8_t>(param.loadConfigurationData().data[0]);
+        config_.variant = variant < RetroEffect::VARIANT_CNT ? variant : 0;
         return Result::IS_OK;
     }
-    return Result::IS_OK;
-}
-
-uint8_t RetroAnimation::render(AbstractLedStrip * leds, Shared * shared)
-{
-    LedState ram_colors[4];
-    copyColors(ram_colors);
-
-    uint8_t pos = 0;
-
-    switch (variant_)
-    {
-    case 0:
-    case 1:
-        for (auto & led: *leds)
-        {
-            uint8_t color = ((pos & 0x01) << 1) | (shared->state & 0x01);
-            if (shared->state & 0x02)
-                color ^= 0x02;
-            led = ram_colors[color];
-            ++pos;
-        }
-        ++shared->state;
-        if (0 == variant_)
-            return shared->is_playing ? 255 : (static_cast<uint8_t>(rand()) & static_cast<uint8_t>(0x03)) + 1;
-        else
-            return 4;
-
-    case 2:
-    case 3:
-        pos = shared->state++;
-        for (auto & led: *leds)
-            led = ram_colors[(pos++) & 0x03];
-        return (2 == variant_) ? 4 : 255;
     }
-
-    return 1;
+    return Result::IS_OK;
 }
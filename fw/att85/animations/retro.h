@@ -6,37 +6,18 @@
 #define ANIMATIONS_RETRO_H_
 
 #include "animation.h"
+#include "effect/retro.hpp"
 
 class RetroAnimation: public Animation
 {
 public:
-    RetroAnimation():
-        variant_(0)
-    { }
-
     uint8_t handleEvent(Event type, Param param, SharedStorage * storage) override;
 
 private:
-    static const uint8_t VARIANT_CNT = 4;
-
-    uint8_t variant_: 4;
-
-    struct Shared
-    {
-        uint16_t delay = 0;
-        uint8_t state = 0;
-        bool is_playing = false;
-
-        void reset()
-        {
-            delay = 0;
-            state = 0;
-            is_playing = false;
-        }
-    };
-
-    uint8_t render(AbstractLedStrip * leds, Shared * shared);
-
+    // Only the configuration persists, the effect lives in the shared storage
+    RetroEffect::Configuration config_;
 };
 
+static_assert(sizeof(RetroEffect::Configuration) == 1, "Retro configuration needs to stay a single byte");
+
 #endif  // ANIMATIONS_RETRO_H_
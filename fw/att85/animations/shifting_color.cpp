@@ -70,6 +70,19 @@ private:
     }
 };
 
+/** @brief Longest delay between the shifts in update periods */
+static const uint8_t MAX_DELAY = 15;
+
+inline bool isValidType(const Segment * const * segments, uint8_t type)
+{
+    for (uint8_t n = 0; n <= type; ++n)
+    {
+        if (nullptr == pgm_read_ptr(segments + n))
+            return false;
+    }
+    return true;
+}
+
 inline uint8_t nextType(const Segment * const * segments, uint8_t current)
 {
     const uint8_t next = current + 1;
@@ -109,7 +122,7 @@ uint8_t ShiftingColorAnimation::handleEvent(Event type, Param param, SharedStora
             }
             if (events.isFlagSet(Animation::Events::SETTINGS_DOWN))
             {
-                delay_ = 15 == delay_ ? 1 : delay_ + 1;
+                delay_ = MAX_DELAY == delay_ ? 1 : delay_ + 1;
                 s().step = 0;
             }
         }
@@ -127,8 +140,13 @@ uint8_t ShiftingColorAnimation::handleEvent(Event type, Param param, SharedStora
     case Event::LOAD_CONFIG:
     {
         const auto & data = param.loadConfigurationData();
-        delay_ = data.data[0];
-        type_ = data.data[1];
+        const uint8_t delay = static_cast<uint8_t>(data.data[0]);
+        const uint8_t type = static_cast<uint8_t>(data.data[1]);
+        // Stored data may be corrupted, keep the defaults then
+        if (0 != delay && delay <= MAX_DELAY)
+            delay_ = delay;
+        if (isValidType(segments_, type))
+            type_ = type;
         return Result::IS_OK;
     }
     }
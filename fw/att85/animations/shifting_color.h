@@ -7,6 +7,12 @@
 
 #include "animation.h"
 
+/**
+ * @brief Segments of colors shifting along the strip, selected from fixed lists in PROGMEM
+ *
+ * Not shared with the STM32 through effect/, its segments are configurable at runtime and held in RAM,
+ * which would not fit here.
+ */
 class ShiftingColorAnimation: public Animation
 {
 public:
@@ -4,6 +4,9 @@
 
 #include <avr/pgmspace.h>
 
+/** @brief Highest frequency, the twinkles start with 1 in 0x7FFF >> frequency chance */
+static const uint8_t MAX_FREQUENCY = 7;
+
 inline void readPgmColor(LedState * led, const LedState & pgm_led)
 {
     led->red = pgm_read_byte(&pgm_led.red);
@@ -42,7 +45,7 @@ uint8_t TwinkleAnimation::handleEvent(Event type, Param param, SharedStorage * s
             const auto events = param.events();
             if (events.isFlagSet(Animation::Events::SETTINGS_UP))
             {
-                if (7 != frequency_)
+                if (MAX_FREQUENCY != frequency_)
                     ++frequency_;
             }
             if (events.isFlagSet(Animation::Events::SETTINGS_DOWN))
@@ -65,8 +68,10 @@ uint8_t TwinkleAnimation::handleEvent(Event type, Param param, SharedStorage * s
 
     case Event::LOAD_CONFIG:
     {
-        const auto & data = param.loadConfigurationData();
-        frequency_ = data.data[0];
+        const uint8_t frequency = static_cast<uint8_t>(param.loadConfigurationData().data[0]);
+        // Stored data may be corrupted, keep the default then
+        if (frequency <= MAX_FREQUENCY)
+            frequency_ = frequency;
         return Result::IS_OK;
     }
     }
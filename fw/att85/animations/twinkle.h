@@ -7,6 +7,12 @@
 
 #include "animation.h"
 
+/**
+ * @brief Twinkling LEDs following a color sequence in PROGMEM
+ *
+ * Not shared with the STM32 through effect/, its twinkle fades between configurable key frames held in RAM,
+ * which would not fit here.
+ */
 class TwinkleAnimation: public Animation
 {
 public:
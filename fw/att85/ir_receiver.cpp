@@ -1,5 +1,7 @@
 #include "ir_receiver.h"
 
+#include "time_service.h"
+
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
@@ -46,7 +48,7 @@ public:
     uint8_t command() const { return data_[2]; }
 
 private:
-    uint8_t data_[4];
+    uint8_t data_[4] = {};
 
     uint8_t byte_ = 0;
     uint8_t bit_ = 0;
@@ -56,100 +58,165 @@ private:
 struct IrCmd
 {
     static IrCmd Invalid() { return {0xFF, 0x00}; }
-    static IrCmd Repeat() { return {0xFE, 0x00}; }
 
     uint8_t address;
     uint8_t command;
 
     bool isInvalid() const { return 0xFF == address; }
-    bool isRepeat() const { return 0xFE == address; }
 };
 
 
-/**
- * @brief Time-precise function waiting for certain logic level to be detected
- *
- * @param level Level to obtain
- * @param timeout Timeout to wait
- *
- * @return Time it took in ~176 us increments
- * @retval 0xFF Timeout occurred
- */
-__attribute((noinline))
-uint8_t waitForIRLevel(bool level, uint8_t timeout)
+constexpr uint16_t toTicks(uint16_t us)
 {
-    uint16_t duration = 0;
-
-    uint8_t pin_value;
-    asm volatile (
-        "rjmp .ir_wait_L2\n"
-        ".ir_wait_L4:\n"
-        "\t"    "subi %A[duration],-1\n"  // 1 CLK
-        "\t"    "sbci %B[duration],-1\n"  // 1 CLK
-        "\t"    "cp %[timeout],%B[duration]\n"  // 1 CLK
-        "\t"    "breq .ir_wait_L5\n"  // 1 CLK (not taken branch)
-        ".ir_wait_L2:\n"
-        "\t"    "in %[pin_value],%[pinr]\n"  // 1 CLK
-        "\t"    "bst %[pin_value],%[pinb]\n"  // 1 CLK
-        "\t"    "clr %[pin_value]\n"  // 1 CLK
-        "\t"    "bld %[pin_value],0\n"  // 1 CLK
-        "\t"    "cpse %[level],%[pin_value]\n"  // 1 CLK (not skipping)
-        "\t"    "rjmp .ir_wait_L4\n"  // 2 CLK
-        "\t"    "rjmp .ir_wait_exit\n"
-        ".ir_wait_L5:\n"
-        "\t"    "ldi %B[duration],lo8(-1)\n"
-        ".ir_wait_exit:\n"
-        : [duration] "+r" (duration), [pin_value] "=&r" (pin_value)
-        : [level] "r" (level), [timeout] "r" (timeout),
-          [pinr] "I" (_SFR_IO_ADDR(PINB)), [pinb] "I" (PINB0)
-    );
-
-    return duration >> 8;
+    return us / TimeService::TICK_US;
 }
 
-inline bool readIr()
+/**
+ * @brief Length of the NEC protocol pulses in time ticks
+ */
+struct IrTiming
 {
-    return 0 != (PINB & (1 << PINB0));
-}
+    static constexpr uint16_t LEADER_MARK_MIN = toTicks(7000);
+    static constexpr uint16_t LEADER_MARK_MAX = toTicks(11000);
+    static constexpr uint16_t LEADER_SPACE_MIN = toTicks(3500);
+    static constexpr uint16_t LEADER_SPACE_MAX = toTicks(5500);
+    static constexpr uint16_t REPEAT_SPACE_MIN = toTicks(1750);
+    static constexpr uint16_t BIT_MARK_MAX = toTicks(1100);
+    /** @brief Spaces longer than this are ones, shorter are zeroes */
+    static constexpr uint16_t BIT_SPACE_ONE = toTicks(1125);
+    static constexpr uint16_t BIT_SPACE_MAX = toTicks(2250);
+};
+
 
-inline IrCmd receiveCommand()
+/**
+ * @brief NEC protocol decoder fed by the edges of the IR receiver output
+ *
+ * The receiver output is low during the marks (bursts) of the signal. Each
+ * edge is timed by the pin change interrupt, so the edges are only latched by
+ * the hardware while the interrupts are disabled, e.g. during the LED
+ * transmission chunks, and the decoding does not block the application.
+ */
+class IrDecoder
 {
-    // Initial burst
-    if (0xFF == waitForIRLevel(true, 53))
-        return IrCmd::Invalid();
+public:
+    enum class Result: uint8_t
+    {
+        NONE,
+        COMMAND,
+        REPEAT,
+    };
+
+    /**
+     * @brief Process an edge of the IR receiver output
+     *
+     * @param is_high Level of the output after the edge
+     * @param duration Duration of the level before the edge in time ticks
+     */
+    void edge(bool is_high, uint16_t duration)
+    {
+        if (is_high)
+            markEnded(duration);
+        else
+            spaceEnded(duration);
+    }
 
-    // Initial pause
+    /**
+     * @brief Take the result of the last received frame
+     *
+     * @warning Must be called with the interrupts disabled
+     */
+    Result take(IrCmd * command)
     {
-        const uint8_t duration = waitForIRLevel(false, 27);
-        if (0xFF == duration || duration < 10)
-            return IrCmd::Invalid();
-        if (duration < 18)
+        const Result result = result_;
+        result_ = Result::NONE;
+        *command = command_;
+        return result;
+    }
+
+private:
+    enum class State: uint8_t
+    {
+        IDLE,
+        LEADER_MARK,
+        LEADER_SPACE,
+        BIT_MARK,
+        BIT_SPACE,
+    };
+
+    State state_ = State::IDLE;
+    IrData data_;
+    Result result_ = Result::NONE;
+    IrCmd command_ = IrCmd::Invalid();
+
+    void markEnded(uint16_t duration)
+    {
+        switch (state_)
         {
-            // Repeated button
-            waitForIRLevel(true, 4);
-            return IrCmd::Repeat();
+        case State::LEADER_MARK:
+            state_ = (duration >= IrTiming::LEADER_MARK_MIN && duration <= IrTiming::LEADER_MARK_MAX) ?
+                    State::LEADER_SPACE : State::IDLE;
+            break;
+
+        case State::BIT_MARK:
+            state_ = duration <= IrTiming::BIT_MARK_MAX ? State::BIT_SPACE : State::IDLE;
+            break;
+
+        default:
+            // Trailing mark of a frame, or a glitch
+            state_ = State::IDLE;
+            break;
         }
     }
 
-    IrData data;
-    while (!data.isDone())
+    void spaceEnded(uint16_t duration)
     {
-        if (0xFF == waitForIRLevel(true, 4))
-            return IrCmd::Invalid();
+        switch (state_)
+        {
+        case State::LEADER_SPACE:
+            if (duration >= IrTiming::LEADER_SPACE_MIN && duration <= IrTiming::LEADER_SPACE_MAX)
+            {
+                data_ = IrData();
+                state_ = State::BIT_MARK;
+                return;
+            }
+            if (duration >= IrTiming::REPEAT_SPACE_MIN && duration < IrTiming::LEADER_SPACE_MIN)
+            {
+                result_ = Result::REPEAT;
+                state_ = State::IDLE;
+                return;
+            }
+            break;
+
+        case State::BIT_SPACE:
+            if (duration > IrTiming::BIT_SPACE_MAX)
+                break;
+            data_.append(duration > IrTiming::BIT_SPACE_ONE);
+            if (!data_.isDone())
+            {
+                state_ = State::BIT_MARK;
+                return;
+            }
+            if (data_.isValid())
+            {
+                command_ = {data_.address(), data_.command()};
+                result_ = Result::COMMAND;
+            }
+            state_ = State::IDLE;
+            return;
 
-        const uint8_t duration = waitForIRLevel(false, 11);
-        if (0xFF == duration)
-            return IrCmd::Invalid();
+        default:
+            break;
+        }
 
-        data.append(duration > 7);
+        // Any unexpected mark may start a new frame
+        state_ = State::LEADER_MARK;
     }
-    waitForIRLevel(true, 4);
+};
 
-    if (!data.isValid())
-        return IrCmd::Invalid();
 
-    return {data.address(), data.command()};
-}
+IrDecoder ir_decoder;
+uint16_t last_edge_time;
+bool last_is_high = true;
 
 inline IrReceiver::ButtonId decodeButton(IrCmd ir_cmd)
 {
@@ -191,36 +258,57 @@ void IrReceiver::initialize()
     // Use PB0 exclusively as IR input
     DDRB &= ~((1 << DDB0));
     PORTB |= ((1 << DDB0));  // Enable pull-up
+
+    // Time the edges in the pin change interrupt
+    PCMSK |= (1 << PCINT0);
+    GIFR = (1 << PCIF);
+    GIMSK |= (1 << PCIE);
 }
 
 uint8_t IrReceiver::run()
 {
-    if (true == readIr())
-        return 0;
-
     IrCmd command;
+    IrDecoder::Result result;
     {
         volatile uint8_t old_sreg = SREG;
         cli();
-        command = receiveCommand();
+        result = ir_decoder.take(&command);
         SREG = old_sreg;
     }
 
-    if (command.isInvalid())
-        return Status::RECEIVED;
-    else if (command.isRepeat())
+    switch (result)
     {
+    case IrDecoder::Result::NONE:
+        return 0;
+
+    case IrDecoder::Result::REPEAT:
         if (repeat_count_ == REPEAT_SKIP)
         {
             repeat_count_ = 0;
-            return Status::RECEIVED | Status::PRESS;
+            return Status::PRESS;
         }
         ++repeat_count_;
-        return Status::RECEIVED;
+        return 0;
+
+    case IrDecoder::Result::COMMAND:
+        break;
     }
 
     current_button_ = decodeButton(command);
     repeat_count_ = 0;
 
-    return Status::RECEIVED | Status::PRESS;
+    return Status::PRESS;
+}
+
+ISR(PCINT0_vect)
+{
+    // Pin change interrupt is shared by all the port pins
+    const bool is_high = 0 != (PINB & (1 << PINB0));
+    if (is_high == last_is_high)
+        return;
+    last_is_high = is_high;
+
+    const uint16_t now = TimeService::now();
+    ir_decoder.edge(is_high, now - last_edge_time);
+    last_edge_time = now;
 }
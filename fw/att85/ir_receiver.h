@@ -21,12 +21,6 @@ public:
          * @brief Successfully registered a button press
          */
         PRESS = (1 << 0),
-
-        /**
-         * @brief Received something, thus the run function blocked and timing
-         *        is going to be broken
-         */
-        RECEIVED = (1 << 1),
     };
 
     static const uint8_t REPEAT_SKIP = 1;
@@ -34,7 +28,16 @@ public:
 
     ButtonId button() const { return current_button_; }
 
+    /**
+     * @brief Initialize the receiver input and its pin change interrupt
+     */
     void initialize();
+
+    /**
+     * @brief Process the frames decoded by the pin change interrupt
+     *
+     * @return Combination of @ref Status flags
+     */
     uint8_t run();
 
 private:
@@ -1,6 +1,7 @@
 #include "led_controller.h"
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include <avr/pgmspace.h>
 
 static constexpr uint16_t INTENSITY = 0x60;
@@ -14,19 +15,31 @@ namespace
 
 static constexpr uint8_t ZERO_BIT_PULSE_LENGTH = 1;
 static constexpr uint8_t ONE_BIT_PULSE_LENGTH = 3;
-
-
-void blastLeds(const uint8_t * data, const uint8_t * const data_end)
+/**
+ * @brief Number of bytes sent with the interrupts disabled
+ *
+ * A bit takes 13 (zero) or 19 (one) cycles, a byte at most 164 cycles, so
+ * three LEDs take at most 1477 cycles, 92 us at 16 MHz. The pending interrupts
+ * are serviced in between the chunks, well within the ~50 us low period the
+ * LEDs accept as a bit gap. The NEC levels last at least 560 us, so at most
+ * one IR edge is latched per chunk and it is timed late by less than 2 ticks
+ * of the time service, neither the time base nor the IR decoding is lost.
+ */
+static constexpr uint8_t CHUNK_LENGTH = 3 * sizeof(LedState);
+
+
+void blastChunk(const uint8_t * data, const uint8_t * const data_end)
 {
     uint16_t tmp_w;
     uint8_t current_byte;
     uint8_t bit_position;
     uint8_t pulse_length;
-    uint8_t old_sreg;
 
+    // Numeric local labels, the statement may be emitted more than once
     asm volatile (
-            "    rjmp  lu_check_all_sent           \n"
-            "lu_send_byte:                         \n"
+            "    rjmp  5f                          \n"
+            // Send byte
+            "1:                                    \n"
             "    ld    %[current_byte], %a[data]+  \n"
             // Do the lookup table correction
             "    movw  %[tmp_w], %[lookup_table]   \n"
@@ -36,33 +49,33 @@ void blastLeds(const uint8_t * data, const uint8_t * const data_end)
 
             "    ldi   %[bit_position], 8          \n"
 
-            "lu_send_bit:                          \n"
+            // Send bit
+            "2:                                    \n"
             "    ldi   %[pulse_length], %[zero_pl] \n"
             "    lsl   %[current_byte]             \n"
-            "    brcc  lu_pulse_start              \n"
+            "    brcc  3f                          \n"
             "    ldi   %[pulse_length], %[one_pl]  \n"
 
-            "lu_pulse_start:                       \n"
-            "    in %[old_sreg], __SREG__          \n"
-            "    cli                               \n"
+            // Pulse start
+            "3:                                    \n"
             "    sbi   %[pinr], %[pinb]            \n"
 
-            "lu_wait_pulse_end:                    \n"
+            // Wait for the pulse end
+            "4:                                    \n"
             "    subi  %[pulse_length], 1          \n"
-            "    brne  lu_wait_pulse_end           \n"
+            "    brne  4b                          \n"
             "    sbi   %[pinr], %[pinb]            \n"
-            "    out   __SREG__, %[old_sreg]       \n"
 
-            "lu_check_byte_sent:                   \n"
+            // Check whether the byte was sent
             "    dec   %[bit_position]             \n"
-            "    brne  lu_send_bit                 \n"
+            "    brne  2b                          \n"
 
-            "lu_check_all_sent:                    \n"
+            // Check whether all the bytes were sent
+            "5:                                    \n"
             "    cp    %A[data], %A[data_end]      \n"
             "    cpc   %B[data], %B[data_end]      \n"
-            "    brne  lu_send_byte               \n"
+            "    brne  1b                          \n"
             : [current_byte] "=&r" (current_byte),
-              [old_sreg] "=&r" (old_sreg),
               [bit_position] "=&d" (bit_position),
               [pulse_length] "=&d" (pulse_length),
               [tmp_w] "=&z" (tmp_w),
@@ -76,6 +89,24 @@ void blastLeds(const uint8_t * data, const uint8_t * const data_end)
     );
 }
 
+// Single copy of the transmission for both the status LED and the strip, saves flash
+__attribute((noinline))
+void blastLeds(const uint8_t * data, const uint8_t * const data_end)
+{
+    while (data != data_end)
+    {
+        const uint8_t * const chunk_end =
+                (data_end - data) > CHUNK_LENGTH ? data + CHUNK_LENGTH : data_end;
+        {
+            const uint8_t old_sreg = SREG;
+            cli();
+            blastChunk(data, chunk_end);
+            SREG = old_sreg;
+        }
+        data = chunk_end;
+    }
+}
+
 }  // namespace
 
 
@@ -22,6 +22,7 @@ SharedStorage shared_storage;
 NvmStorage nvm_storage;
 AnimationList animations;
 Music music;
+uint8_t save_countdown = 0;
 
 
 inline uint8_t ledStripEvent(Animation::Event type)
@@ -59,12 +60,6 @@ inline void handleButtons(Animation::Events * events)
         if (state & ButtonFilter::PRESS)
             button = buttons.button();
     }
-    if (ir_state & IrReceiver::RECEIVED)
-    {
-        // IR receiver has broken timing of the application, recover from it by
-        // reseting time counter
-        TimeService::restartCounter();
-    }
 
     switch (button)
     {
@@ -107,33 +102,65 @@ inline void handleNvmStorage()
 
     case NvmStorage::Operation::WRITE_ANIMATION:
     {
-        // auto * animation_config = nvm_storage.writeAnimationConfigurationData();
+        auto * animation_config = nvm_storage.writeAnimationConfigurationData();
+        animations.getById(nvm_storage.animationId())->handleEvent(Animation::Event::SAVE_CONFIG,
+                Animation::Param(animation_config), &shared_storage);
         break;
     }
 
     case NvmStorage::Operation::READ_GLOBAL:
     {
         const auto * global_config = nvm_storage.readGlobalConfiguration();
-        animations.setCurrentId(global_config->animatio_id);
+        if (global_config->animatio_id < animations.size())
+            animations.setCurrentId(global_config->animatio_id);
         break;
     }
 
     case NvmStorage::Operation::READ_ANIMATION:
     {
-        // const auto * animation_config = nvm_storage.readAnimationConfigurationData();
+        auto * animation_config = const_cast<AnimationConfigurationData *>(
+                nvm_storage.readAnimationConfigurationData());
+        animations.getById(nvm_storage.animationId())->handleEvent(Animation::Event::LOAD_CONFIG,
+                Animation::Param(animation_config), &shared_storage);
         break;
     }
     }
 }
 
+/**
+ * @brief Postpone saving of the configuration after a change
+ *
+ * Subsequent changes restart the delay, so browsing the settings does not wear
+ * out the EEPROM.
+ */
+inline void scheduleSave(Animation::Events events, uint8_t old_animation_id)
+{
+    // Number of 8 ms periods to wait: 2 seconds
+    static const uint8_t SAVE_DELAY = 250;
+
+    if (events.isFlagSet(Animation::Events::SETTINGS_UP) || events.isFlagSet(Animation::Events::SETTINGS_DOWN) ||
+            old_animation_id != animations.currentId())
+    {
+        save_countdown = SAVE_DELAY;
+    }
+    else if (0 != save_countdown)
+    {
+        // Retry in the next period, when the previous save is still running
+        if (1 != save_countdown || nvm_storage.requestSave(animations.size()))
+            --save_countdown;
+    }
+}
+
 /**
  * @brief Periodic routine called every 8 milliseconds
  */
 void mainPeriodicRoutine()
 {
     Animation::Events events;
+    const uint8_t old_animation_id = animations.currentId();
     analog_in.convert(AnalogIn::Channel::KEYPAD);
     handleButtons(&events);
+    scheduleSave(events, old_animation_id);
 
     {
         const auto music_result = music.play();
@@ -164,10 +191,14 @@ int main(void)
     buttons.initialize();
     ir_receiver.initialize();
 
+    nvm_storage.requestLoad(animations.size());
+    while (nvm_storage.isBusy())
+        handleNvmStorage();
+
     ledStripEvent(Animation::Event::START);
     while(1)
     {
-        //handleNvmStorage();
+        handleNvmStorage();
         if (TimeService::shouldRun())
         {
             mainPeriodicRoutine();
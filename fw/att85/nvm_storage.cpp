@@ -1,18 +1,56 @@
 #include "nvm_storage.h"
 
+#include <string.h>
+
 #include <util/crc16.h>
 #include <avr/eeprom.h>
+#include <avr/interrupt.h>
+#include <avr/io.h>
+
+
+const uint8_t * volatile EepromWriter::data_;
+volatile uintptr_t EepromWriter::address_;
+volatile uint8_t EepromWriter::remaining_;
 
 
 namespace {
 
+static constexpr uintptr_t GLOBAL_ADDRESS = 0;
+static constexpr uintptr_t ANIMATION_ADDRESS = NvmStorage::BUFFER_CAPACITY;
+/**
+ * @brief Initial checksum value, change whenever the record layout changes
+ */
+static constexpr uint8_t CRC_SEED = 0xA5;
+
+static_assert(sizeof(GlobalConfiguration) < NvmStorage::BUFFER_CAPACITY, "Global configuration does not fit");
+static_assert(sizeof(AnimationConfigurationData) < NvmStorage::BUFFER_CAPACITY,
+        "Animation configuration does not fit");
+
+inline uintptr_t animationAddress(uint8_t animation_id)
+{
+    return ANIMATION_ADDRESS + (static_cast<uintptr_t>(animation_id) * NvmStorage::BUFFER_CAPACITY);
+}
+
+uint8_t checksum(const char * data, uint8_t length)
+{
+    uint8_t crc = CRC_SEED;
+    for (uint8_t n = 0; n != length; ++n)
+        crc = _crc8_ccitt_update(crc, static_cast<uint8_t>(data[n]));
+    return crc;
+}
+
 }  // namespace
 
 
-bool EepromBuffer::begin(uint8_t length, uintptr_t address)
+bool EepromWriter::isIdle()
+{
+    return 0 == (EECR & (1 << EERIE));
+}
+
+bool EepromWriter::begin(const void * data, uint8_t length, uintptr_t address)
 {
     {
-        if (length > BUFFER_CAPACITY)
+        if (!isIdle())
             return false;
 
         if (address >= EEPROM_SIZE)
@@ -23,52 +61,118 @@ bool EepromBuffer::begin(uint8_t length, uintptr_t address)
             return false;
     }
 
+    data_ = static_cast<const uint8_t *>(data);
     address_ = address;
-    length_ = length;
-    position_ = 0;
+    remaining_ = length;
+
+    // Interrupt is triggered as long as the EEPROM is ready
+    EECR |= (1 << EERIE);
     return true;
 }
 
-bool EepromBuffer::continueWrite()
-{
-    if (length_ == position_)
-        return true;
 
-    // Wait for previous write to complete
-    if (!eeprom_is_ready())
-        return false;
+auto NvmStorage::run() -> Operation
+{
+    if (!EepromWriter::isIdle())
+        return Operation::NONE;
 
-    // Initiate single byte write
-    EEAR = (address_ + position_);
-    EEDR = buffer_[position_];
-    EECR |= (1 << EEMPE);
-    EECR |= (1 << EEPE);
-    ++position_;
+    if (0 != pending_length_)
+    {
+        const uint8_t length = pending_length_ - 1;
+        buffer_[length] = static_cast<char>(checksum(buffer_, length));
+        EepromWriter::begin(buffer_, pending_length_, pending_address_);
+        pending_length_ = 0;
+        return Operation::NONE;
+    }
 
-    return false;
+    switch (state_)
+    {
+    case State::IDLE:
+        break;
+
+    case State::SAVE_GLOBAL:
+        prepareWrite(GLOBAL_ADDRESS, sizeof(GlobalConfiguration));
+        step_ = 0xFF;
+        state_ = State::SAVE_ANIMATION;
+        return Operation::WRITE_GLOBAL;
+
+    case State::SAVE_ANIMATION:
+        ++step_;
+        if (step_ >= animation_count_ || animationAddress(step_ + 1) > EepromWriter::EEPROM_SIZE)
+        {
+            state_ = State::IDLE;
+            break;
+        }
+        prepareWrite(animationAddress(step_), sizeof(AnimationConfigurationData));
+        return Operation::WRITE_ANIMATION;
+
+    case State::LOAD_GLOBAL:
+        step_ = 0xFF;
+        state_ = State::LOAD_ANIMATION;
+        if (read(GLOBAL_ADDRESS, sizeof(GlobalConfiguration)))
+            return Operation::READ_GLOBAL;
+        break;
+
+    case State::LOAD_ANIMATION:
+        ++step_;
+        if (step_ >= animation_count_ || animationAddress(step_ + 1) > EepromWriter::EEPROM_SIZE)
+        {
+            state_ = State::IDLE;
+            break;
+        }
+        // Records never written are skipped, the animation keeps its defaults
+        if (read(animationAddress(step_), sizeof(AnimationConfigurationData)))
+            return Operation::READ_ANIMATION;
+        break;
+    }
+    return Operation::NONE;
 }
 
-bool EepromBuffer::continueRead()
+void NvmStorage::prepareWrite(uintptr_t address, uint8_t length)
 {
-    if (length_ == position_)
-        return true;
-
-    // EEPROM can not be read from, before previous write completes
-    if (!eeprom_is_ready())
-        return false;
-
-    // Perform single byte read
-    EEAR = (address_ + position_);
-    EECR |= (1 << EERE);
-    buffer_[position_] = EEDR;
-    ++position_;
+    // Unused bytes are cleared, so they match the stored ones next time
+    memset(buffer_, 0, sizeof(buffer_));
+    pending_address_ = address;
+    pending_length_ = length + 1;
+}
 
-    return false;
+bool NvmStorage::read(uintptr_t address, uint8_t length)
+{
+    eeprom_read_block(buffer_, reinterpret_cast<const void *>(address), length + 1);
+    return static_cast<uint8_t>(buffer_[length]) == checksum(buffer_, length);
 }
 
 
-auto NvmStorage::run() -> Operation
+ISR(EE_RDY_vect)
 {
-    return Operation::NONE;
-}
+    while (0 != EepromWriter::remaining_)
+    {
+        const uintptr_t address = EepromWriter::address_;
+        const uint8_t value = *EepromWriter::data_;
+        EepromWriter::address_ = address + 1;
+        EepromWriter::data_ = EepromWriter::data_ + 1;
+        --EepromWriter::remaining_;
+
+        EEAR = address;
+        EECR |= (1 << EERE);
+        const uint8_t stored = EEDR;
+        if (stored == value)
+            continue;
+
+        // Erasing sets all the bits, writing only clears them
+        uint8_t mode = 0;
+        if (0xFF == value)
+            mode = (1 << EEPM0);
+        else if (value == (stored & value))
+            mode = (1 << EEPM1);
+
+        EECR = (1 << EERIE) | mode;
+        EEDR = value;
+        EECR |= (1 << EEMPE);
+        EECR |= (1 << EEPE);
+        return;
+    }
 
+    // Record is written, stop the interrupt
+    EECR &= ~((1 << EERIE));
+}
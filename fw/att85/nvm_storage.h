@@ -21,63 +21,48 @@ struct AnimationConfigurationData
 
 
 /**
- * @brief Tool used to access data located in EEPROM
+ * @brief Writer of EEPROM records driven by the EEPROM ready interrupt
+ *
+ * Bytes equal to the stored ones are skipped and the others are only erased
+ * or only written whenever possible, saving both the time and the wear.
  */
-class EepromBuffer
+class EepromWriter
 {
 public:
-    static const uint8_t BUFFER_CAPACITY = 8;
-
     static const uintptr_t EEPROM_SIZE = 512;
 
-    EepromBuffer():
-        length_(0),
-        position_(0)
-    { }
-
-    bool isDone() const { return length_ == position_; }
-
     /**
-     * @brief Begin writing/writing data in the buffer
-     *
-     * @param length Length of the new operation
-     * @param address EEPROM address to write into / read from
-     *
-     * @return Operation successfully started
+     * @brief Check whether all the bytes of the last record were written
      */
-    bool begin(uint8_t length, uintptr_t address);
+    static bool isIdle();
 
     /**
-     * @brief Continue writing
+     * @brief Begin writing the record in the background
      *
-     * @return Is finished
+     * @param[in] data Record data, must not be modified until the writer is
+     *                 idle again
+     * @param length Length of the record
+     * @param address EEPROM address to write into
+     *
+     * @return Operation successfully started
      */
-    bool continueWrite();
+    static bool begin(const void * data, uint8_t length, uintptr_t address);
 
     /**
-     * @brief Continue writing
-     *
-     * @return Is finished
+     * @brief Next byte to be written, used by the interrupt service routine
      */
-    bool continueRead();
-
-    uint8_t capacity() const { return BUFFER_CAPACITY; }
-
-    void * data() { return reinterpret_cast<void *>(buffer_); }
-
-    const void * data() const { return reinterpret_cast<const void *>(buffer_); }
-    uint8_t lebgth() const { return length_; }
-
-private:
-    uintptr_t address_ = 0;
-    char buffer_[BUFFER_CAPACITY];
-    uint8_t length_;
-    uint8_t position_;
+    static const uint8_t * volatile data_;
+    static volatile uintptr_t address_;
+    static volatile uint8_t remaining_;
 };
 
 
 /**
  * @brief Class managing NVM storage
+ *
+ * Storage walks through the global configuration and the configuration of
+ * each animation, one record at a time. Application fills/reads the record
+ * returned by @ref run(), the records are written in the background.
  */
 class NvmStorage
 {
@@ -91,54 +76,65 @@ public:
         READ_ANIMATION,
     };
 
-    bool requestLoad()
-    {
-        if (State::IDLE != state_)
-            return false;
+    /**
+     * @brief Size of the record buffer: the largest record and its checksum
+     */
+    static const uint8_t BUFFER_CAPACITY = 8;
 
-        return true;
+    /**
+     * @brief Start loading the configuration
+     *
+     * @param animation_count Number of the animations to load
+     *
+     * @return Loading was started
+     */
+    bool requestLoad(uint8_t animation_count)
+    {
+        return request(State::LOAD_GLOBAL, animation_count);
     }
 
-    bool requestSave()
+    /**
+     * @brief Start saving the configuration
+     *
+     * @param animation_count Number of the animations to save
+     *
+     * @return Saving was started
+     */
+    bool requestSave(uint8_t animation_count)
     {
-        if (State::IDLE != state_)
-            return false;
-
-        return true;
+        return request(State::SAVE_GLOBAL, animation_count);
     }
 
+    /**
+     * @brief Check whether a load or save is in progress
+     */
+    bool isBusy() const { return State::IDLE != state_ || 0 != pending_length_; }
+
+    /**
+     * @brief Progress the current load or save
+     *
+     * @return Record the application is expected to fill or read now
+     */
     Operation run();
 
     GlobalConfiguration * writeGlobalConfiguration()
     {
-        return reinterpret_cast<GlobalConfiguration *>(buffer_.data());
+        return reinterpret_cast<GlobalConfiguration *>(buffer_);
     }
 
     AnimationConfigurationData * writeAnimationConfigurationData()
     {
-        return reinterpret_cast<AnimationConfigurationData *>(buffer_.data());
+        return reinterpret_cast<AnimationConfigurationData *>(buffer_);
     }
 
     const GlobalConfiguration * readGlobalConfiguration() const
     {
-        return reinterpret_cast<const GlobalConfiguration *>(buffer_.data());
+        return reinterpret_cast<const GlobalConfiguration *>(buffer_);
     }
 
     const AnimationConfigurationData * readAnimationConfigurationData() const
     {
-        return reinterpret_cast<const AnimationConfigurationData *>(buffer_.data());
-    }
-
-    void noMoreAnimation()
-    {
-        switch (state_)
-        {
-        case State::SAVE_START_ANIMATION:
-        case State::LOAD_START_ANIMATION:
-            state_ = State::IDLE;
-            break;
-        default: break;
-        }
+        return reinterpret_cast<const AnimationConfigurationData *>(buffer_);
     }
 
     uint8_t animationId() const { return step_; }
@@ -148,17 +144,31 @@ private:
     {
         IDLE,
         SAVE_GLOBAL,
-        SAVE_START_ANIMATION,
         SAVE_ANIMATION,
         LOAD_GLOBAL,
-        LOAD_START_ANIMATION,
         LOAD_ANIMATION,
     };
 
-    EepromBuffer buffer_;
+    char buffer_[BUFFER_CAPACITY];
+    /** @brief Record filled by the application, to be written */
+    uintptr_t pending_address_ = 0;
+    uint8_t pending_length_ = 0;
 
+    uint8_t animation_count_ = 0;
     uint8_t step_ = 0;
     State state_ = State::IDLE;
+
+    bool request(State state, uint8_t animation_count)
+    {
+        if (isBusy())
+            return false;
+        animation_count_ = animation_count;
+        state_ = state;
+        return true;
+    }
+
+    void prepareWrite(uintptr_t address, uint8_t length);
+    bool read(uintptr_t address, uint8_t length);
 };
 
 
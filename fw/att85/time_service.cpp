@@ -5,11 +5,28 @@
 #include <util/atomic.h>
 
 volatile bool TimeService::should_run_;
+volatile uint16_t TimeService::period_start_;
+
+namespace
+{
+
+/**
+ * @brief Number of timer ticks in the 8 millisecond period
+ */
+static constexpr uint8_t PERIOD_TICKS = 125;
+static constexpr uint32_t PRESCALER = 1024;
+
+static_assert(PRESCALER * 1000000UL / F_CPU == TimeService::TICK_US &&
+        (PRESCALER * 1000000UL) % F_CPU == 0, "Timer tick must match TICK_US");
+static_assert(PERIOD_TICKS * TimeService::TICK_US == 8000, "Period must last 8 milliseconds");
+
+}  // namespace
 
 
 void TimeService::initialize()
 {
     should_run_ = false;
+    period_start_ = 0;
 
     // Enable interrupts
     sei();
@@ -24,7 +41,7 @@ void TimeService::initialize()
     TIMSK &= ~((1 << TOIE0) | (1 << OCIE0B));
     TIMSK |= (1 << OCIE0A);
     // Overflow every 8 milliseconds: 15.625 kHz / 125 = 125 Hz
-    OCR0A = 124;
+    OCR0A = PERIOD_TICKS - 1;
     // Clear timer on Compare match (CTC) mode, disable compare outputs, frequency: 16 MHz / 1024 = 15.625 kHz
     TCCR0A = (0 << COM0A1) | (0 << COM0A0) |
             (0 << COM0B1) | (0 << COM0B0) |
@@ -34,13 +51,23 @@ void TimeService::initialize()
             (1 << CS02) | (0 << CS01) | (1 << CS00);
 }
 
-void TimeService::restartCounter()
+uint16_t TimeService::now()
 {
-    TCNT0 = 0;
+    uint16_t period_start = period_start_;
+    uint8_t count = TCNT0;
+    // Compare match might not have been serviced yet, the counter has already
+    // been cleared then
+    if (0 != (TIFR & (1 << OCF0A)))
+    {
+        count = TCNT0;
+        period_start += PERIOD_TICKS;
+    }
+    return period_start + count;
 }
 
 ISR(TIM0_COMPA_vect)
 {
+    TimeService::period_start_ += PERIOD_TICKS;
     TimeService::should_run_ = true;
 }
 
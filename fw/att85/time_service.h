@@ -16,9 +16,18 @@ public:
     static void initialize();
 
     /**
-     * @brief Restart time counter
+     * @brief Time tick length in microseconds
      */
-    static void restartCounter();
+    static const uint8_t TICK_US = 64;
+
+    /**
+     * @brief Obtain free-running time in ticks of @ref TICK_US
+     *
+     * Wraps around every ~4.2 seconds, use unsigned differences only.
+     *
+     * @warning Must be called with the interrupts disabled
+     */
+    static uint16_t now();
 
 
     static bool shouldRun()
@@ -33,6 +42,11 @@ public:
      * @brief Variable is set to true every 8 milliseconds
      */
     static volatile bool should_run_;
+
+    /**
+     * @brief Time at the last period start, in ticks of @ref TICK_US
+     */
+    static volatile uint16_t period_start_;
 };
 
 
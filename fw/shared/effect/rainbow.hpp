@@ -0,0 +1,85 @@
+/**
+ * @file
+ */
+
+#ifndef SHARED_EFFECT_RAINBOW_HPP_
+#define SHARED_EFFECT_RAINBOW_HPP_
+
+#include "led_strip.hpp"
+
+#ifdef STM32
+#include "app/tools/color.hpp"
+#else
+#include "tools/color.h"
+#endif
+
+
+/**
+ * @brief Moving rainbow effect shared by all the targets
+ *
+ * @see RetroEffect
+ */
+class RainbowEffect
+{
+public:
+    /** @brief Increments wrap around above this value */
+    static const def::Uint8 MAX_INCREMENT = 15;
+    /** @brief Number of the frames the hue stays the same */
+    static const def::Uint8 STEP_PERIOD = 2;
+
+    struct Configuration
+    {
+        def::Uint8 space_increment = 8;
+        def::Uint8 time_increment = 4;
+    };
+
+    struct State
+    {
+        def::Uint16 hue = 0;
+    };
+
+    Configuration & config() { return config_; }
+    const Configuration & config() const { return config_; }
+    State & state() { return state_; }
+    const State & state() const { return state_; }
+
+    /**
+     * @brief Paint the rainbow at its current position
+     *
+     * @param[out] strip Strip to render onto
+     */
+    void render(AbstractLedStrip * strip) const
+    {
+        LedState color;
+        def::Uint16 hue = state_.hue;
+        for (auto & led: *strip)
+        {
+            toSaturatedHue(hue, &color);
+            hue = incrementHue(hue, config_.space_increment);
+            led = color;
+        }
+    }
+
+    /**
+     * @brief Advance to the next frame
+     *
+     * @return The rainbow has moved
+     */
+    bool step()
+    {
+        ++step_;
+        if (STEP_PERIOD != step_)
+            return false;
+        state_.hue = incrementHue(state_.hue, -config_.time_increment);
+        step_ = 0;
+        return true;
+    }
+
+private:
+    Configuration config_;
+    State state_;
+    def::Uint8 step_ = 0;
+};
+
+
+#endif  // SHARED_EFFECT_RAINBOW_HPP_
@@ -0,0 +1,127 @@
+/**
+ * @file
+ */
+
+#ifndef SHARED_EFFECT_RETRO_HPP_
+#define SHARED_EFFECT_RETRO_HPP_
+
+#include "led_strip.hpp"
+
+#ifdef STM32
+#include <cstdlib>
+#else
+#include <stdlib.h>
+#endif
+
+
+/**
+ * @brief Retro light chain effect shared by all the targets
+ *
+ * Only renders the strip, the animation interface of the target is left to
+ * the owner. Effect has no virtual methods and uses small types, so it fits
+ * the RAM of the smallest target.
+ */
+class RetroEffect
+{
+public:
+    static const def::Uint8 VARIANT_CNT = 4;
+    static const def::Uint8 COLOR_CNT = 4;
+
+    struct Configuration
+    {
+        def::Uint8 variant = 0u;
+    };
+
+    struct State
+    {
+        def::Uint8 state = 0u;
+    };
+
+    Configuration & config() { return config_; }
+    const Configuration & config() const { return config_; }
+    State & state() { return state_; }
+    const State & state() const { return state_; }
+
+    /**
+     * @brief Restart the effect, e.g. after the variant change
+     */
+    void reset()
+    {
+        state_.state = 0u;
+        delay_ = 0u;
+        is_playing_ = false;
+    }
+
+    void noteChanged()
+    {
+        if (0 == config_.variant)
+            delay_ = 0;
+        is_playing_ = true;
+    }
+
+    void musicStopped()
+    {
+        if (0 == config_.variant)
+            delay_ = 0;
+        is_playing_ = false;
+    }
+
+    /**
+     * @brief Render a frame, when it is due
+     *
+     * @param[out] strip Strip to render onto
+     * @param colors Colors of the bulbs
+     *
+     * @return The strip was rendered
+     */
+    bool render(AbstractLedStrip * strip, const LedState (&colors)[COLOR_CNT])
+    {
+        if (0 != delay_)
+        {
+            --delay_;
+            return false;
+        }
+
+        def::Uint8 delay = 1u;
+        def::Uint8 pos = 0;
+        switch (config_.variant)
+        {
+        case 0:
+        case 1:
+            for (auto & led: *strip)
+            {
+                def::Uint8 color = ((pos & 0x01) << 1) | (state_.state & 0x01);
+                if (state_.state & 0x02)
+                    color ^= 0x02;
+                led = colors[color];
+                ++pos;
+            }
+            ++state_.state;
+            if (0 == config_.variant)
+                delay = is_playing_ ? 255 : (static_cast<def::Uint8>(rand()) & static_cast<def::Uint8>(0x03)) + 1;
+            else
+                delay = 4;
+            break;
+
+        case 2:
+        case 3:
+            pos = state_.state++;
+            for (auto & led: *strip)
+                led = colors[(pos++) & 0x03];
+            delay = (2 == config_.variant) ? 4 : 255;
+            break;
+        }
+        delay_ = static_cast<def::Uint16>(delay) << 5;
+        return true;
+    }
+
+private:
+    Configuration config_;
+    State state_;
+
+    def::Uint16 delay_ = 0u;
+    bool is_playing_ = false;
+};
+
+
+#endif  // SHARED_EFFECT_RETRO_HPP_
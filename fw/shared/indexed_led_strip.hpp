@@ -0,0 +1,118 @@
+/**
+ * @file
+ */
+
+#ifndef SHARED_INDEXED_LED_STRIP_HPP_
+#define SHARED_INDEXED_LED_STRIP_HPP_
+
+#include "led_strip.hpp"
+
+
+template <LedSize LED_C, def::Uint8 INDEX_BITS>
+struct IndexedLedStrip;
+
+using AbstractIndexedLedStrip = IndexedLedStrip<1, 8>;
+
+/**
+ * @brief State of a LED strip painted from a small palette
+ *
+ * Each LED holds only an index into the palette, one byte or one nibble wide,
+ * which is 3 to 6 times less memory than @ref LedStrip. The palette is
+ * expanded into the colors by the LED correction, while the data are encoded
+ * for the transfer.
+ *
+ * @tparam LED_C Number of the LEDs
+ * @tparam INDEX_BITS Bits of an index: 4 or 8
+ */
+template <LedSize LED_C, def::Uint8 INDEX_BITS = 4>
+struct IndexedLedStrip
+{
+    static_assert(4 == INDEX_BITS || 8 == INDEX_BITS, "Only nibble and byte indices are supported");
+
+    /** @brief Maximal number of colors in the palette, regardless of the index width */
+    static const def::Uint8 MAX_PALETTE_LENGTH = 16;
+    static const LedSize INDICES_LENGTH = ((static_cast<def::Size>(LED_C) * INDEX_BITS) + 7) / 8;
+
+    IndexedLedStrip():
+        led_count(LED_C),
+        index_bits(INDEX_BITS),
+        palette_length(MAX_PALETTE_LENGTH)
+    { }
+
+    const LedSize led_count;
+    const def::Uint8 index_bits;
+    /** @brief Number of the palette colors in use, only these are corrected */
+    def::Uint8 palette_length;
+    LedState palette[MAX_PALETTE_LENGTH];
+    def::Uint8 indices[INDICES_LENGTH];
+
+    /**
+     * @brief Get the palette index of a LED
+     *
+     * @param id LED ID
+     * @return Palette index
+     */
+    def::Uint8 index(LedSize id) const
+    {
+        if (8 == index_bits)
+            return indices[id];
+        return (indices[id >> 1] >> ((id & 0x01) << 2)) & 0x0F;
+    }
+
+    /**
+     * @brief Set the palette index of a LED
+     *
+     * @param id LED ID
+     * @param value Palette index
+     */
+    void setIndex(LedSize id, def::Uint8 value)
+    {
+        if (8 == index_bits)
+        {
+            indices[id] = value;
+            return;
+        }
+        const def::Uint8 shift = (id & 0x01) << 2;
+        def::Uint8 & pair = indices[id >> 1];
+        pair = (pair & ~(0x0F << shift)) | ((value & 0x0F) << shift);
+    }
+
+    /**
+     * @brief Set all the LEDs to the same palette index
+     *
+     * @param value Palette index
+     */
+    void fill(def::Uint8 value)
+    {
+        const def::Uint8 byte = (8 == index_bits) ? value : ((value & 0x0F) * 0x11);
+        for (LedSize n = 0; n != indicesLength(); ++n)
+            indices[n] = byte;
+    }
+
+    /**
+     * @brief Get the number of the bytes holding the indices
+     */
+    LedSize indicesLength() const
+    {
+        return ((static_cast<def::Size>(led_count) * index_bits) + 7) / 8;
+    }
+
+    /**
+     * @brief Make abstract indexed LED strip pointer
+     *
+     * @return Pointer to an abstract indexed LED strip type
+     */
+    AbstractIndexedLedStrip * abstractPtr()
+    {
+        return reinterpret_cast<AbstractIndexedLedStrip *>(this);
+    }
+
+    /** @copydoc abstractPtr() */
+    const AbstractIndexedLedStrip * abstractPtr() const
+    {
+        return reinterpret_cast<const AbstractIndexedLedStrip *>(this);
+    }
+};
+
+
+#endif  // SHARED_INDEXED_LED_STRIP_HPP_
@@ -4,6 +4,7 @@ import sys
 import os.path
 import re
 import argparse
+import struct
 
 
 class Tone(Enum):
@@ -237,6 +238,61 @@ def native_to_lines(native: List[NativeSongElementType]) -> List[str]:
     return lines
 
 
+# Control types of the element encoding, see `MusicElement` in song.hpp
+CONTROL_FLOW = 0
+CONTROL_SET_OCTAVE = 1
+CONTROL_SILENCE = 2
+NOTE_START = 3
+CONTROL_FLOW_LOOP_END = 0x0F
+
+
+def native_to_bytes(native: List[NativeSongElementType]) -> bytes:
+    data = bytearray()
+    for el in native:
+        if isinstance(el, NativeNote):
+            data.append(((NOTE_START + el.length.value) << 4) | (el.diff + 8))
+        elif isinstance(el, NativeSetOctave):
+            data.append((CONTROL_SET_OCTAVE << 4) | el.octave)
+        elif isinstance(el, Silence):
+            data.append((CONTROL_SILENCE << 4) | el.length.value)
+        elif isinstance(el, LoopControl):
+            data.append((CONTROL_FLOW << 4) | (CONTROL_FLOW_LOOP_END if el.is_end() else el.count))
+    data.append(CONTROL_FLOW << 4)  # Terminate
+    return bytes(data)
+
+
+# Song store image, see `SongStore` in the STM32G0 firmware
+STORE_MAGIC = 0x4753
+STORE_VERSION = 1
+STORE_HEADER = struct.Struct('<HBB')
+STORE_ENTRY = struct.Struct('<HH')
+
+
+def make_store_image(songs: List[bytes]) -> bytes:
+    if len(songs) > 255:
+        raise ValueError('Too many songs')
+    offset = STORE_HEADER.size + (STORE_ENTRY.size * len(songs))
+    image = bytearray(STORE_HEADER.pack(STORE_MAGIC, STORE_VERSION, len(songs)))
+    for song in songs:
+        image += STORE_ENTRY.pack(offset, len(song))
+        offset += len(song)
+    for song in songs:
+        image += song
+    if len(image) > 0xFFFF:
+        raise ValueError('Song store image is too large')
+    return bytes(image)
+
+
+def parse_song_file(name: str) -> List[NativeSongElementType]:
+    song_text = open_file_for_reading(name).read()
+    try:
+        return convert_to_native(SongParser(song_text))
+    except ParsingError as e:
+        line_no = song_text.count('\n', 0, e.position())
+        print(f'{name}: Error on line {line_no}', file=sys.stderr)
+        sys.exit(255)
+
+
 def open_file_for_reading(name: str):
     if '-' == name:
         return sys.stdin
@@ -251,20 +307,29 @@ def open_file_for_writing(name: str):
 
 def main():
     arg_parser = argparse.ArgumentParser(description="Tool to convert songs to code")
-    arg_parser.add_argument("source", metavar="SOURCE", help="Tune source file (*.tune)")
+    arg_parser.add_argument("source", metavar="SOURCE", nargs='+', help="Tune source file (*.tune)")
     arg_parser.add_argument(
         "-o", "--out", metavar="OUTPUT", dest="out", required=False, default='-',
-        help="Tune code to be generated (*.inc)"
+        help="Tune code to be generated (*.inc), or song store image (*.bin)"
+    )
+    arg_parser.add_argument(
+        "--image", action='store_true',
+        help="Generate binary song store image of all the sources, to be programmed into the EEPROM"
     )
     args = arg_parser.parse_args()
 
-    song_text = open_file_for_reading(args.source).read()
-    try:
-        native = convert_to_native(SongParser(song_text))
-    except ParsingError as e:
-        line_no = song_text.count('\n', 0, e.position())
-        print(f'Error on line {line_no}', file=sys.stderr)
-        sys.exit(255)
+    if args.image:
+        image = make_store_image([native_to_bytes(parse_song_file(name)) for name in args.source])
+        if '-' == args.out:
+            sys.stdout.buffer.write(image)
+        else:
+            with open(args.out, "wb") as out_file:
+                out_file.write(image)
+        return
+
+    if len(args.source) != 1:
+        arg_parser.error('Code can be generated from a single source only')
+    native = parse_song_file(args.source[0])
 
     out_file = open_file_for_writing(args.out)
     out_file.write(f"\n\nconst uint8_t {os.path.splitext(os.path.basename(args.out))[0].upper()}[] PROGMEM = {{\n")
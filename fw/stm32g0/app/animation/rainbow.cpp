@@ -7,26 +7,16 @@
 
 void RainbowAnimation::render(AbstractLedStrip * strip, Flags<RenderFlag> flags)
 {
-    LedState color;
-    std::uint16_t hue = state_.hue;
-    for (auto & led: *strip)
-    {
-        toSaturatedHue(hue, &color);
-        hue = incrementHue(hue, config_.space_increment);
-        led = color;
-    }
-
-    ++step_;
-    if (2 == step_)
-    {
-        state_.hue = incrementHue(state_.hue, -config_.time_increment);
-        step_ = 0;
-    }
+    effect_.render(strip);
+    effect_.step();
     (void)flags;
 }
 
 bool RainbowAnimation::setParamater(std::uint32_t param_id, int value, ChangeType type)
 {
+    static const auto MAX = RainbowEffect::MAX_INCREMENT;
+    auto & config = effect_.config();
+
     switch (param_id)
     {
     case Animation::ParamId::SECONDARY:
@@ -36,23 +26,23 @@ bool RainbowAnimation::setParamater(std::uint32_t param_id, int value, ChangeTyp
         {
             if (value > 0)
             {
-                config_.space_increment = setCyclicParameter<std::uint8_t, 15>(
-                    config_.space_increment, 1, ChangeType::RELATIVE);
+                config.space_increment = setCyclicParameter<std::uint8_t, MAX>(
+                    config.space_increment, 1, ChangeType::RELATIVE);
             }
             else if (value < 0)
             {
-                config_.time_increment = setCyclicParameter<std::uint8_t, 15>(
-                    config_.time_increment, 1, ChangeType::RELATIVE);
+                config.time_increment = setCyclicParameter<std::uint8_t, MAX>(
+                    config.time_increment, 1, ChangeType::RELATIVE);
             }
         }
         return true;
 
     case ParamId::SPACE_INCREMENT:
-        config_.space_increment = setCyclicParameter<std::uint8_t, 15>(config_.space_increment, value, type);
+        config.space_increment = setCyclicParameter<std::uint8_t, MAX>(config.space_increment, value, type);
         return true;
 
     case ParamId::TIME_INCREMENT:
-        config_.time_increment = setCyclicParameter<std::uint8_t, 15>(config_.time_increment, value, type);
+        config.time_increment = setCyclicParameter<std::uint8_t, MAX>(config.time_increment, value, type);
         return true;
 
     default:
@@ -66,10 +56,10 @@ std::optional<int> RainbowAnimation::getParameter(std::uint32_t param_id)
     switch (param_id)
     {
     case ParamId::SPACE_INCREMENT:
-        return static_cast<int>(config_.space_increment);
+        return static_cast<int>(effect_.config().space_increment);
 
     case ParamId::TIME_INCREMENT:
-        return static_cast<int>(config_.time_increment);
+        return static_cast<int>(effect_.config().time_increment);
 
     default:
         return {};
@@ -79,17 +69,17 @@ std::optional<int> RainbowAnimation::getParameter(std::uint32_t param_id)
 std::size_t RainbowAnimation::store(void * buffer, std::size_t capacity, DataType type) const
 {
     Serializer ser(buffer, capacity);
-    ser.serialize(&config_);
+    ser.serialize(&effect_.config());
     if (type == DataType::BOTH)
-        ser.serialize(&state_);
+        ser.serialize(&effect_.state());
     return ser.processed(buffer);
 }
 
 std::size_t RainbowAnimation::restore(const void * buffer, std::size_t max_size, DataType type)
 {
     Deserializer de_ser(buffer, max_size);
-    de_ser.deserialize(&config_);
+    de_ser.deserialize(&effect_.config());
     if (type == DataType::BOTH)
-        de_ser.deserialize(&state_);
+        de_ser.deserialize(&effect_.state());
     return de_ser.processed(buffer);
 }
@@ -6,6 +6,7 @@
 #define APP_ANIMATION_RAINBOW_HPP_
 
 #include "app/animation.hpp"
+#include "effect/rainbow.hpp"
 
 
 class RainbowAnimation final:
@@ -27,20 +28,7 @@ public:
     std::size_t restore(const void * buffer, std::size_t max_size, DataType type) override;
 
 private:
-    struct Configuration
-    {
-        std::uint8_t space_increment = 8;
-        std::uint8_t time_increment = 4;
-    };
-
-    struct State
-    {
-        std::uint16_t hue = 0;
-    };
-
-    Configuration config_;
-    State state_;
-    std::uint8_t step_ = 0;
+    RainbowEffect effect_;
 };
 
 
@@ -1,7 +1,6 @@
 #include "app/animation/retro.hpp"
 
 #include <cstdint>
-#include <cstdlib>
 
 #include "tools/serdes.hpp"
 #include "app/tools/animation_parameter.hpp"
@@ -10,9 +9,9 @@
 namespace
 {
 
-inline void copyColors(LedState (&led)[4])
+inline void copyColors(LedState (&led)[RetroEffect::COLOR_CNT])
 {
-    for (std::uint8_t color = 0; color != 4; ++color)
+    for (std::uint8_t color = 0; color != RetroEffect::COLOR_CNT; ++color)
     {
         getColor(&(led[color]), static_cast<ColorId>(static_cast<std::uint8_t>(ColorId::RED) + color));
     }
@@ -24,57 +23,13 @@ inline void copyColors(LedState (&led)[4])
 void RetroAnimation::render(AbstractLedStrip * strip, Flags<RenderFlag> flags)
 {
     if (flags.isFlagSet(RenderFlag::NOTE_CHANGED))
-    {
-        if (0 == config_.variant)
-            delay_ = 0;
-        is_playing_ = true;
-    }
+        effect_.noteChanged();
     if (flags.isFlagSet(RenderFlag::MUSIC_STOPPED))
-    {
-        if (0 == config_.variant)
-            delay_ = 0;
-        is_playing_ = false;
-    }
-
-    if (0 != delay_)
-    {
-        --(delay_);
-        return;
-    }
+        effect_.musicStopped();
 
-    LedState ram_colors[4];
+    LedState ram_colors[RetroEffect::COLOR_CNT];
     copyColors(ram_colors);
-
-    std::uint16_t delay = 1u;
-    uint8_t pos = 0;
-    switch (config_.variant)
-    {
-    case 0:
-    case 1:
-        for (auto & led: *strip)
-        {
-            uint8_t color = ((pos & 0x01) << 1) | (state_.state & 0x01);
-            if (state_.state & 0x02)
-                color ^= 0x02;
-            led = ram_colors[color];
-            ++pos;
-        }
-        ++state_.state;
-        if (0 == config_.variant)
-            delay = is_playing_ ? 255 : (static_cast<uint8_t>(rand()) & static_cast<uint8_t>(0x03)) + 1;
-        else
-            delay = 4;
-        break;
-
-    case 2:
-    case 3:
-        pos = state_.state++;
-        for (auto & led: *strip)
-            led = ram_colors[(pos++) & 0x03];
-        delay = (2 == config_.variant) ? 4 : 255;
-        break;
-    }
-    delay_ = delay << 5;
+    effect_.render(strip, ram_colors);
 }
 
 bool RetroAnimation::setParamater(std::uint32_t param_id, int value, ChangeType type)
@@ -82,10 +37,12 @@ bool RetroAnimation::setParamater(std::uint32_t param_id, int value, ChangeType
     switch (param_id)
     {
     case ParamId::VARIANT:
-        reset();
-        config_.variant = setCyclicParameter<decltype(config_.variant), VARIANT_CNT - 1>(
-            config_.variant, value, type);
+    {
+        effect_.reset();
+        auto & config = effect_.config();
+        config.variant = setCyclicParameter<decltype(config.variant), VARIANT_CNT - 1>(config.variant, value, type);
         return true;
+    }
 
     default:
         return false;
@@ -97,7 +54,7 @@ std::optional<int> RetroAnimation::getParameter(std::uint32_t param_id)
     switch (param_id)
     {
     case ParamId::VARIANT:
-        return static_cast<int>(config_.variant);
+        return static_cast<int>(effect_.config().variant);
 
     default:
         return {};
@@ -107,17 +64,17 @@ std::optional<int> RetroAnimation::getParameter(std::uint32_t param_id)
 std::size_t RetroAnimation::store(void * buffer, std::size_t capacity, DataType type) const
 {
     Serializer ser(buffer, capacity);
-    ser.serialize(&config_);
+    ser.serialize(&effect_.config());
     if (type == DataType::BOTH)
-        ser.serialize(&state_);
+        ser.serialize(&effect_.state());
     return ser.processed(buffer);
 }
 
 std::size_t RetroAnimation::restore(const void * buffer, std::size_t max_size, DataType type)
 {
     Deserializer de_ser(buffer, max_size);
-    de_ser.deserialize(&config_);
+    de_ser.deserialize(&effect_.config());
     if (type == DataType::BOTH)
-        de_ser.deserialize(&state_);
+        de_ser.deserialize(&effect_.state());
     return de_ser.processed(buffer);
 }
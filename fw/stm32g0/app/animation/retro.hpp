@@ -6,6 +6,7 @@
 #define APP_ANIMATION_RETRO_HPP_
 
 #include "app/animation.hpp"
+#include "effect/retro.hpp"
 #include <cstdint>
 
 
@@ -13,7 +14,7 @@ class RetroAnimation final:
         public Animation
 {
 public:
-    static const inline std::uint8_t VARIANT_CNT = 4;
+    static const inline std::uint8_t VARIANT_CNT = RetroEffect::VARIANT_CNT;
 
     enum ParamId: std::uint32_t
     {
@@ -29,28 +30,7 @@ public:
     std::size_t restore(const void * buffer, std::size_t max_size, DataType type) override;
 
 private:
-    struct Configuration
-    {
-        std::uint8_t variant = 0u;
-    };
-
-    struct State
-    {
-        std::uint8_t state = 0u;
-    };
-
-    Configuration config_;
-    State state_;
-
-    std::uint16_t delay_ = 0u;
-    bool is_playing_ = false;
-
-    void reset()
-    {
-        state_.state = 0u;
-        delay_ = 0u;
-        is_playing_ = false;
-    }
+    RetroEffect effect_;
 };
 
 
@@ -51,6 +51,21 @@ void makeAnimation(AnimationStorage::Storage * storage, AnimationId id)
     storage->create<ColorAnimation>();
 }
 
+std::size_t getAnimationSize(AnimationId id)
+{
+    switch (id)
+    {
+        case ANIM_COLOR: return sizeof(ColorAnimation);
+        case ANIM_RAINBOW: return sizeof(RainbowAnimation);
+        case ANIM_RETRO: return sizeof(RetroAnimation);
+        case ANIM_TWINKLE: return sizeof(TwinkleAnimation);
+        case ANIM_SHIFTING_COLOR: return sizeof(ShiftingColorAnimation);
+        case ANIM_LIGHTS: return sizeof(LightsAnimation);
+    }
+    // Default
+    return sizeof(ColorAnimation);
+}
+
 bool applyKeyFrames(Animation * animation, std::uint32_t variant)
 {
     using KeyFrame = TwinkleAnimation::KeyFrame;
@@ -247,3 +262,8 @@ bool AnimationStorage::change(AnimationSlotId new_slot_id)
     slot_id_ = new_slot_id;
     return true;
 }
+
+std::size_t AnimationStorage::animationSize() const
+{
+    return getAnimationSize(slots_[slot_id_].animationId());
+}
@@ -89,6 +89,14 @@ public:
     void initializeCurrentSlot();
 
     AnimationSlotId slotId() const { return slot_id_; }
+
+    /**
+     * @brief Get the size of the current animation object
+     *
+     * @return Size of the animation in bytes, not the size of its stored state
+     */
+    std::size_t animationSize() const;
+
     bool change(AnimationSlotId new_slot_id);
     bool change(AnimationSlotName new_slot_name)
     {
@@ -0,0 +1,176 @@
+/**
+ * @file
+ */
+
+#ifndef APP_AV_SYNC_HPP_
+#define APP_AV_SYNC_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+
+/**
+ * @brief Object measuring the output latency of LED frames and its skew against the music
+ *
+ * The output latency is the time since the rendering of a frame starts until
+ * its LED data are sent out. The music is played ahead by this latency, so
+ * frames reacting to a note change light up together with the note. The skew
+ * is measured on frames, which rendered a note change: it is the time the
+ * frame was sent out minus the time the note started playing.
+ *
+ * Timestamps are values of a free running microsecond counter, which wraps at
+ * 16 bits, times are system times in milliseconds. The start of a note is
+ * stamped from the stamp of the song start and the time of the note in the
+ * song, so the skew keeps the microsecond resolution. It is limited to about
+ * +-32 ms by the wrapping of the counter.
+ */
+class AvSync
+{
+public:
+    using Timestamp = std::uint16_t;
+
+    struct SkewStats
+    {
+        /** @brief Skew of the last note in microseconds, positive when the light lags */
+        std::int32_t last;
+        std::int32_t min;
+        std::int32_t max;
+        /** @brief Sum of the skews, divide by @ref count to get the mean */
+        std::int64_t sum;
+        std::uint32_t count;
+    };
+
+    /**
+     * @brief Note that the buzzer started playing a song
+     *
+     * @param now Current time stamp
+     * @param time Current time in milliseconds
+     */
+    void musicStarted(Timestamp now, std::uint32_t time)
+    {
+        music_stamp_ = now;
+        music_time_ = time;
+    }
+
+    /**
+     * @brief Note that the rendering of a frame has started
+     *
+     * @param now Current time stamp
+     */
+    void frameStarted(Timestamp now)
+    {
+        if (frame_pending_)
+        {
+            // Frames are traced one at a time, skip this one if the previous
+            // one is still being sent out
+            if (!output_done_.load(std::memory_order_acquire))
+                return;
+            collectOutput();
+        }
+
+        frame_stamp_ = now;
+        frame_pending_ = true;
+        note_pending_ = false;
+        output_done_.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Note that the frame being rendered reacts to a note change
+     *
+     * @param note_time Time the note starts playing in milliseconds, since
+     *        the same origin as the time passed to @ref musicStarted()
+     */
+    void noteRendered(std::uint32_t note_time)
+    {
+        if (!frame_pending_)
+            return;
+        // The buzzer times the song from its start in whole milliseconds
+        note_stamp_ = music_stamp_ + static_cast<Timestamp>((note_time - music_time_) * 1000);
+        note_pending_ = true;
+    }
+
+    /**
+     * @brief Note that the LED data were sent out
+     *
+     * Can be called from an interrupt handler.
+     *
+     * @param now Current time stamp
+     */
+    void outputDone(Timestamp now)
+    {
+        output_stamp_.store(now, std::memory_order_relaxed);
+        output_done_.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the measured output latency in microseconds
+     */
+    std::uint32_t outputLatencyUs() const
+    {
+        return (latency_ + (1 << (LATENCY_FILTER_SHIFT - 1))) >> LATENCY_FILTER_SHIFT;
+    }
+
+    /**
+     * @brief Get the measured output latency rounded to milliseconds
+     */
+    std::uint32_t outputLatency() const
+    {
+        return (outputLatencyUs() + 500) / 1000;
+    }
+
+    const SkewStats & skew() const { return skew_; }
+
+    void clearSkew()
+    {
+        skew_ = SkewStats{0, INT32_MAX, INT32_MIN, 0, 0};
+    }
+
+private:
+    /** @brief Weight of a new latency sample is 1/2^LATENCY_FILTER_SHIFT */
+    static const inline std::uint32_t LATENCY_FILTER_SHIFT = 3;
+
+    /** @brief Filtered output latency in 1/2^LATENCY_FILTER_SHIFT microseconds */
+    std::uint32_t latency_ = 0;
+    bool has_latency_ = false;
+
+    Timestamp music_stamp_ = 0;
+    std::uint32_t music_time_ = 0;
+    Timestamp frame_stamp_ = 0;
+    Timestamp note_stamp_ = 0;
+    bool frame_pending_ = false;
+    bool note_pending_ = false;
+
+    std::atomic<Timestamp> output_stamp_ = 0;
+    std::atomic<bool> output_done_ = false;
+
+    SkewStats skew_ = {0, INT32_MAX, INT32_MIN, 0, 0};
+
+    void collectOutput()
+    {
+        frame_pending_ = false;
+
+        const Timestamp output_stamp = output_stamp_.load(std::memory_order_relaxed);
+        const Timestamp latency = output_stamp - frame_stamp_;
+        const std::uint32_t sample = static_cast<std::uint32_t>(latency) << LATENCY_FILTER_SHIFT;
+        if (has_latency_)
+            latency_ = latency_ - (latency_ >> LATENCY_FILTER_SHIFT) + latency;
+        else
+            latency_ = sample;
+        has_latency_ = true;
+
+        if (!note_pending_)
+            return;
+        const std::int32_t skew = static_cast<std::int16_t>(output_stamp - note_stamp_);
+        skew_.last = skew;
+        if (skew < skew_.min)
+            skew_.min = skew;
+        if (skew > skew_.max)
+            skew_.max = skew;
+        skew_.sum += skew;
+        ++skew_.count;
+    }
+};
+
+
+#endif  // APP_AV_SYNC_HPP_
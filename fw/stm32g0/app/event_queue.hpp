@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <utility>
 #include <new>
+#include <atomic>
 #include <type_traits>
 #include <concepts>
 
@@ -29,7 +30,7 @@ enum class EventType
 struct EventParameterStorageType
 {
     alignas(std::uintptr_t)
-    char v[sizeof(std::uintptr_t)];
+    char v[2 * sizeof(std::uintptr_t)];
 };
 
 
@@ -48,8 +49,31 @@ concept EventParameter =
 };
 
 
+/**
+ * @brief Producer guard used by queues, which are filled only from a single context
+ */
+struct SingleProducerGuard
+{
+};
+
+
+/**
+ * @brief Concept of an object guarding the producer side of the event queue
+ *
+ * The guard is constructed before a slot in the queue is claimed and destroyed
+ * after the event is published, e.g. `driver::IrqGuard`.
+ */
+template <typename T>
+concept EventQueueProducerGuard = std::is_default_constructible<T>::value;
+
+
 /**
  * @brief Simple queue object allowing to store events in FIFO fashion
+ *
+ * The queue is lock-free for a single producer and a single consumer, the
+ * producer may run in an interrupt context. In case there are multiple
+ * producers, all of them need to push the events with the same producer guard
+ * (e.g. `driver::IrqGuard`) to serialize the access to the head of the queue.
  */
 class EventQueue
 {
@@ -74,61 +98,171 @@ public:
             return *reinterpret_cast<const T *>(&param_);
         }
 
+        template <EventParameter T>
+        T & param()
+        {
+            return *reinterpret_cast<T *>(&param_);
+        }
+
     private:
         EventType type_;
         EventParameterStorageType param_;
     };
 
-    static const inline std::size_t CAPACITY = 32;
+    static const inline std::size_t CAPACITY = 16;
 
-    template <EventParameter T, typename... Ts>
+    /**
+     * @brief Number of slots, which can only be taken by essential events
+     */
+    static const inline std::size_t ESSENTIAL_RESERVE = 4;
+
+    /**
+     * @brief Push an event into the queue (producer side)
+     *
+     * Regular events can not take the slots reserved for the essential events.
+     *
+     * @tparam T Type of the event parameter
+     * @tparam G Producer guard, see @ref EventQueueProducerGuard
+     *
+     * @param args Arguments passed to the constructor of the event parameter
+     *
+     * @return Success
+     * @retval false Queue is full, the event was counted as dropped
+     */
+    template <EventParameter T, EventQueueProducerGuard G = SingleProducerGuard, typename... Ts>
     bool pushEvent(Ts &&... args)
     {
-        Event * const ev = allocate();
-        if (nullptr == ev)
-            return false;
-        ev->template set<T>(std::forward<Ts>(args)...);
-        return true;
+        return push<T, G>(CAPACITY - 1 - ESSENTIAL_RESERVE, std::forward<Ts>(args)...);
+    }
+
+    /**
+     * @brief Push an essential event into the queue (producer side)
+     *
+     * Essential events, such as key edges, may use the whole capacity of the
+     * queue, so they are not evicted by bursts of regular events.
+     *
+     * @copydetails pushEvent()
+     */
+    template <EventParameter T, EventQueueProducerGuard G = SingleProducerGuard, typename... Ts>
+    bool pushEssentialEvent(Ts &&... args)
+    {
+        return push<T, G>(CAPACITY - 1, std::forward<Ts>(args)...);
+    }
+
+    /**
+     * @brief Find the newest pending event matching a predicate
+     *
+     * The returned event parameter can be modified in place, e.g. to coalesce
+     * a new event into it. This is only safe if the producer runs in the same
+     * context as the consumer.
+     *
+     * @tparam T Type of the event parameter
+     *
+     * @param predicate Callable accepting `const T &` and returning `bool`
+     *
+     * @return Pointer to the parameter of the found event or `nullptr`
+     */
+    template <EventParameter T, typename P>
+    T * findPendingEvent(P && predicate)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        while (tail != pos)
+        {
+            pos = prevPos(pos);
+            Event & event = events_[pos];
+            if (T::TYPE == event.type() && predicate(static_cast<const Event &>(event).template param<T>()))
+                return &event.template param<T>();
+        }
+        return nullptr;
     }
 
+    /**
+     * @brief Get a contiguous block of events (consumer side)
+     *
+     * @return Pointer to the oldest event and number of contiguous events
+     */
     std::pair<const Event *, std::size_t> peek() const
     {
-        if (isContiguous())
-            return {events_ + tail_, head_ - tail_};
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head >= tail)
+            return {events_ + tail, head - tail};
         else
-            return {events_ + tail_, CAPACITY - tail_};
+            return {events_ + tail, CAPACITY - tail};
     }
 
+    /**
+     * @brief Release events obtained by @ref peek() (consumer side)
+     *
+     * @param size Number of events to release
+     */
     void release(std::size_t size)
     {
-        std::size_t next_tail = tail_ + size;
-        tail_ = (CAPACITY != next_tail) ? next_tail : 0;
+        const std::size_t next_tail = tail_.load(std::memory_order_relaxed) + size;
+        tail_.store((CAPACITY != next_tail) ? next_tail : 0, std::memory_order_release);
     }
 
+    /**
+     * @brief Drop all the pending events (consumer side)
+     */
     void discard()
     {
-        head_ = 0;
-        tail_ = 0;
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
     }
 
+    /**
+     * @brief Get number of events, which were dropped since the queue was full
+     */
+    std::uint32_t dropCount() const { return drop_count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the highest number of pending events seen so far
+     */
+    std::size_t highWater() const { return high_water_.load(std::memory_order_relaxed); }
+
 private:
-    std::size_t head_ = 0;
-    std::size_t tail_ = 0;
+    std::atomic<std::size_t> head_ = 0;
+    std::atomic<std::size_t> tail_ = 0;
+    std::atomic<std::uint32_t> drop_count_ = 0;
+    std::atomic<std::size_t> high_water_ = 0;
     Event events_[CAPACITY];
 
-    bool isContiguous() const { return head_ >= tail_; }
+    static std::size_t nextPos(std::size_t pos)
+    {
+        return (CAPACITY - 1) != pos ? pos + 1 : 0;
+    }
+
+    static std::size_t prevPos(std::size_t pos)
+    {
+        return 0 != pos ? pos - 1 : CAPACITY - 1;
+    }
 
-    Event * allocate()
+    template <EventParameter T, EventQueueProducerGuard G, typename... Ts>
+    bool push(std::size_t limit, Ts &&... args)
     {
-        std::size_t next_head = (CAPACITY - 1) != head_ ? head_ + 1 : 0;
-        if (next_head == tail_)
-            return nullptr;
-        Event * ev = events_ + head_;
-        head_ = next_head;
-        return ev;
+        [[maybe_unused]] const G guard;
+
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t pending = (head >= tail) ? (head - tail) : (CAPACITY - tail + head);
+        if (pending >= limit)
+        {
+            drop_count_.store(drop_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        events_[head].template set<T>(std::forward<Ts>(args)...);
+        // Publish the event only after it was completely written
+        head_.store(nextPos(head), std::memory_order_release);
+
+        if (pending + 1 > high_water_.load(std::memory_order_relaxed))
+            high_water_.store(pending + 1, std::memory_order_relaxed);
+        return true;
     }
 };
 
+static_assert(std::atomic<std::size_t>::is_always_lock_free, "Event queue needs lock-free head and tail");
 
 
 #endif  // APP_EVENT_QUEUE_HPP_
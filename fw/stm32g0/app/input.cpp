@@ -1,5 +1,7 @@
 #include "app/input.hpp"
 
+#include <bit>
+
 
 namespace
 {
@@ -39,42 +41,83 @@ inline std::uint8_t updateKeyState(uint8_t previous_flags, uint8_t counter)
     return new_flags;
 }
 
+/**
+ * @brief Merge key repeat into a pending repeat event of the same key
+ *
+ * @return The repeat was merged and no new event is needed
+ */
+inline bool coalesceRepeat(EventQueue * event_queue, Input::KeyId key_id, std::uint8_t repeat)
+{
+    auto * const pending = event_queue->findPendingEvent<Input::EventParam>(
+            [key_id](const Input::EventParam & param) { return key_id == param.key; });
+
+    // Never merge into an edge, the repeat would be reordered before it
+    if (nullptr == pending || Input::KeyState::PRESS != pending->flags)
+        return false;
+
+    pending->repeat = repeat;
+    return true;
+}
+
 }  // namespace
 
-void Input::update(std::uint32_t time, EventQueue * event_queue)
+void Input::update(std::uint32_t time, std::uint16_t timestamp, EventQueue * event_queue)
 {
     {
         PressedButtonList list;
         for (std::size_t src_id = 0; src_id != SOURCE_COUNT; ++src_id)
         {
-            list.resetAll();
+            list.resetAll(timestamp);
             sources_[src_id]->getPressedKeys(time, &list);
 
             {
                 const auto * pos = list.list();
                 const auto * const end = pos + list.count();
                 for (; pos != end; ++pos)
-                    keys_[static_cast<std::size_t>(pos->key_id)].markPressedBy(src_id, pos->is_new);
+                {
+                    const auto key = static_cast<std::size_t>(pos->key_id);
+                    keys_[key].markPressedBy(src_id, pos->is_new, pos->timestamp);
+                    active_keys_ |= KeyMask{1} << key;
+                }
             }
         }
     }
 
-    for (auto & state: keys_)
+    KeyMask remaining = active_keys_;
+    while (0 != remaining)
     {
-        state.process();
+        const auto key = static_cast<std::size_t>(std::countr_zero(remaining));
+        remaining &= remaining - 1;
+
+        auto & state = keys_[key];
+        state.process(timestamp);
+        if (!state.isActive())
+            active_keys_ &= ~(KeyMask{1} << key);
+
         const std::uint32_t event_flags = state.flags() & (KeyState::DOWN | KeyState::UP | KeyState::PRESS);
         if (0 != event_flags)
         {
-            const auto key_id = static_cast<KeyId>(&state - keys_);
-            event_queue->pushEvent<EventParam>(key_id, event_flags, state.repeat(), state.sourceId());
+            const auto key_id = static_cast<KeyId>(key);
+            if (0 != (event_flags & (KeyState::DOWN | KeyState::UP)))
+            {
+                event_queue->pushEssentialEvent<EventParam>(key_id, event_flags, state.repeat(), state.sourceId(),
+                        state.timestamp());
+            }
+            else if (!coalesceRepeat(event_queue, key_id, state.repeat()))
+            {
+                event_queue->pushEvent<EventParam>(key_id, event_flags, state.repeat(), state.sourceId(),
+                        state.timestamp());
+            }
         }
     }
 }
 
 
-void Input::KeyState::process()
+void Input::KeyState::process(std::uint16_t timestamp)
 {
     const auto press_state = readPressState();
+    if (PressState::NONE == press_state)
+        timestamp_ = timestamp;
     if (PressState::NEWLY_PRESSED == press_state)
     {
         repeat_ = 0;
@@ -50,20 +50,40 @@ public:
         {
             KeyId key_id;
             bool is_new;
+            /** @brief Microsecond timestamp of the capture of the key press */
+            std::uint16_t timestamp;
         };
 
         static const std::size_t MAX_LENGTH = 16;
 
-        void resetAll()
+        /**
+         * @brief Empty the list
+         *
+         * @param timestamp Capture timestamp of the keys added without one
+         */
+        void resetAll(std::uint16_t timestamp = 0)
         {
             count_ = 0;
+            timestamp_ = timestamp;
         }
 
         bool addKey(KeyId key, bool is_new = false)
+        {
+            return addKey(key, is_new, timestamp_);
+        }
+
+        /**
+         * @brief Add a key captured before the list was polled
+         *
+         * @param key Pressed key
+         * @param is_new Key was pressed recently
+         * @param timestamp Microsecond timestamp of the capture of the key press
+         */
+        bool addKey(KeyId key, bool is_new, std::uint16_t timestamp)
         {
             if (count_ >= MAX_LENGTH)
                 return false;
-            list_[count_++] = {key, is_new};
+            list_[count_++] = {key, is_new, timestamp};
             return true;
         }
 
@@ -73,6 +93,7 @@ public:
     private:
         PressedButton list_[MAX_LENGTH];
         std::size_t count_ = 0;
+        std::uint16_t timestamp_ = 0;
     };
 
 
@@ -108,6 +129,13 @@ public:
         std::size_t sourceId() const { return source_id_; }
         std::uint8_t flags() const { return flags_; }
         std::uint8_t repeat() const { return repeat_; }
+        /** @brief Capture timestamp of the last change of the key state */
+        std::uint16_t timestamp() const { return timestamp_; }
+
+        /**
+         * @brief Key needs to be processed in next update cycle even if not marked
+         */
+        bool isActive() const { return 0 != (flags_ & PRESSED); }
 
         /**
          * @brief Mark key-press from given source
@@ -117,27 +145,37 @@ public:
          *
          * @param source_id Source reporting the key-press
          * @param is_new Source is reporting freshly pressed button
+         * @param timestamp Microsecond timestamp of the capture of the key press
          */
-        void markPressedBy(std::size_t source_id, bool is_new)
+        void markPressedBy(std::size_t source_id, bool is_new, std::uint16_t timestamp)
         {
             if (INVALID_SOURCE_ID == source_id_)
             {
                 source_id_ = source_id;
                 state_ = PressState::NEWLY_PRESSED;
+                timestamp_ = timestamp;
             }
             else if (source_id == source_id_)
             {
                 if (is_new)
+                {
                     state_ = PressState::NEWLY_PRESSED;
+                    timestamp_ = timestamp;
+                }
                 else if (PressState::NEWLY_PRESSED != state_)  // Prevent regular press to mask-out newly pressed event
+                {
                     state_ = PressState::PRESSED;
+                    timestamp_ = timestamp;
+                }
             }
         }
 
         /**
          * @brief Process marked key presses
+         *
+         * @param timestamp Microsecond timestamp of the update, release of the key is captured by it
          */
-        void process();
+        void process(std::uint16_t timestamp);
 
     private:
         std::uint8_t counter_ = 0;
@@ -145,6 +183,7 @@ public:
         std::uint8_t flags_ = 0;
         std::uint8_t repeat_ = 0;
         PressState state_ = PressState::NONE;
+        std::uint16_t timestamp_ = 0;
 
         PressState readPressState()
         {
@@ -164,6 +203,8 @@ public:
         std::uint8_t flags;
         std::uint8_t repeat;
         std::uint8_t source_id;
+        /** @brief Time the key state was captured, see @ref LatencyTrace */
+        std::uint16_t timestamp;
     };
 
     /**
@@ -196,16 +237,23 @@ public:
      * @brief Call periodically to obtain list of pressed keys
      *
      * @param time Current time
+     * @param timestamp Microsecond timestamp of the update, used as the capture time of the keys, whose sources
+     *        do not timestamp them
      * @param[out] event_queue Event queue that will receive input events
      */
-    void update(std::uint32_t time, EventQueue * event_queue);
+    void update(std::uint32_t time, std::uint16_t timestamp, EventQueue * event_queue);
 
 private:
     using SourceStorage = PolymorphicStorage<Source, 16>;
+    using KeyMask = std::uint32_t;
+
+    static_assert(KEY_COUNT <= sizeof(KeyMask) * 8, "Key mask is too short");
 
     SourceStorage sources_[SOURCE_COUNT];
 
     KeyState keys_[KEY_COUNT];
+    /** @brief Keys which were marked as pressed or still need to be released */
+    KeyMask active_keys_ = 0;
 };
 
 
@@ -0,0 +1,202 @@
+#include "app/input/ir_keymap.hpp"
+
+#include "tools/perfect_hash_map.hpp"
+
+
+namespace
+{
+
+using Protocol = driver::ir::Protocol;
+using KeyId = Input::KeyId;
+
+struct KeymapEntry
+{
+    Protocol protocol;
+    std::uint8_t address;
+    std::uint8_t command;
+    KeyId key;
+};
+
+/**
+ * @brief Codes of the known remotes
+ */
+constexpr KeymapEntry BUILTIN_KEYMAP[] = {
+    {Protocol::NEC, 0x00, 0x18, KeyId::KEY_UP},
+    {Protocol::NEC, 0x00, 0x5A, KeyId::KEY_RIGHT},
+    {Protocol::NEC, 0x00, 0x52, KeyId::KEY_DOWN},
+    {Protocol::NEC, 0x00, 0x08, KeyId::KEY_LEFT},
+    {Protocol::NEC, 0x00, 0x16, KeyId::KEY_O},
+    {Protocol::NEC, 0x00, 0x0D, KeyId::KEY_X},
+    {Protocol::NEC, 0x00, 0x19, KeyId::KEY_0},
+    {Protocol::NEC, 0x00, 0x45, KeyId::KEY_1},
+    {Protocol::NEC, 0x00, 0x46, KeyId::KEY_2},
+    {Protocol::NEC, 0x00, 0x47, KeyId::KEY_3},
+    {Protocol::NEC, 0x00, 0x44, KeyId::KEY_4},
+    {Protocol::NEC, 0x00, 0x40, KeyId::KEY_5},
+    {Protocol::NEC, 0x00, 0x43, KeyId::KEY_6},
+    {Protocol::NEC, 0x00, 0x07, KeyId::KEY_7},
+    {Protocol::NEC, 0x00, 0x15, KeyId::KEY_8},
+    {Protocol::NEC, 0x00, 0x09, KeyId::KEY_9},
+    {Protocol::NEC, 0x00, 0x1C, KeyId::KEY_OK},
+
+    {Protocol::NEC, 0x01, 0x16, KeyId::KEY_UP},
+    {Protocol::NEC, 0x01, 0x50, KeyId::KEY_RIGHT},
+    {Protocol::NEC, 0x01, 0x1A, KeyId::KEY_DOWN},
+    {Protocol::NEC, 0x01, 0x51, KeyId::KEY_LEFT},
+    {Protocol::NEC, 0x01, 0x13, KeyId::KEY_O},
+    {Protocol::NEC, 0x01, 0x19, KeyId::KEY_X},
+    {Protocol::NEC, 0x01, 0x40, KeyId::KEY_POWER},
+    {Protocol::NEC, 0x01, 0x43, KeyId::KEY_RED},
+    {Protocol::NEC, 0x01, 0x0F, KeyId::KEY_GREEN},
+    {Protocol::NEC, 0x01, 0x10, KeyId::KEY_YELLOW},
+    {Protocol::NEC, 0x01, 0x18, KeyId::KEY_BLUE},
+    {Protocol::NEC, 0x01, 0x11, KeyId::KEY_HOME},
+    {Protocol::NEC, 0x01, 0x4C, KeyId::KEY_MENU},
+    {Protocol::NEC, 0x01, 0x01, KeyId::KEY_0},
+    {Protocol::NEC, 0x01, 0x4E, KeyId::KEY_1},
+    {Protocol::NEC, 0x01, 0x0D, KeyId::KEY_2},
+    {Protocol::NEC, 0x01, 0x0C, KeyId::KEY_3},
+    {Protocol::NEC, 0x01, 0x4A, KeyId::KEY_4},
+    {Protocol::NEC, 0x01, 0x09, KeyId::KEY_5},
+    {Protocol::NEC, 0x01, 0x08, KeyId::KEY_6},
+    {Protocol::NEC, 0x01, 0x46, KeyId::KEY_7},
+    {Protocol::NEC, 0x01, 0x05, KeyId::KEY_8},
+    {Protocol::NEC, 0x01, 0x04, KeyId::KEY_9},
+    {Protocol::NEC, 0x01, 0x41, KeyId::KEY_MUTE},
+    {Protocol::NEC, 0x01, 0x42, KeyId::KEY_BACKSPACE},
+};
+
+constexpr std::size_t BUILTIN_KEYMAP_SIZE = sizeof(BUILTIN_KEYMAP) / sizeof(BUILTIN_KEYMAP[0]);
+
+using BuiltinMap = PerfectHashMap<BUILTIN_KEYMAP_SIZE>;
+
+constexpr BuiltinMap makeBuiltinMap()
+{
+    BuiltinMap::Entry entries[BUILTIN_KEYMAP_SIZE] = {};
+    for (std::size_t n = 0; n != BUILTIN_KEYMAP_SIZE; ++n)
+    {
+        const auto & e = BUILTIN_KEYMAP[n];
+        entries[n] = {IrKeymap::toKey(e.protocol, e.address, e.command), static_cast<std::uint8_t>(e.key)};
+    }
+    return BuiltinMap(entries);
+}
+
+constexpr BuiltinMap BUILTIN_MAP = makeBuiltinMap();
+
+static_assert(BUILTIN_MAP.isValid(), "Built-in IR keymap contains duplicate codes");
+
+constexpr std::uint16_t RECORD_MAGIC = 0x4B49;  // "IK"
+
+
+inline std::uint32_t codeKey(const IrKeymap::Code & code)
+{
+    return IrKeymap::toKey(code.protocol(), code.address(), code.command());
+}
+
+}  // namespace
+
+
+IrKeymap::KeyId IrKeymap::decode(const Code & code) const
+{
+    const std::uint32_t key = codeKey(code);
+
+    if (State::LOADING != state_)
+    {
+        const std::uint32_t * const end = record_.entries + record_.count;
+        for (const std::uint32_t * pos = record_.entries; pos != end; ++pos)
+        {
+            if ((*pos >> 8) == key)
+                return static_cast<KeyId>(*pos & 0xFFu);
+        }
+    }
+
+    return static_cast<KeyId>(BUILTIN_MAP.find(key, static_cast<std::uint8_t>(KeyId::KEY_NONE)));
+}
+
+bool IrKeymap::learn(const Code & code)
+{
+    if (!isLearning())
+        return false;
+    // Learned codes were not loaded yet, or failed to, keep learning
+    if (State::LOADING == state_ || State::LOAD == state_)
+        return true;
+
+    const std::uint32_t key = codeKey(code);
+    const std::uint32_t entry = (key << 8) | static_cast<std::uint8_t>(learning_);
+    learning_ = KeyId::KEY_NONE;
+
+    std::size_t pos = 0;
+    while (pos != record_.count && (record_.entries[pos] >> 8) != key)
+        ++pos;
+    if (LEARNED_CAPACITY == pos)
+    {
+        // Full, forget the oldest code
+        for (pos = 1; pos != LEARNED_CAPACITY; ++pos)
+            record_.entries[pos - 1] = record_.entries[pos];
+        pos = LEARNED_CAPACITY - 1;
+    }
+    else if (pos == record_.count)
+        ++record_.count;
+
+    record_.entries[pos] = entry;
+    dirty_ = true;
+    return true;
+}
+
+void IrKeymap::forgetLearned()
+{
+    if (State::LOADING == state_ || State::LOAD == state_)
+        return;
+    record_.count = 0;
+    dirty_ = true;
+}
+
+void IrKeymap::run(driver::i2c::Cat24cx * eeprom)
+{
+    switch (state_)
+    {
+    case State::LOAD:
+        if (eeprom->read(NvmLayout::IR_KEYMAP_ADDRESS, &record_, sizeof(record_), &eeprom_result_))
+            state_ = State::LOADING;
+        break;
+
+    case State::LOADING:
+        if (driver::i2c::Cat24cx::Result::PENDING == eeprom_result_)
+            break;
+        if (driver::i2c::Cat24cx::Result::DONE != eeprom_result_ || RECORD_MAGIC != record_.magic ||
+                record_.count > LEARNED_CAPACITY || checksum(record_) != record_.checksum)
+        {
+            record_ = {};
+            record_.magic = RECORD_MAGIC;
+        }
+        state_ = State::IDLE;
+        break;
+
+    case State::IDLE:
+        if (!dirty_)
+            break;
+        saved_record_ = record_;
+        saved_record_.checksum = checksum(saved_record_);
+        if (eeprom->write(NvmLayout::IR_KEYMAP_ADDRESS, &saved_record_, sizeof(saved_record_), &eeprom_result_))
+        {
+            dirty_ = false;
+            state_ = State::SAVING;
+        }
+        break;
+
+    case State::SAVING:
+        // Codes learned while saving set the dirty flag again
+        if (driver::i2c::Cat24cx::Result::PENDING != eeprom_result_)
+            state_ = State::IDLE;
+        break;
+    }
+}
+
+std::uint8_t IrKeymap::checksum(const Record & record)
+{
+    std::uint8_t sum = record.count;
+    const auto * const bytes = reinterpret_cast<const std::uint8_t *>(record.entries);
+    for (std::size_t n = 0; n != record.count * sizeof(record.entries[0]); ++n)
+        sum += bytes[n];
+    return ~sum;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file
+ */
+
+#ifndef APP_INPUT_IR_KEYMAP_HPP_
+#define APP_INPUT_IR_KEYMAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "app/input.hpp"
+#include "app/nvm_layout.hpp"
+#include "driver/ir_receiver.hpp"
+#include "driver/i2c_bus/cat24cx.hpp"
+
+
+/**
+ * @brief Translation of IR remote codes to keys
+ *
+ * Codes of the known remotes are looked up in a perfect-hash map generated at
+ * compile time. Codes of other remotes can be learned at runtime; these are
+ * kept in a short list stored in the EEPROM, and take precedence over the
+ * built-in codes.
+ */
+class IrKeymap
+{
+public:
+    using Code = driver::IrReceiver::Code;
+    using KeyId = Input::KeyId;
+
+    static const inline std::size_t LEARNED_CAPACITY = 16;
+
+    /**
+     * @brief Pack the code into a 24-bit key of the map
+     */
+    static constexpr std::uint32_t toKey(driver::ir::Protocol protocol, std::uint8_t address, std::uint8_t command)
+    {
+        return (static_cast<std::uint32_t>(protocol) << 16) | (static_cast<std::uint32_t>(address) << 8) | command;
+    }
+
+    /**
+     * @brief Translate a code to a key
+     *
+     * @param code Received code
+     *
+     * @return Key of the code
+     * @retval KeyId::KEY_NONE The code is not known
+     */
+    KeyId decode(const Code & code) const;
+
+    /**
+     * @brief Bind the next newly received code to a key
+     *
+     * @param key Key to learn
+     */
+    void startLearning(KeyId key) { learning_ = key; }
+    bool isLearning() const { return KeyId::KEY_NONE != learning_; }
+
+    /**
+     * @brief Bind the code to the key being learned
+     *
+     * @param code Received code
+     *
+     * @return The code was consumed by learning
+     */
+    bool learn(const Code & code);
+
+    /**
+     * @brief Forget all learned codes
+     */
+    void forgetLearned();
+
+    /**
+     * @brief Load and store learned codes
+     *
+     * Call periodically from background tasks.
+     *
+     * @param eeprom EEPROM storing the learned codes
+     */
+    void run(driver::i2c::Cat24cx * eeprom);
+
+private:
+    enum class State: std::uint8_t
+    {
+        LOAD, LOADING, IDLE, SAVING,
+    };
+
+    /**
+     * @brief Learned codes, same in RAM and in the EEPROM
+     */
+    struct Record
+    {
+        std::uint16_t magic;
+        std::uint8_t count;
+        std::uint8_t checksum;
+        /** @brief Key of the map in upper 24 bits, key ID in lower 8 bits */
+        std::uint32_t entries[LEARNED_CAPACITY];
+    };
+
+    static_assert(sizeof(Record) <= NvmLayout::IR_KEYMAP_SIZE, "Learned codes do not fit the EEPROM region");
+
+    Record record_ = {};
+    /** @brief Copy of the record being written, codes can be learned during the write */
+    Record saved_record_ = {};
+    State state_ = State::LOAD;
+    driver::i2c::Cat24cx::Result eeprom_result_ = driver::i2c::Cat24cx::Result::NONE;
+    KeyId learning_ = KeyId::KEY_NONE;
+    bool dirty_ = false;
+
+    static std::uint8_t checksum(const Record & record);
+};
+
+
+#endif  // APP_INPUT_IR_KEYMAP_HPP_
@@ -6,6 +6,7 @@
 #define APP_INPUT_IR_REMOTE_HPP_
 
 #include "app/input.hpp"
+#include "app/input/ir_keymap.hpp"
 #include "driver/ir_receiver.hpp"
 
 
@@ -13,14 +14,15 @@ class IrRemoteSource final:
         public Input::Source
 {
 public:
-    IrRemoteSource(driver::IrReceiver * receiver):
-        receiver_(receiver)
+    IrRemoteSource(driver::IrReceiver * receiver, IrKeymap * keymap):
+        receiver_(receiver), keymap_(keymap)
     { }
 
     void getPressedKeys(std::uint32_t time, Input::PressedButtonList * buttons) final;
 
 private:
     driver::IrReceiver * const receiver_;
+    IrKeymap * const keymap_;
 };
 
 
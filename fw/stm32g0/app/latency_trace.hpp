@@ -0,0 +1,126 @@
+/**
+ * @file
+ */
+
+#ifndef APP_LATENCY_TRACE_HPP_
+#define APP_LATENCY_TRACE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+#include "driver/tools/latency_histogram.hpp"
+
+
+/**
+ * @brief Object tracing the latency of input events until they reach the LEDs
+ *
+ * Timestamps are values of a free running microsecond counter, which wraps
+ * at 16 bits, therefore latencies up to 65 ms can be measured.
+ */
+class LatencyTrace
+{
+public:
+    using Timestamp = std::uint16_t;
+
+    enum class Stage
+    {
+        /** @brief Key captured by its input source until handled by the application */
+        CAPTURE_TO_DISPATCH,
+        /** @brief Event handled until the rendering of the next frame starts */
+        DISPATCH_TO_FRAME,
+        /** @brief Rendering of the frame starts until the LED data are sent out */
+        FRAME_TO_OUTPUT,
+
+        STAGE_COUNT_,
+    };
+
+    static const inline std::size_t STAGE_COUNT = static_cast<std::size_t>(Stage::STAGE_COUNT_);
+
+    /**
+     * @brief Note that an input event was handled by the application
+     *
+     * @param capture Time the input was captured
+     * @param now Current time
+     */
+    void dispatched(Timestamp capture, Timestamp now)
+    {
+        record(Stage::CAPTURE_TO_DISPATCH, now - capture);
+        if (!dispatch_pending_)
+        {
+            dispatch_pending_ = true;
+            dispatch_time_ = now;
+        }
+    }
+
+    /**
+     * @brief Note that the rendering of a frame has started
+     *
+     * Only frames following a dispatched event are traced further.
+     *
+     * @param now Current time
+     */
+    void frameStarted(Timestamp now)
+    {
+        collectOutput();
+        if (!dispatch_pending_)
+            return;
+        dispatch_pending_ = false;
+
+        record(Stage::DISPATCH_TO_FRAME, now - dispatch_time_);
+        frame_time_ = now;
+        frame_pending_ = true;
+        output_done_.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Note that the LED data were sent out
+     *
+     * Can be called from an interrupt handler.
+     *
+     * @param now Current time
+     */
+    void outputDone(Timestamp now)
+    {
+        output_time_.store(now, std::memory_order_relaxed);
+        output_done_.store(true, std::memory_order_release);
+    }
+
+    const driver::LatencyHistogram & histogram(Stage stage) const
+    {
+        return histograms_[static_cast<std::size_t>(stage)];
+    }
+
+    void clear()
+    {
+        for (auto & histogram: histograms_)
+            histogram.clear();
+    }
+
+private:
+    driver::LatencyHistogram histograms_[STAGE_COUNT];
+
+    Timestamp dispatch_time_ = 0;
+    Timestamp frame_time_ = 0;
+    bool dispatch_pending_ = false;
+    bool frame_pending_ = false;
+
+    std::atomic<Timestamp> output_time_ = 0;
+    std::atomic<bool> output_done_ = false;
+
+    void record(Stage stage, Timestamp latency)
+    {
+        histograms_[static_cast<std::size_t>(stage)].record(latency);
+    }
+
+    void collectOutput()
+    {
+        if (!frame_pending_ || !output_done_.load(std::memory_order_acquire))
+            return;
+        frame_pending_ = false;
+        record(Stage::FRAME_TO_OUTPUT, output_time_.load(std::memory_order_relaxed) - frame_time_);
+    }
+};
+
+
+#endif  // APP_LATENCY_TRACE_HPP_
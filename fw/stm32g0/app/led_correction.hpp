@@ -10,6 +10,7 @@
 #include <utility>
 #include <algorithm>
 #include <type_traits>
+#include <tuple>
 
 #include "led_strip.hpp"
 
@@ -34,6 +35,21 @@ public:
             const LedState * leds, std::size_t count,
             std::uint8_t * buffer, std::size_t capacity) const = 0;
 
+    /**
+     * @brief Correct colors not bound to any position in the strip
+     *
+     * Used for the palettes of the indexed strips, whose colors may end up on
+     * any LED.
+     *
+     * @copydetails correct()
+     */
+    virtual std::size_t correctColors(
+            const LedState * colors, std::size_t count,
+            std::uint8_t * buffer, std::size_t capacity) const
+    {
+        return correct(colors, count, buffer, capacity);
+    }
+
     virtual ~LedCorrection() = default;
 };
 
@@ -124,6 +140,112 @@ private:
 };
 
 
+/**
+ * @brief Object used to write LEDs with gamma correction and dimmed intensity
+ *
+ * Gamma curve is a table generated at compile time, it is stored in the flash.
+ *
+ * @tparam CWT Color writer type
+ * @tparam GAMMA_X10 Gamma exponent multiplied by 10
+ */
+template <ComponentWriter CWT = ComponentWriterRGB, unsigned GAMMA_X10 = 22>
+class GammaLedWriter
+{
+public:
+    static const inline std::size_t LED_LENGTH = 3;
+
+    GammaLedWriter() = delete;
+
+    GammaLedWriter(std::uint32_t intensity):
+        intensity_(intensity)
+    { }
+
+    void writeLed(const LedState & led, std::uint8_t * buffer) const
+    {
+        CWT::setComponents(buffer, correct(led.red), correct(led.green), correct(led.blue));
+    }
+
+    void changeIntensity(std::uint32_t intensity) { intensity_ = intensity; }
+
+private:
+    struct Table
+    {
+        std::uint8_t values[256];
+    };
+
+    std::uint32_t intensity_ = 256;
+
+    std::uint8_t correct(std::uint8_t value) const { return (TABLE.values[value] * intensity_) >> 8; }
+
+    /**
+     * @brief Natural logarithm of a number in (0, 1]
+     */
+    static constexpr double log(double x)
+    {
+        // ln(x) = 2 * atanh((x - 1) / (x + 1))
+        const double z = (x - 1.0) / (x + 1.0);
+        const double z2 = z * z;
+        double term = z, sum = 0.0;
+        for (unsigned n = 1; n < 2000; n += 2)
+        {
+            sum += term / n;
+            term *= z2;
+        }
+        return 2.0 * sum;
+    }
+
+    /**
+     * @brief Exponential of a non-positive number
+     */
+    static constexpr double exp(double x)
+    {
+        double term = 1.0, sum = 1.0;
+        for (unsigned n = 1; n != 100; ++n)
+        {
+            term *= -x / n;
+            sum += term;
+        }
+        return 1.0 / sum;
+    }
+
+    static constexpr Table makeTable()
+    {
+        Table table{};
+        for (unsigned n = 1; n != 256; ++n)
+        {
+            const double value = exp(log(n / 255.0) * (GAMMA_X10 / 10.0)) * 255.0;
+            table.values[n] = static_cast<std::uint8_t>(value + 0.5);
+        }
+        return table;
+    }
+
+    static constexpr Table TABLE = makeTable();
+};
+
+
+/**
+ * @brief Write the LEDs using the writer
+ *
+ * @param writer LED writer object
+ * @param[in] leds LEDs to write
+ * @param count Number of LEDs, the buffer needs to fit all of them
+ * @param[out] buffer Buffer to store the raw data into
+ *
+ * @return Position in the buffer after the last LED
+ */
+template <LedWriter WT>
+std::uint8_t * writeLeds(const WT & writer, const LedState * leds, std::size_t count, std::uint8_t * buffer)
+{
+    const LedState * const leds_end = leds + count;
+    for (const LedState * leds_pos = leds; leds_pos != leds_end; ++leds_pos)
+    {
+        writer.writeLed(*leds_pos, buffer);
+        buffer += WT::LED_LENGTH;
+    }
+    return buffer;
+}
+
+
 /**
  * @brief Common implementation of a LED correction
  *
@@ -146,14 +268,8 @@ public:
             const LedState * leds, std::size_t count,
             std::uint8_t * buffer, std::size_t capacity) const override
     {
-        const LedState * const leds_end = leds + std::min<std::size_t>(count, capacity / LedWriterType::LED_LENGTH);
-        std::uint8_t * buffer_pos = buffer;
-        for (const LedState * leds_pos = leds; leds_pos != leds_end; ++leds_pos)
-        {
-            writer_.writeLed(*leds_pos, buffer_pos);
-            buffer_pos += LedWriterType::LED_LENGTH;
-        }
-        return buffer_pos - buffer;
+        count = std::min<std::size_t>(count, capacity / LedWriterType::LED_LENGTH);
+        return writeLeds(writer_, leds, count, buffer) - buffer;
     }
 
 private:
@@ -161,4 +277,98 @@ private:
 };
 
 
+/**
+ * @brief Range of the LEDs written by the same LED writer
+ *
+ * @tparam WT LED writer object
+ */
+template <LedWriter WT>
+struct LedSegment
+{
+    using LedWriterType = WT;
+
+    /** @brief Number of the LEDs in the segment */
+    std::size_t length;
+    LedWriterType writer;
+};
+
+
+/**
+ * @brief LED correction of a strip chained from segments of different LEDs
+ *
+ * Segments follow each other in the order of the template arguments, each of
+ * them is written by its own loop specialized for its writer, so there is no
+ * branching per LED. The last segment covers all the LEDs past the previous
+ * segments, regardless of its length.
+ *
+ * @tparam WTs LED writer objects of the segments
+ */
+template <LedWriter... WTs>
+class SegmentedLedCorrection final:
+        public LedCorrection
+{
+public:
+    static_assert(0 != sizeof...(WTs), "No segments");
+
+    using FirstWriterType = std::tuple_element_t<0, std::tuple<WTs...>>;
+
+    SegmentedLedCorrection(const LedSegment<WTs> &... segments):
+        segments_(segments...)
+    { }
+
+    /** @copydoc LedCorrection::correct() */
+    std::size_t correct(
+            const LedState * leds, std::size_t count,
+            std::uint8_t * buffer, std::size_t capacity) const override
+    {
+        Cursor cursor{leds, leds + count, buffer, buffer + capacity};
+        writeSegments(&cursor, std::index_sequence_for<WTs...>{});
+        return cursor.buffer - buffer;
+    }
+
+    /**
+     * @copydoc LedCorrection::correctColors()
+     *
+     * The colors are written by the writer of the first segment.
+     */
+    std::size_t correctColors(
+            const LedState * colors, std::size_t count,
+            std::uint8_t * buffer, std::size_t capacity) const override
+    {
+        const auto & segment = std::get<0>(segments_);
+        count = std::min<std::size_t>(count, capacity / FirstWriterType::LED_LENGTH);
+        return writeLeds(segment.writer, colors, count, buffer) - buffer;
+    }
+
+private:
+    struct Cursor
+    {
+        const LedState * leds;
+        const LedState * const leds_end;
+        std::uint8_t * buffer;
+        std::uint8_t * const buffer_end;
+    };
+
+    std::tuple<LedSegment<WTs>...> segments_;
+
+    template <std::size_t... Is>
+    void writeSegments(Cursor * cursor, std::index_sequence<Is...>) const
+    {
+        (writeSegment<(sizeof...(WTs) - 1) == Is>(std::get<Is>(segments_), cursor), ...);
+    }
+
+    template <bool IS_LAST, LedWriter WT>
+    static void writeSegment(const LedSegment<WT> & segment, Cursor * cursor)
+    {
+        std::size_t count = cursor->leds_end - cursor->leds;
+        if constexpr (!IS_LAST)
+            count = std::min<std::size_t>(count, segment.length);
+        count = std::min<std::size_t>(count, (cursor->buffer_end - cursor->buffer) / WT::LED_LENGTH);
+
+        cursor->buffer = writeLeds(segment.writer, cursor->leds, count, cursor->buffer);
+        cursor->leds += count;
+    }
+};
+
+
 #endif  // APP_LED_CORRECTION_HPP_
@@ -1,5 +1,7 @@
 #include "app/lights.hpp"
 
+#include "driver/tools/profiler.hpp"
+#include "driver/tools/trace.hpp"
 #include "app/tools/animation_parameter.hpp"
 #include "app/input/keypad.hpp"
 #include "app/input/ir_remote.hpp"
@@ -9,6 +11,30 @@
 namespace
 {
 
+constexpr std::size_t KEYPAD_SOURCE_ID = 0;
+constexpr std::size_t IR_REMOTE_SOURCE_ID = 1;
+/** @brief Repeat count of the learning keys held for about 2 seconds */
+constexpr std::uint8_t IR_LEARN_REPEAT = 25;
+/** @brief Repeat count of the learning keys held for about 5 seconds */
+constexpr std::uint8_t IR_FORGET_REPEAT = 72;
+
+/**
+ * @brief Bit of a keypad key in the combination starting the IR learning
+ *
+ * @return Bit of the key, zero for keys outside the combination
+ */
+inline std::uint8_t learnKeyBit(Input::KeyId key)
+{
+    switch (key)
+    {
+    case Input::KeyId::KEY_O: return 0x01;
+    case Input::KeyId::KEY_X: return 0x02;
+    default: return 0;
+    }
+}
+
+constexpr std::uint8_t LEARN_KEYS = 0x03;
+
 inline std::size_t changeAnimation(std::size_t current, int dir)
 {
     return setCyclicParameter<std::size_t, AnimationStorage::SLOT_COUNT - 1>(current, dir,
@@ -26,43 +52,83 @@ bool Lights::initialize()
 {
     if (!io_.initialize())
         return false;
+    driver::Profiler::initialize(&io_.cpuUsage());
 
     // Keypad and IR Receiver are now managed by Input and their respective
     // Input Sources, no need to manage them further here
-    input_.createSource<KeypadSource>(0, &io_.keypad());
-    input_.createSource<IrRemoteSource>(1, &io_.irReceiver());
+    input_.createSource<KeypadSource>(KEYPAD_SOURCE_ID, &io_.keypad());
+    input_.createSource<IrRemoteSource>(IR_REMOTE_SOURCE_ID, &io_.irReceiver(), &ir_keymap_);
 
     return true;
 }
 
+void Lights::pollInput(std::uint32_t current_time)
+{
+    const driver::Profiler::Scope scope(driver::Profiler::Zone::INPUT_UPDATE);
+    // Keypad is captured now, IR frames carry the timestamps of the
+    // interrupts decoding them
+    input_.update(current_time, io_.cpuUsage().timestamp(), &event_queue_);
+}
+
 void Lights::step(std::uint32_t current_time)
 {
-    input_.update(current_time, &event_queue_);
+    driver::Trace::record(driver::TraceEvent::FRAME_START, static_cast<std::uint16_t>(current_time));
+    if (is_stepping_ && (current_time - last_step_time_) > STEP_PERIOD)
+    {
+        driver::Trace::record(driver::TraceEvent::FRAME_DROPPED,
+                static_cast<std::uint16_t>(((current_time - last_step_time_) / STEP_PERIOD) - 1));
+    }
+    last_step_time_ = current_time;
+    is_stepping_ = true;
+
     handleEvents();
     {
-        const auto music_result = handleMusic();
+        const auto now = io_.cpuUsage().timestamp();
+        latency_.frameStarted(now);
+        av_sync_.frameStarted(now);
+    }
+    {
+        const auto music_result = handleMusic(current_time);
         Flags<Animation::RenderFlag> flags;
         switch (music_result)
         {
-        case Music::Result::CHANGE: flags.setFlag(Animation::RenderFlag::NOTE_CHANGED); break;
+        case Music::Result::CHANGE:
+            flags.setFlag(Animation::RenderFlag::NOTE_CHANGED);
+            av_sync_.noteRendered(music_.currentNoteTime());
+            break;
         case Music::Result::STOPPED: flags.setFlag(Animation::RenderFlag::MUSIC_STOPPED); break;
         default: break;
         }
-        animation_->render(leds_.abstractPtr(), flags);
-        modifier_.modify(leds_.abstractPtr());
+        {
+            const driver::Profiler::Scope scope(driver::Profiler::Zone::RENDER);
+            animation_->render(leds_.abstractPtr(), flags);
+        }
+        {
+            const driver::Profiler::Scope scope(driver::Profiler::Zone::MODIFIER);
+            modifier_.modify(leds_.abstractPtr());
+        }
     }
+    io_.statusLeds().setLed(driver::StatusLeds::LedId::LED_YELLOW,
+            LearnGesture::SELECTING == learn_gesture_ || ir_keymap_.isLearning());
     io_.statusLeds().update();
-    io_.ledController().update(leds_.abstractPtr());
+    if (!io_.ledController().update(leds_.abstractPtr()))
+        driver::Trace::record(driver::TraceEvent::FRAME_DROPPED, 0);
 }
 
-void Lights::runBackgroundTasks(std::uint32_t current_time)
+void Lights::serviceIo()
 {
     io_.run();
-    (void) current_time;
+}
+
+void Lights::runPersistence()
+{
+    ir_keymap_.run(&io_.eeprom());
+    music_.run(&io_.eeprom());
 }
 
 void Lights::handleEvents()
 {
+    const driver::Profiler::Scope scope(driver::Profiler::Zone::EVENT_HANDLING);
     while (true)
     {
         const auto [ev, cnt] = event_queue_.peek();
@@ -74,7 +140,11 @@ void Lights::handleEvents()
             switch (e->type())
             {
             case EventType::KEY_EVENT:
-                handleInputEvent(e->param<Input::EventParam>());
+                {
+                    const auto & param = e->param<Input::EventParam>();
+                    if (handleInputEvent(param))
+                        latency_.dispatched(param.timestamp, io_.cpuUsage().timestamp());
+                }
                 break;
             default: break;
             }
@@ -83,27 +153,105 @@ void Lights::handleEvents()
     }
 }
 
-Music::Result Lights::handleMusic()
+Music::Result Lights::handleMusic(std::uint32_t current_time)
+{
+    const driver::Profiler::Scope scope(driver::Profiler::Zone::MUSIC);
+
+    // Deliver the notes ahead by the output latency, to the nearest step, so
+    // the frame reacting to a note is sent out when the note starts. Delaying
+    // the song by the latency keeps the notes in phase with the steps.
+    const std::uint32_t latency = av_sync_.outputLatency();
+    music_.setLookahead(latency + (STEP_PERIOD / 2));
+    if (music_.isChangePending())
+    {
+        io_.buzzer().stop();
+        if (music_.start(current_time, latency))
+        {
+            io_.buzzer().play(&music_);
+            av_sync_.musicStarted(io_.cpuUsage().timestamp(), current_time);
+        }
+    }
+    return music_.play(current_time);
+}
+
+bool Lights::handleLearning(const Input::EventParam & e)
 {
-    const auto result = music_.play();
-    switch (result)
+    const bool is_keypad = KEYPAD_SOURCE_ID == e.source_id;
+    const bool is_down = is_keypad && 0 != (e.flags & Input::KeyState::DOWN);
+    // Releases carry no source, the remote does not hold the learning keys
+    const bool is_up = 0 != (e.flags & Input::KeyState::UP);
+    if (is_down)
+        learn_keys_ |= learnKeyBit(e.key);
+    if (is_up)
+        learn_keys_ &= ~learnKeyBit(e.key);
+
+    switch (learn_gesture_)
     {
-    case Music::Result::CHANGE:
-        io_.buzzer().playNote(music_.currentNote());
-        break;
-    case Music::Result::NONE:
-    case Music::Result::STOPPED:
-    case Music::Result::PRE_CHANGE:
-        io_.buzzer().playNote(MusicNote::InvalidNote());
-        break;
-    case Music::Result::PLAYING:
-        break;
+    case LearnGesture::NONE:
+        if (LEARN_KEYS != learn_keys_)
+            return false;
+        learn_gesture_ = LearnGesture::COMBINED;
+        return true;
+
+    case LearnGesture::COMBINED:
+    case LearnGesture::ARMED:
+        if (0 == learn_keys_)
+        {
+            // Learning of the key pressed next follows the combination held long enough
+            learn_gesture_ = LearnGesture::ARMED == learn_gesture_ ? LearnGesture::SELECTING : LearnGesture::NONE;
+        }
+        else if (LEARN_KEYS == learn_keys_ && e.repeat >= IR_FORGET_REPEAT)
+        {
+            ir_keymap_.forgetLearned();
+            learn_gesture_ = LearnGesture::FORGOTTEN;
+        }
+        else if (LEARN_KEYS == learn_keys_ && e.repeat >= IR_LEARN_REPEAT)
+            learn_gesture_ = LearnGesture::ARMED;
+        return true;
+
+    case LearnGesture::FORGOTTEN:
+        if (0 == learn_keys_)
+            learn_gesture_ = LearnGesture::NONE;
+        return true;
+
+    case LearnGesture::SELECTING:
+        if (is_down)
+        {
+            ir_keymap_.startLearning(e.key);
+            learn_gesture_ = LearnGesture::SELECTED;
+        }
+        return true;
+
+    case LearnGesture::SELECTED:
+        if (is_up)
+            learn_gesture_ = LearnGesture::NONE;
+        return true;
     }
-    return result;
+    return false;
 }
 
 bool Lights::handleInputEvent(const Input::EventParam & e)
 {
+    if (handleLearning(e))
+        return true;
+
+    // Music keys act on the release, so holding them to learn IR codes does
+    // not change the song
+    if (0 != (e.flags & Input::KeyState::UP))
+    {
+        switch (e.key)
+        {
+        case Input::KeyId::KEY_O:
+            music_.change(1);
+            return true;
+        case Input::KeyId::KEY_X:
+            music_.change(-1);
+            return true;
+        default:
+            break;
+        }
+    }
+
     if (0 == (e.flags & Input::KeyState::PRESS))
         return false;
     switch (e.key)
@@ -122,12 +270,6 @@ bool Lights::handleInputEvent(const Input::EventParam & e)
     case Input::KeyId::KEY_DOWN:
         animation_->setParamater(Animation::SECONDARY, -1, Animation::ChangeType::RELATIVE);
         return true;
-    case Input::KeyId::KEY_O:
-        music_.change(1);
-        return true;
-    case Input::KeyId::KEY_X:
-        music_.change(-1);
-        return true;
     case Input::KeyId::KEY_0:
         modifier_.next();
         return true;
@@ -142,5 +284,6 @@ void Lights::switchAnimation(int dir)
 {
     const std::size_t next_id = changeAnimation(animation_.slotId(), dir);
     animation_.change(next_id);
+    driver::Trace::record(driver::TraceEvent::SLOT_CHANGE, static_cast<std::uint16_t>(next_id));
 }
 
@@ -11,6 +11,9 @@
 #include "app/animation_storage.hpp"
 #include "app/event_queue.hpp"
 #include "app/input.hpp"
+#include "app/input/ir_keymap.hpp"
+#include "app/av_sync.hpp"
+#include "app/latency_trace.hpp"
 #include "led_strip.hpp"
 #include "app/music.hpp"
 #include "app/led_strip_modifier.hpp"
@@ -22,6 +25,9 @@
 class Lights
 {
 public:
+    /** @brief Period of the application step in milliseconds */
+    static const inline std::uint32_t STEP_PERIOD = 8;
+
     Lights();
 
     /**
@@ -31,23 +37,51 @@ public:
      */
     bool initialize();
 
+    /**
+     * @brief Poll the input sources
+     *
+     * Call every @ref STEP_PERIOD milliseconds, before @ref step().
+     *
+     * @param current_time Current time in milliseconds
+     */
+    void pollInput(std::uint32_t current_time);
+
     /**
      * @brief Led lights application step
      *
-     * Call every 8 ms.
+     * Handles the input events and renders the next frame. Call every
+     * @ref STEP_PERIOD milliseconds.
      *
      * @param current_time Current time in milliseconds
      */
     void step(std::uint32_t current_time);
 
     /**
-     * @brief Perform background tasks
+     * @brief Handle finished I2C transactions and start new ones
+     */
+    void serviceIo();
+
+    /**
+     * @brief Load and store the data kept in the EEPROM
+     */
+    void runPersistence();
+
+    /**
+     * @brief Notify the application that the LED strip update was finished
      *
-     * @param current_time Current time in milliseconds
+     * Called from the interrupt context.
      */
-    void runBackgroundTasks(std::uint32_t current_time);
+    void ledUpdateDone()
+    {
+        const auto now = io_.cpuUsage().timestamp();
+        latency_.outputDone(now);
+        av_sync_.outputDone(now);
+    }
 
     Io & io() { return io_; }
+    const LatencyTrace & latencyTrace() const { return latency_; }
+    const AvSync & avSync() const { return av_sync_; }
+    const Music & music() const { return music_; }
 
 private:
     Io io_;
@@ -56,14 +90,43 @@ private:
 
     EventQueue event_queue_;
     Input input_;
+    IrKeymap ir_keymap_;
     LedStrip<100> leds_;
 
     Music music_;
 
     LedStripModifier modifier_;
 
+    LatencyTrace latency_;
+    AvSync av_sync_;
+
+    /**
+     * @brief Progress of learning an IR code from the keypad
+     *
+     * Holding KEY_O and KEY_X together for about 2 seconds arms the learning,
+     * the keypad key pressed after releasing both of them is the key being
+     * learned, its events are consumed until it is released.
+     * Holding them for about 5 seconds forgets all the learned codes instead.
+     */
+    enum class LearnGesture: std::uint8_t
+    {
+        NONE,
+        COMBINED,  /**< Both keys are held */
+        ARMED,  /**< Both keys are held long enough to learn a key */
+        FORGOTTEN,  /**< Learned codes were forgotten, waiting for the release */
+        SELECTING,  /**< Waiting for the key to learn */
+        SELECTED,  /**< Waiting for the release of the key being learned */
+    };
+
+    std::uint32_t last_step_time_ = 0;
+    bool is_stepping_ = false;
+    LearnGesture learn_gesture_ = LearnGesture::NONE;
+    /** @brief Keys of the learning combination currently held */
+    std::uint8_t learn_keys_ = 0;
+
     void handleEvents();
-    Music::Result handleMusic();
+    Music::Result handleMusic(std::uint32_t current_time);
+    bool handleLearning(const Input::EventParam & e);
     bool handleInputEvent(const Input::EventParam & e);
 
     void switchAnimation(int dir);
@@ -1,32 +1,89 @@
 #include "driver/base.hpp"
 #include "driver/systick.hpp"
-#include "tools/periodic_timer.hpp"
+#include "tools/scheduler.hpp"
 #include "app/lights.hpp"
 
 
 driver::Systick system_time;
-PeriodicTimer led_update_timer;
 
 Lights lights;
 
+/** @brief Time spent sleeping in the current statistics period in microseconds */
+std::uint32_t idle_time = 0;
+/** @brief CPU load in the last statistics period in per mille */
+std::uint16_t cpu_load = 0;
+
+
+namespace
+{
+
+constexpr std::size_t TASK_COUNT = 5;
+/** @brief Period of the CPU load statistics in milliseconds */
+constexpr std::uint16_t STATISTICS_PERIOD = 1000;
+
+void updateStatistics(std::uint32_t time)
+{
+    (void) time;
+    const std::uint32_t period_time = STATISTICS_PERIOD * 1000;
+    cpu_load = idle_time < period_time ? ((period_time - idle_time) / STATISTICS_PERIOD) : 0;
+    idle_time = 0;
+}
+
+/** @brief Tasks in the order of their priority */
+const Scheduler<TASK_COUNT>::Task TASKS[TASK_COUNT] = {
+    {
+        [](std::uint32_t time) { lights.pollInput(time); },
+        Lights::STEP_PERIOD, 2,
+    },
+    {
+        [](std::uint32_t time)
+        {
+            lights.io().cpuUsage().startPeriod();
+            lights.step(time);
+            lights.io().cpuUsage().endPeriod();
+        },
+        Lights::STEP_PERIOD, Lights::STEP_PERIOD / 2,
+    },
+    {
+        [](std::uint32_t time) { (void) time; lights.serviceIo(); },
+        1, 1,
+    },
+    {
+        [](std::uint32_t time) { (void) time; lights.runPersistence(); },
+        4, 4,
+    },
+    {
+        updateStatistics,
+        STATISTICS_PERIOD, STATISTICS_PERIOD,
+    },
+};
+
+}  // namespace
+
+
+Scheduler<TASK_COUNT> scheduler(TASKS, []() { return system_time.currentTime(); });
+
 
 int main()
 {
     driver::Base::init();
     driver::Systick::initialize();
     lights.initialize();
+    scheduler.start(system_time.currentTime());
 
     while (true)
     {
-        const std::uint32_t current_time = system_time.currentTime();
+        if (scheduler.runNext(system_time.currentTime()))
+            continue;
 
-        if (led_update_timer.shouldRun(current_time, 8))
-        {
-            lights.io().cpuUsage().startPeriod();
-            lights.step(current_time);
-            lights.io().cpuUsage().endPeriod();
-        }
-        lights.runBackgroundTasks(current_time);
+        // Interrupts are disabled between the check and the sleep, so the
+        // SysTick releasing a task cannot slip in and delay it by a tick
+        const auto sleep_start = lights.io().cpuUsage().timestamp();
+        driver::Base::disableInterrupts();
+        if (!scheduler.isDue(system_time.currentTime()))
+            driver::Base::waitForInterrupt();
+        driver::Base::enableInterrupts();
+        idle_time += static_cast<std::uint16_t>(lights.io().cpuUsage().timestamp() - sleep_start);
     }
 
     return 0;
@@ -40,7 +97,23 @@ extern "C" void SysTick_Handler()
 
 extern "C" void DMA1_Channel1_IRQHandler()
 {
-    lights.io().ledController().maybeHandleDmaInterrupt();
+    if (lights.io().ledController().maybeHandleDmaInterrupt())
+        lights.ledUpdateDone();
+}
+
+extern "C" void DMA1_Channel2_3_IRQHandler()
+{
+    lights.io().irReceiver().maybeHandleDmaInterrupt();
+}
+
+extern "C" void DMA1_Ch4_7_DMAMUX1_OVR_IRQHandler()
+{
+    lights.io().buzzer().maybeHandleDmaInterrupt();
+}
+
+extern "C" void TIM3_IRQHandler()
+{
+    lights.io().irReceiver().maybeHandleTimerInterrupt();
 }
 
 extern "C" void I2C1_IRQHandler()
@@ -5,33 +5,9 @@
 #include <cstddef>
 
 
-namespace songs
-{
-
-#define PROGMEM
-
-#include "songs/silent_night.inc"
-#include "songs/jingle_bells.inc"
-
-}  // namespace songs
-
-
 namespace
 {
 
-const std::size_t SONG_COUNT = 3;
-
-const std::uint8_t * getSongById(std::uint8_t id)
-{
-    switch (id)
-    {
-    default:
-    case 0: return nullptr;
-    case 1: return songs::SILENT_NIGHT;
-    case 2: return songs::JINGLE_BELLS;
-    }
-}
-
 const std::uint8_t LENGTHS[] = {
         32,  // Whole
         16 + 8,  // Half dot
@@ -53,74 +29,147 @@ inline std::uint8_t getNoteDuration(NoteLength length)
 }  // namespace
 
 
-auto Music::play() -> Result
+bool Music::start(std::uint32_t time, std::uint32_t delay)
 {
-    if (nullptr == position_)
+    change_pending_ = false;
+
+    // Song ID zero is silence, songs of the store follow
+    const int song_count = static_cast<int>(store_.songCount()) + 1;
+    if (current_song_id_ < 0)
+        current_song_id_ = song_count - 1;
+    else if (current_song_id_ >= song_count)
+        current_song_id_ = 0;
+
+    events_.clear();
+    is_open_ = (0 != current_song_id_) && store_.open(current_song_id_ - 1);
+    if (!is_open_)
     {
-        switch (current_song_id_)
+        current_song_id_ = 0;
+        stop_reported_ = false;
+        return false;
+    }
+
+    position_ = 0;
+    loop_id_ = INVALID_LOOP_ID;
+    note_ = MusicNote();
+    song_time_ = 0;
+    drift_ = 0;
+    articulation_pending_ = false;
+
+    // The song time starts after the delay
+    segment_ = driver::Buzzer::silenceSegment(1);
+    remaining_periods_ = delay;
+    start_time_ = time + delay;
+    return true;
+}
+
+auto Music::play(std::uint32_t time) -> Result
+{
+    if (0 == current_song_id_)
+    {
+        if (stop_reported_)
+            return Result::NONE;
+        stop_reported_ = true;
+        return Result::STOPPED;
+    }
+
+    // Deliver events of the notes starting before the end of the lookahead
+    const std::uint32_t song_time = time + lookahead_ - start_time_;
+    Result result = Result::PLAYING;
+    while (const NoteEvent * const event = events_.peek())
+    {
+        if (static_cast<std::int32_t>(song_time - event->time) < 0)
+            break;
+
+        const Result type = event->type;
+        if (Result::CHANGE == type)
         {
-        case -1: current_song_id_ = SONG_COUNT - 1; break;
-        case SONG_COUNT: current_song_id_ = 0; break;
+            current_note_ = event->note;
+            current_note_time_ = start_time_ + event->time;
+            result = Result::CHANGE;
         }
+        else if (Result::PLAYING == result)
+            result = type;
+
+        NoteEvent consumed;
+        events_.pop(&consumed);
 
-        if (0 == current_song_id_)
+        if (Result::STOPPED == type)
         {
-            position_ = reinterpret_cast<const std::uint8_t *>(0xFFFF);  // Non-zero value
+            // The song ended without looping back, or its data can not be read
+            current_song_id_ = 0;
+            stop_reported_ = true;
             return Result::STOPPED;
         }
-        else
-        {
-            position_ = getSongById(current_song_id_);
-            reset();
-        }
     }
+    return result;
+}
 
-    if (0 == current_song_id_)
-        return Result::NONE;
-
-    // Check BPM counter
-    switch (bpm_counter_)
+std::size_t Music::fill(Segment * segments, std::size_t count)
+{
+    std::size_t filled = 0;
+    while (filled != count)
     {
-    case DIVIDE_FACTOR - 1:
-        bpm_counter_ = 0;
-        break;
-
-    case DIVIDE_FACTOR - 2:
-        ++bpm_counter_;
-        // Stop the note just before end of last section
-        return 1 == remaining_duration_ ? Result::PRE_CHANGE : Result::PLAYING;
-
-    default:
-        ++bpm_counter_;
-        return Result::PLAYING;
+        if (0 == remaining_periods_ && !nextPhase())
+            break;
+
+        const std::uint32_t periods = remaining_periods_ < driver::Buzzer::MAX_SEGMENT_PERIODS ?
+                remaining_periods_ : driver::Buzzer::MAX_SEGMENT_PERIODS;
+        segments[filled] = segment_;
+        segments[filled].repetition = static_cast<std::uint16_t>(periods - 1);
+        remaining_periods_ -= periods;
+        ++filled;
     }
+    return filled;
+}
+
+bool Music::nextPhase()
+{
+    if (!is_open_)
+        return false;
 
-    if (remaining_duration_ > 1)
+    if (articulation_pending_)
     {
-        --remaining_duration_;
-        // Wait for the current note to end
-        return Result::PLAYING;
+        // Stop the note just before its end
+        articulation_pending_ = false;
+        events_.push({song_time_, Result::PRE_CHANGE, note_});
+        startSilence(ARTICULATION_DURATION);
+        return true;
     }
 
     while (true)
     {
         std::uint8_t duration = 0;
-        Result result = Result::PLAYING;
+        bool is_tone = false;
 
-        const MusicElement el(*position_);
+        std::uint8_t code;
+        const auto read_result = store_.read(position_, &code);
+        if (SongStore::ReadResult::PENDING == read_result)
+        {
+            // Wait for the song data in silence, the following notes are delayed
+            startSilence(1);
+            return true;
+        }
+        if (SongStore::ReadResult::END == read_result)
+        {
+            // Let the buzzer stop and report the end in the main loop
+            is_open_ = false;
+            events_.push({song_time_, Result::STOPPED, note_});
+            return false;
+        }
+        const MusicElement el(code);
 
         const MusicElement::ControlType control = el.controlType();
         switch (control)
         {
         case MusicElement::ControlType::FLOW:
-        {
-            const std::uint8_t * const song_start = getSongById(current_song_id_);
             switch (el.param())
             {
             case MusicElement::CONTROL_FLOW_TERMINATE:
                 duration = 64;
-                position_ = song_start - 1;
+                position_ = static_cast<SongPos>(-1);  // Wraps to the start with `++position_;` later
                 loop_id_ = INVALID_LOOP_ID;
+                store_.setLoopStart(SongStore::INVALID_POS);
                 break;
 
             case MusicElement::CONTROL_FLOW_LOOP_END:
@@ -130,12 +179,14 @@ auto Music::play() -> Result
                     if (0 == current_loop.remaining)
                     {
                         loop_id_ -= 1;
+                        store_.setLoopStart(INVALID_LOOP_ID == loop_id_ ?
+                                SongStore::INVALID_POS : static_cast<SongPos>(loops_[loop_id_].start_offset + 1));
                     }
                     else
                     {
                         current_loop.remaining -= 1;
                         // Recall the position to the loop start element, it will be skipped by `++position_;` later
-                        position_ = song_start + current_loop.start_offset;
+                        position_ = current_loop.start_offset;
                     }
                 }
                 break;
@@ -146,15 +197,15 @@ auto Music::play() -> Result
                     loop_id_ += 1;
                     auto & current_loop = loops_[loop_id_];
                     current_loop.remaining = el.param();
-                    current_loop.start_offset = position_ - song_start;
+                    current_loop.start_offset = position_;
+                    store_.setLoopStart(position_ + 1);
                 }
                 break;
             }
-        }
             break;
 
         case MusicElement::ControlType::SET_OCTAVE:
-            current_note_ = MusicNote(el.param(), MusicNote::TONE_C);
+            note_ = MusicNote(el.param(), MusicNote::TONE_C);
             break;
 
         case MusicElement::ControlType::SILENCE:
@@ -162,17 +213,47 @@ auto Music::play() -> Result
             break;
 
         default:
-            current_note_ += el.noteDiff();
+            note_ += el.noteDiff();
             duration = getNoteDuration(MusicElement::toNoteLength(control));
-            result = Result::CHANGE;
+            is_tone = true;
             break;
         }
 
         ++position_;
         if (0 != duration)
         {
-            remaining_duration_ = duration;
-            return result;
+            if (is_tone)
+            {
+                events_.push({song_time_, Result::CHANGE, note_});
+                startTone((duration * UNIT_DURATION) - ARTICULATION_DURATION);
+                articulation_pending_ = true;
+            }
+            else
+                startSilence(duration * UNIT_DURATION);
+            return true;
         }
     }
 }
+
+void Music::startTone(std::uint32_t duration)
+{
+    segment_ = driver::Buzzer::toneSegment(note_, 1);
+
+    // Round to even number of periods, so the output ends in the inactive
+    // state, and compensate the rounding error of the previous notes
+    const std::int32_t period = static_cast<std::int32_t>(segment_.periodTicks());
+    const std::int32_t ticks = static_cast<std::int32_t>(duration * driver::Buzzer::TICKS_PER_MS);
+    const std::int32_t pairs = (ticks - drift_ + period) / (2 * period);
+    const std::int32_t periods = pairs > 0 ? pairs * 2 : 2;
+
+    drift_ += (periods * period) - ticks;
+    remaining_periods_ = static_cast<std::uint32_t>(periods);
+    song_time_ += duration;
+}
+
+void Music::startSilence(std::uint32_t duration)
+{
+    segment_ = driver::Buzzer::silenceSegment(1);
+    remaining_periods_ = duration;
+    song_time_ += duration;
+}
@@ -5,15 +5,27 @@
 #include <cstdint>
 
 #include "music_note.hpp"
+#include "app/song_store.hpp"
+#include "driver/buzzer.hpp"
+#include "driver/i2c_bus/cat24cx.hpp"
+#include "tools/mailbox.hpp"
 
 
 /**
  * @brief Music player object
+ *
+ * Songs are expanded into buzzer segments in the buzzer DMA interrupt, see
+ * @ref fill(). Along with the segments, the expansion produces timestamped
+ * note events, which @ref play() delivers in the main loop. The events can be
+ * delivered ahead of the notes by a lookahead, so the reaction to them has
+ * time to reach the LEDs before the notes start.
  */
-class Music
+class Music final:
+        public driver::Buzzer::Melody
 {
 public:
-    using SongPos = std::uint16_t;
+    using SongPos = SongStore::SongPos;
+    using Segment = driver::Buzzer::Segment;
 
     enum class Result
     {
@@ -26,18 +38,62 @@ public:
 
     static const std::size_t MAX_NESTED_LOOPS = 3;
 
+    /** @brief Duration of the shortest note length unit in milliseconds */
+    static const inline std::uint32_t UNIT_DURATION = 64;
+    /** @brief Silence at the end of each note in milliseconds */
+    static const inline std::uint32_t ARTICULATION_DURATION = 8;
+
     /**
-     * @brief (Continue to) play a song
+     * @brief Start playing the song selected by @ref change()
+     *
+     * The buzzer needs to be stopped, before calling this function.
+     *
+     * @param time Current time in milliseconds
+     * @param delay Silence before the song in milliseconds, use it to make
+     *        room for the lookahead of the first note
+     *
+     * @return A song was selected, pass the object to the buzzer
+     */
+    bool start(std::uint32_t time, std::uint32_t delay = 0);
+
+    /**
+     * @brief Check whether the song was changed and needs to be started
+     */
+    bool isChangePending() const { return change_pending_; }
+
+    /**
+     * @brief Set how much ahead of the notes are their events delivered
+     *
+     * @param lookahead Lookahead in milliseconds
+     */
+    void setLookahead(std::uint32_t lookahead) { lookahead_ = lookahead; }
+
+    /**
+     * @brief Follow the song being played
+     *
+     * Delivers the events of notes starting before the current time plus the
+     * lookahead. @ref Result::PRE_CHANGE is reported ahead of the end of a
+     * note, @ref Result::CHANGE ahead of the start of a new one.
+     *
+     * @param time Current time in milliseconds
      *
      * @return Result of the music playing
      */
-    Result play();
+    Result play(std::uint32_t time);
 
     const MusicNote & currentNote() const
     {
         return current_note_;
     }
 
+    /**
+     * @brief Get time the current note starts playing in milliseconds
+     */
+    std::uint32_t currentNoteTime() const
+    {
+        return current_note_time_;
+    }
+
     bool isPlaying() const
     {
         return 0 != current_song_id_;
@@ -46,9 +102,22 @@ public:
     void change(int diff)
     {
         current_song_id_ += diff;
-        position_ = nullptr;
+        change_pending_ = true;
     }
 
+    std::size_t fill(Segment * segments, std::size_t count) final;
+
+    /**
+     * @brief Prefetch the song being played
+     *
+     * Call periodically from background tasks.
+     *
+     * @param eeprom EEPROM storing the songs
+     */
+    void run(driver::i2c::Cat24cx * eeprom) { store_.run(eeprom); }
+
+    const SongStore & store() const { return store_; }
+
 private:
     struct LoopState
     {
@@ -56,26 +125,50 @@ private:
         std::uint8_t remaining;
     };
 
-    static const std::uint8_t INVALID_LOOP_ID = 0xFF;
-
-    std::uint8_t bpm_counter_ = 0;
+    /**
+     * @brief Note event in the time of the song
+     */
+    struct NoteEvent
+    {
+        /** @brief Time since the start of the song in milliseconds */
+        std::uint32_t time;
+        Result type;
+        MusicNote note;
+    };
 
-    std::int8_t current_song_id_ = 0;
-    const std::uint8_t * position_ = nullptr;
+    static const std::uint8_t INVALID_LOOP_ID = 0xFF;
 
-    std::uint8_t loop_id_ = INVALID_LOOP_ID;
-    LoopState loops_[MAX_NESTED_LOOPS];
+    std::int16_t current_song_id_ = 0;
+    bool change_pending_ = false;
+    bool stop_reported_ = false;
+    std::uint32_t start_time_ = 0;
+    std::uint32_t lookahead_ = 0;
 
     MusicNote current_note_;
-    SongPos remaining_duration_ = 0;
+    std::uint32_t current_note_time_ = 0;
 
-    static const std::uint8_t DIVIDE_FACTOR = 8;
+    Mailbox<NoteEvent, 32> events_;
+    SongStore store_;
 
-    void reset()
-    {
-        remaining_duration_ = 0;
-        loop_id_ = INVALID_LOOP_ID;
-    }
+    // State of the song expansion, accessed only by the buzzer interrupt once
+    // the song is started
+    bool is_open_ = false;
+    SongPos position_ = 0;
+    std::uint8_t loop_id_ = INVALID_LOOP_ID;
+    LoopState loops_[MAX_NESTED_LOOPS];
+    MusicNote note_;
+    /** @brief Time of the end of the expanded part of the song in milliseconds */
+    std::uint32_t song_time_ = 0;
+    /** @brief Difference of the played and the song time in timer ticks, compensated by next notes */
+    std::int32_t drift_ = 0;
+    /** @brief Segment repeated until @ref remaining_periods_ are expanded */
+    Segment segment_ = {};
+    std::uint32_t remaining_periods_ = 0;
+    bool articulation_pending_ = false;
+
+    bool nextPhase();
+    void startTone(std::uint32_t duration);
+    void startSilence(std::uint32_t duration);
 };
 
-#endif  // APP_MUSIC_HPP_
\ No newline at end of file
+#endif  // APP_MUSIC_HPP_
@@ -0,0 +1,28 @@
+/**
+ * @file
+ */
+
+#ifndef APP_NVM_LAYOUT_HPP_
+#define APP_NVM_LAYOUT_HPP_
+
+#include <cstdint>
+
+
+/**
+ * @brief Placement of the application data in the I2C EEPROM
+ *
+ * Regions start at write page boundaries. The layout assumes 32 KiB part
+ * (CAT24C256).
+ */
+struct NvmLayout
+{
+    /** @brief Remote control codes learned at runtime, see @ref IrKeymap */
+    static const inline std::uint16_t IR_KEYMAP_ADDRESS = 0x0000;
+    static const inline std::uint16_t IR_KEYMAP_SIZE = 0x0080;
+    /** @brief Directory of songs followed by their data, see @ref SongStore */
+    static const inline std::uint16_t SONG_STORE_ADDRESS = 0x0080;
+    static const inline std::uint16_t SONG_STORE_SIZE = 0x8000 - SONG_STORE_ADDRESS;
+};
+
+
+#endif  // APP_NVM_LAYOUT_HPP_
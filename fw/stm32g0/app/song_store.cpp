@@ -0,0 +1,210 @@
+#include "app/song_store.hpp"
+
+#include "song.hpp"
+
+
+namespace songs
+{
+
+#define PROGMEM
+
+#include "songs/silent_night.inc"
+#include "songs/jingle_bells.inc"
+
+}  // namespace songs
+
+
+namespace
+{
+
+const std::uint8_t * const BUILTIN_SONGS[] = {
+    songs::SILENT_NIGHT,
+    songs::JINGLE_BELLS,
+};
+
+const std::size_t BUILTIN_SONG_COUNT = sizeof(BUILTIN_SONGS) / sizeof(BUILTIN_SONGS[0]);
+
+}  // namespace
+
+
+std::size_t SongStore::songCount() const
+{
+    return 0 != eeprom_song_count_ ? eeprom_song_count_ : BUILTIN_SONG_COUNT;
+}
+
+bool SongStore::open(std::size_t index)
+{
+    builtin_song_ = nullptr;
+    for (auto & block : blocks_)
+        block.index.store(INVALID_BLOCK, std::memory_order_relaxed);
+    cursor_block_.store(0, std::memory_order_relaxed);
+    loop_start_.store(INVALID_POS, std::memory_order_relaxed);
+    loop_window_pos_.store(INVALID_POS, std::memory_order_relaxed);
+    song_length_.store(INVALID_POS, std::memory_order_relaxed);
+    // Data being loaded belong to the previous song
+    loading_block_ = INVALID_BLOCK;
+    loading_window_ = INVALID_POS;
+
+    if (0 != eeprom_song_count_)
+    {
+        if (index >= eeprom_song_count_)
+            return false;
+        song_index_ = index;
+        state_ = State::LOAD_ENTRY;
+        return true;
+    }
+
+    if (index >= BUILTIN_SONG_COUNT)
+        return false;
+    builtin_song_ = BUILTIN_SONGS[index];
+    return true;
+}
+
+auto SongStore::read(SongPos pos, std::uint8_t * value) -> ReadResult
+{
+    if (nullptr != builtin_song_)
+    {
+        *value = builtin_song_[pos];
+        return ReadResult::READ;
+    }
+
+    // Songs missing the terminator end with their data
+    if (pos >= song_length_.load(std::memory_order_relaxed))
+        return ReadResult::END;
+
+    const std::uint16_t index = pos / BLOCK_SIZE;
+    cursor_block_.store(index, std::memory_order_relaxed);
+
+    const Block & block = blocks_[index % BLOCK_COUNT];
+    if (index == block.index.load(std::memory_order_acquire))
+    {
+        *value = block.data[pos % BLOCK_SIZE];
+        return ReadResult::READ;
+    }
+
+    const SongPos window = loop_window_pos_.load(std::memory_order_acquire);
+    if (INVALID_POS != window && static_cast<SongPos>(pos - window) < BLOCK_SIZE)
+    {
+        *value = loop_window_[pos - window];
+        return ReadResult::READ;
+    }
+
+    miss_count_.store(miss_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return ReadResult::PENDING;
+}
+
+void SongStore::run(driver::i2c::Cat24cx * eeprom)
+{
+    if (is_loading_block_ && EepromResult::PENDING != eeprom_result_)
+    {
+        is_loading_block_ = false;
+        if (EepromResult::DONE == eeprom_result_)
+        {
+            if (INVALID_POS != loading_window_)
+                loop_window_pos_.store(loading_window_, std::memory_order_release);
+            else if (INVALID_BLOCK != loading_block_)
+                blocks_[loading_block_ % BLOCK_COUNT].index.store(loading_block_, std::memory_order_release);
+        }
+    }
+
+    switch (state_)
+    {
+    case State::LOAD_HEADER:
+        if (eeprom->read(NvmLayout::SONG_STORE_ADDRESS, &header_, sizeof(header_), &eeprom_result_))
+            state_ = State::LOADING_HEADER;
+        break;
+
+    case State::LOADING_HEADER:
+        if (EepromResult::PENDING == eeprom_result_)
+            break;
+        if (EepromResult::DONE == eeprom_result_ && MAGIC == header_.magic && VERSION == header_.version)
+            eeprom_song_count_ = header_.count;
+        state_ = State::IDLE;
+        break;
+
+    case State::LOAD_ENTRY:
+        if (is_loading_block_)
+            break;
+        if (eeprom->read(NvmLayout::SONG_STORE_ADDRESS + sizeof(Header) + (song_index_ * sizeof(Entry)),
+                &entry_, sizeof(entry_), &eeprom_result_))
+            state_ = State::LOADING_ENTRY;
+        break;
+
+    case State::LOADING_ENTRY:
+        if (EepromResult::PENDING == eeprom_result_)
+            break;
+        if (EepromResult::DONE == eeprom_result_ && 0 != entry_.length && INVALID_POS != entry_.length &&
+                (static_cast<std::size_t>(entry_.offset) + entry_.length) <= NvmLayout::SONG_STORE_SIZE)
+        {
+            song_length_.store(entry_.length, std::memory_order_relaxed);
+            state_ = State::SONG_READY;
+        }
+        else
+        {
+            // Reads of the song end it, instead of waiting for the data forever
+            song_length_.store(0, std::memory_order_relaxed);
+            state_ = State::FAILED;
+        }
+        break;
+
+    case State::SONG_READY:
+        prefetch(eeprom);
+        break;
+
+    case State::IDLE:
+    case State::FAILED:
+        break;
+    }
+}
+
+void SongStore::prefetch(driver::i2c::Cat24cx * eeprom)
+{
+    if (is_loading_block_)
+        return;
+
+    // Block at the cursor is needed first, then the start of the loop, which
+    // may be jumped to at any time, and then the block following the cursor
+    const std::uint16_t cursor = cursor_block_.load(std::memory_order_relaxed);
+    if (loadBlock(eeprom, cursor) || loadLoopWindow(eeprom))
+        return;
+    loadBlock(eeprom, cursor + 1u);
+}
+
+bool SongStore::loadBlock(driver::i2c::Cat24cx * eeprom, std::size_t index)
+{
+    const std::size_t offset = index * BLOCK_SIZE;
+    if (offset >= entry_.length)
+        return false;
+
+    Block & block = blocks_[index % BLOCK_COUNT];
+    if (index == block.index.load(std::memory_order_relaxed))
+        return false;
+
+    block.index.store(INVALID_BLOCK, std::memory_order_release);
+    const std::size_t size = (entry_.length - offset) < BLOCK_SIZE ? (entry_.length - offset) : BLOCK_SIZE;
+    if (eeprom->read(NvmLayout::SONG_STORE_ADDRESS + entry_.offset + offset, block.data, size, &eeprom_result_))
+    {
+        is_loading_block_ = true;
+        loading_block_ = static_cast<std::uint16_t>(index);
+        loading_window_ = INVALID_POS;
+    }
+    return true;
+}
+
+bool SongStore::loadLoopWindow(driver::i2c::Cat24cx * eeprom)
+{
+    const SongPos start = loop_start_.load(std::memory_order_relaxed);
+    if (start >= entry_.length || start == loop_window_pos_.load(std::memory_order_relaxed))
+        return false;
+
+    loop_window_pos_.store(INVALID_POS, std::memory_order_release);
+    const std::size_t remaining = entry_.length - start;
+    const std::size_t size = remaining < BLOCK_SIZE ? remaining : BLOCK_SIZE;
+    if (eeprom->read(NvmLayout::SONG_STORE_ADDRESS + entry_.offset + start, loop_window_, size, &eeprom_result_))
+    {
+        is_loading_block_ = true;
+        loading_block_ = INVALID_BLOCK;
+        loading_window_ = start;
+    }
+    return true;
+}
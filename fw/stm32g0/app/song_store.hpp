@@ -0,0 +1,171 @@
+/**
+ * @file
+ */
+
+#ifndef APP_SONG_STORE_HPP_
+#define APP_SONG_STORE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+#include "app/nvm_layout.hpp"
+#include "driver/i2c_bus/cat24cx.hpp"
+
+
+/**
+ * @brief Songs stored in the EEPROM
+ *
+ * The store begins with a directory of songs in the `MusicElement` encoding,
+ * the image is generated by `compose.py --image`. Songs are read through a
+ * small cache of blocks, which @ref run() keeps filled with the block at the
+ * play cursor and the one following it. The data following the start of the
+ * innermost active loop are kept in a separate window, so jumps back to the
+ * loop start do not miss, however long the loop is.
+ *
+ * If the EEPROM does not contain a valid store, the songs built into the
+ * firmware are used instead.
+ */
+class SongStore
+{
+public:
+    using SongPos = std::uint16_t;
+
+    enum class ReadResult: std::uint8_t
+    {
+        /** @brief The byte was read */
+        READ,
+        /** @brief The byte is not available yet, try again later */
+        PENDING,
+        /** @brief The position is past the end of the song, or the song can not be read */
+        END,
+    };
+
+    static const inline SongPos INVALID_POS = 0xFFFF;
+
+    static const inline std::size_t BLOCK_SIZE = 32;
+    static const inline std::size_t BLOCK_COUNT = 4;
+    static const inline std::uint16_t MAGIC = 0x4753;  // "SG"
+    static const inline std::uint8_t VERSION = 1;
+
+    static_assert(0 == (BLOCK_COUNT & (BLOCK_COUNT - 1)), "Block count needs to be a power of two");
+
+    /**
+     * @brief Get number of songs
+     */
+    std::size_t songCount() const;
+
+    /**
+     * @brief Select song to read
+     *
+     * Must not be called while the song is read by @ref read().
+     *
+     * @param index Index of the song
+     *
+     * @return The song exists
+     */
+    bool open(std::size_t index);
+
+    /**
+     * @brief Read a byte of the open song
+     *
+     * Can be called from an interrupt.
+     *
+     * @param pos Position within the song
+     * @param[out] value Read byte
+     *
+     * @return Result of the read
+     */
+    ReadResult read(SongPos pos, std::uint8_t * value);
+
+    /**
+     * @brief Keep the data of the innermost active loop loaded
+     *
+     * Can be called from an interrupt.
+     *
+     * @param pos Position the loop continues from after jumping back to its
+     *        start, @ref INVALID_POS if no loop is active
+     */
+    void setLoopStart(SongPos pos) { loop_start_.store(pos, std::memory_order_relaxed); }
+
+    /**
+     * @brief Get number of reads, which had to wait for the EEPROM
+     */
+    std::uint32_t missCount() const { return miss_count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Load the directory and prefetch blocks of the open song
+     *
+     * Call periodically from background tasks.
+     *
+     * @param eeprom EEPROM storing the songs
+     */
+    void run(driver::i2c::Cat24cx * eeprom);
+
+private:
+    using EepromResult = driver::i2c::Cat24cx::Result;
+
+    static const inline std::uint16_t INVALID_BLOCK = 0xFFFF;
+
+    enum class State: std::uint8_t
+    {
+        LOAD_HEADER, LOADING_HEADER,
+        IDLE,
+        LOAD_ENTRY, LOADING_ENTRY,
+        SONG_READY,
+        FAILED,
+    };
+
+    struct Header
+    {
+        std::uint16_t magic;
+        std::uint8_t version;
+        std::uint8_t count;
+    };
+
+    struct Entry
+    {
+        std::uint16_t offset;
+        std::uint16_t length;
+    };
+
+    struct Block
+    {
+        /** @brief Index of the block of the song in the data, or INVALID_BLOCK */
+        std::atomic<std::uint16_t> index = INVALID_BLOCK;
+        std::uint8_t data[BLOCK_SIZE];
+    };
+
+    State state_ = State::LOAD_HEADER;
+    EepromResult eeprom_result_ = EepromResult::NONE;
+    /** @brief Number of songs in the EEPROM, zero when the built-in songs are used */
+    std::uint8_t eeprom_song_count_ = 0;
+    bool is_loading_block_ = false;
+
+    Header header_ = {};
+    Entry entry_ = {};
+    /** @brief Length of the open song, @ref INVALID_POS until known, zero if it can not be read */
+    std::atomic<SongPos> song_length_ = INVALID_POS;
+    std::size_t song_index_ = 0;
+    /** @brief Data of the open built-in song */
+    const std::uint8_t * builtin_song_ = nullptr;
+
+    std::atomic<std::uint16_t> cursor_block_ = 0;
+    std::uint16_t loading_block_ = INVALID_BLOCK;
+    /** @brief Position of the loop window being loaded, @ref INVALID_POS when loading a block */
+    SongPos loading_window_ = INVALID_POS;
+    Block blocks_[BLOCK_COUNT];
+
+    std::atomic<SongPos> loop_start_ = INVALID_POS;
+    /** @brief Position of the first byte in the loop window, or INVALID_POS */
+    std::atomic<SongPos> loop_window_pos_ = INVALID_POS;
+    std::uint8_t loop_window_[BLOCK_SIZE];
+    std::atomic<std::uint32_t> miss_count_ = 0;
+
+    void prefetch(driver::i2c::Cat24cx * eeprom);
+    bool loadBlock(driver::i2c::Cat24cx * eeprom, std::size_t index);
+    bool loadLoopWindow(driver::i2c::Cat24cx * eeprom);
+};
+
+
+#endif  // APP_SONG_STORE_HPP_
@@ -0,0 +1,199 @@
+/**
+ * @file
+ */
+
+#ifndef APP_TOPOLOGY_HPP_
+#define APP_TOPOLOGY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "led_strip.hpp"
+
+
+/**
+ * @brief Order in which the LED chain passes the matrix
+ */
+enum class MatrixLayout
+{
+    ROWS,                /**< Every row from left to right */
+    SERPENTINE,          /**< Even rows from left to right, odd rows back */
+    COLUMNS,             /**< Every column from top to bottom */
+    COLUMNS_SERPENTINE,  /**< Even columns from top to bottom, odd columns back */
+};
+
+
+/**
+ * @brief Mapping of the matrix coordinates to the LED indices
+ *
+ * Index table is generated at compile time and lives in the flash, 2D effects
+ * look the LEDs up instead of computing the layout for every pixel. The strip
+ * rendered through the topology needs at least @ref LED_COUNT LEDs.
+ *
+ * @tparam W Width of the matrix
+ * @tparam H Height of the matrix
+ * @tparam L Layout of the LED chain
+ */
+template <std::size_t W, std::size_t H, MatrixLayout L = MatrixLayout::SERPENTINE>
+class MatrixTopology
+{
+public:
+    static_assert(0 != W && 0 != H, "Empty matrix");
+    static_assert(W * H <= std::numeric_limits<LedSize>::max(), "LED indices of the matrix do not fit LedSize");
+
+    static const inline std::size_t WIDTH = W;
+    static const inline std::size_t HEIGHT = H;
+    static const inline std::size_t LED_COUNT = W * H;
+
+    /**
+     * @brief Get the LED index at given coordinates
+     *
+     * @param x Column, 0 is the left one
+     * @param y Row, 0 is the top one
+     *
+     * @return LED index
+     */
+    static LedSize index(std::size_t x, std::size_t y) { return TABLE.indices[y][x]; }
+
+    /**
+     * @brief Get the LED indices of a row, from the left to the right
+     *
+     * @param y Row, 0 is the top one
+     *
+     * @return Array of @ref WIDTH LED indices
+     */
+    static const LedSize * row(std::size_t y) { return TABLE.indices[y]; }
+
+    static LedState & at(AbstractLedStrip * strip, std::size_t x, std::size_t y)
+    {
+        return (*strip)[index(x, y)];
+    }
+
+    /**
+     * @brief Paint all the LEDs of the matrix
+     *
+     * @param[out] strip Strip to paint
+     * @param paint Function returning the color of the LED `(x, y)`
+     */
+    template <typename F>
+    static void paint(AbstractLedStrip * strip, F && paint)
+    {
+        for (std::size_t y = 0; y != H; ++y)
+        {
+            const LedSize * const indices = row(y);
+            for (std::size_t x = 0; x != W; ++x)
+                (*strip)[indices[x]] = paint(x, y);
+        }
+    }
+
+private:
+    struct Table
+    {
+        LedSize indices[H][W];
+    };
+
+    static constexpr LedSize makeIndex(std::size_t x, std::size_t y)
+    {
+        switch (L)
+        {
+        case MatrixLayout::ROWS: return (y * W) + x;
+        case MatrixLayout::SERPENTINE: return (y * W) + ((y & 0x01) ? (W - 1 - x) : x);
+        case MatrixLayout::COLUMNS: return (x * H) + y;
+        case MatrixLayout::COLUMNS_SERPENTINE: return (x * H) + ((x & 0x01) ? (H - 1 - y) : y);
+        }
+        return 0;
+    }
+
+    static constexpr Table makeTable()
+    {
+        Table table{};
+        for (std::size_t y = 0; y != H; ++y)
+        {
+            for (std::size_t x = 0; x != W; ++x)
+                table.indices[y][x] = makeIndex(x, y);
+        }
+        return table;
+    }
+
+    static constexpr Table TABLE = makeTable();
+};
+
+
+/**
+ * @brief Mapping of the polar coordinates of concentric rings to the LED
+ *        indices
+ *
+ * The chain passes the rings one after another, each ring starts at angle 0
+ * and runs in the direction of the increasing angle. Angle is quantized into
+ * `ANGLE_STEPS` steps, each step maps to the nearest LED of the ring.
+ *
+ * @tparam ANGLE_STEPS Number of the angle steps in a full circle
+ * @tparam RING_LENGTHS Number of the LEDs of each ring, in the chain order
+ */
+template <std::size_t ANGLE_STEPS, LedSize... RING_LENGTHS>
+class RingTopology
+{
+public:
+    static_assert(0 != sizeof...(RING_LENGTHS), "No rings");
+    static_assert(0 != ANGLE_STEPS, "No angle steps");
+    static_assert(((0 != RING_LENGTHS) && ...), "Empty ring");
+
+    static const inline std::size_t RING_COUNT = sizeof...(RING_LENGTHS);
+    static const inline std::size_t LED_COUNT = (static_cast<std::size_t>(RING_LENGTHS) + ...);
+
+    static_assert(LED_COUNT <= std::numeric_limits<LedSize>::max(), "LED indices of the rings do not fit LedSize");
+
+    /**
+     * @brief Get the LED index at given polar coordinates
+     *
+     * @param ring Ring number
+     * @param angle Angle in steps, less than `ANGLE_STEPS`
+     *
+     * @return LED index
+     */
+    static LedSize index(std::size_t ring, std::size_t angle) { return TABLE.indices[ring][angle]; }
+
+    /**
+     * @brief Get the LED indices of all the angle steps of a ring
+     *
+     * @param ring Ring number
+     *
+     * @return Array of `ANGLE_STEPS` LED indices
+     */
+    static const LedSize * ring(std::size_t ring) { return TABLE.indices[ring]; }
+
+    static LedState & at(AbstractLedStrip * strip, std::size_t ring, std::size_t angle)
+    {
+        return (*strip)[index(ring, angle)];
+    }
+
+private:
+    struct Table
+    {
+        LedSize indices[RING_COUNT][ANGLE_STEPS];
+    };
+
+    static constexpr Table makeTable()
+    {
+        constexpr LedSize lengths[] = {RING_LENGTHS...};
+        Table table{};
+        std::size_t offset = 0;
+        for (std::size_t ring = 0; ring != RING_COUNT; ++ring)
+        {
+            const std::size_t length = lengths[ring];
+            for (std::size_t angle = 0; angle != ANGLE_STEPS; ++angle)
+            {
+                const std::size_t led = (((angle * length) + (ANGLE_STEPS / 2)) / ANGLE_STEPS) % length;
+                table.indices[ring][angle] = offset + led;
+            }
+            offset += length;
+        }
+        return table;
+    }
+
+    static constexpr Table TABLE = makeTable();
+};
+
+
+#endif  // APP_TOPOLOGY_HPP_
@@ -20,6 +20,21 @@ void Base::init()
     configure_pins();
 }
 
+void Base::disableInterrupts()
+{
+    __disable_irq();
+}
+
+void Base::enableInterrupts()
+{
+    __enable_irq();
+}
+
+void Base::waitForInterrupt()
+{
+    __WFI();
+}
+
 void Base::clock_init()
 {
   ::LL_FLASH_SetLatency(LL_FLASH_LATENCY_2);
@@ -14,6 +14,18 @@ class Base
 public:
     static void init();
 
+    static void disableInterrupts();
+    static void enableInterrupts();
+
+    /**
+     * @brief Sleep until an interrupt is pending
+     *
+     * Wakes up also on interrupts pending while the interrupts are disabled,
+     * so the decision to sleep can be made with interrupts disabled without
+     * missing a wake-up.
+     */
+    static void waitForInterrupt();
+
 private:
     static void clock_init();
     static void enable_peripheral_clocks();
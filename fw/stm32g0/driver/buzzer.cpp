@@ -1,7 +1,11 @@
 #include "driver/buzzer.hpp"
 
+#include "driver/tools/trace.hpp"
+
 #include "stm32g0xx_ll_tim.h"
 #include "stm32g0xx_ll_cortex.h"
+#include "stm32g0xx_ll_dma.h"
+#include "stm32g0xx_ll_dmamux.h"
 
 
 namespace driver
@@ -24,6 +28,25 @@ const std::uint8_t NOTES[16] = {
         127 - 1   // 11: B
 };
 
+// Silence counts milliseconds: 64 MHz / 64 / 1000
+const std::uint16_t SILENCE_PRESCALER = 64 - 1;
+const std::uint16_t SILENCE_AUTO_RELOAD = 1000 - 1;
+// Compare value above the auto-reload value never toggles the output
+const std::uint16_t SILENCE_COMPARE = 0xFFFF;
+
+// Segment written into the registers when starting playback, its only purpose
+// is to generate the first update event shortly
+const Buzzer::Segment START_SEGMENT = {0, 64 - 1, 0, SILENCE_COMPARE};
+
+const std::size_t HALF_BUFFER_LENGTH = Buzzer::SEGMENT_BUFFER_LENGTH / 2;
+const std::size_t SEGMENT_TRANSFERS = sizeof(Buzzer::Segment) / sizeof(std::uint16_t);
+
+enum DmaFlags
+{
+    DMA_COMPLETE,
+    DMA_HALF_COMPLETE,
+};
+
 
 ::TIM_TypeDef * toTimer(TimerId tim_id)
 {
@@ -47,6 +70,16 @@ std::uint32_t toChannel(std::uint32_t channel_id)
     return 0;
 }
 
+std::uint32_t toDmaRequest(TimerId tim_id)
+{
+    switch (tim_id)
+    {
+    case TimerId::TIM_16: return LL_DMAMUX_REQ_TIM16_UP;
+    default: break;
+    }
+    return 0;
+}
+
 bool initializeTimer(::TIM_TypeDef * tim)
 {
     ::LL_TIM_InitTypeDef init;
@@ -61,6 +94,7 @@ bool initializeTimer(::TIM_TypeDef * tim)
         return false;
 
     ::LL_TIM_EnableARRPreload(tim);
+    ::LL_TIM_ConfigDMABurst(tim, LL_TIM_DMABURST_BASEADDR_PSC, LL_TIM_DMABURST_LENGTH_4TRANSFERS);
     ::LL_TIM_SetClockSource(tim, LL_TIM_CLOCKSOURCE_INTERNAL);
     ::LL_TIM_SetTriggerOutput(tim, LL_TIM_TRGO_RESET);
     ::LL_TIM_SetTriggerOutput2(tim, LL_TIM_TRGO2_RESET);
@@ -140,6 +174,112 @@ inline void resetOutput(::TIM_TypeDef * tim, std::uint32_t channel)
     ::LL_TIM_OC_SetMode(tim, channel, LL_TIM_OCMODE_TOGGLE);
 }
 
+inline void writeSegment(::TIM_TypeDef * tim, std::uint32_t channel, const Buzzer::Segment & segment)
+{
+    ::LL_TIM_SetPrescaler(tim, segment.prescaler);
+    ::LL_TIM_SetAutoReload(tim, segment.auto_reload);
+    ::LL_TIM_SetRepetitionCounter(tim, segment.repetition);
+    setCompare(tim, channel, segment.compare);
+}
+
+bool initializeDma(std::uint32_t dma_channel, std::uint32_t request, ::TIM_TypeDef * tim)
+{
+    {
+        const std::uint32_t dmamux_channel = toDmamuxChannel(dma_channel);
+        ::LL_DMAMUX_SetRequestID(DMAMUX1, dmamux_channel, request);
+        ::LL_DMAMUX_DisableEventGeneration(DMAMUX1, dmamux_channel);
+        ::LL_DMAMUX_DisableSync(DMAMUX1, dmamux_channel);
+        ::LL_DMAMUX_DisableRequestGen(DMAMUX1, dmamux_channel);
+    }
+
+    // Each update event transfers whole segment through the DMA burst register
+    ::LL_DMA_DisableChannel(DMA1, dma_channel);
+    ::LL_DMA_ConfigTransfer(DMA1, dma_channel, LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_CIRCULAR |
+            LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
+            LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_HALFWORD |
+            LL_DMA_PRIORITY_LOW);
+    ::LL_DMA_SetPeriphAddress(DMA1, dma_channel, reinterpret_cast<std::uintptr_t>(&(tim->DMAR)));
+    ::LL_DMA_SetMemoryAddress(DMA1, dma_channel, 0);
+    ::LL_DMA_SetDataLength(DMA1, dma_channel, 0);
+
+    ::LL_DMA_EnableIT_TC(DMA1, dma_channel);
+    ::LL_DMA_EnableIT_HT(DMA1, dma_channel);
+    return true;
+}
+
+void enableDmaIrq(std::uint32_t dma_channel)
+{
+    switch (dma_channel)
+    {
+    case LL_DMA_CHANNEL_1:
+        ::NVIC_EnableIRQ(::DMA1_Channel1_IRQn);
+        break;
+    case LL_DMA_CHANNEL_2:
+    case LL_DMA_CHANNEL_3:
+        ::NVIC_EnableIRQ(::DMA1_Channel2_3_IRQn);
+        break;
+    case LL_DMA_CHANNEL_4:
+    case LL_DMA_CHANNEL_5:
+    case LL_DMA_CHANNEL_6:
+    case LL_DMA_CHANNEL_7:
+        ::NVIC_EnableIRQ(::DMA1_Ch4_7_DMAMUX1_OVR_IRQn);
+        break;
+    }
+}
+
+inline void startDma(std::uint32_t dma_channel, const void * data, std::size_t length)
+{
+    ::LL_DMA_DisableChannel(DMA1, dma_channel);
+
+    ::LL_DMA_SetMemoryAddress(DMA1, dma_channel, reinterpret_cast<std::uintptr_t>(data));
+    ::LL_DMA_SetDataLength(DMA1, dma_channel, length);
+
+    ::LL_DMA_EnableChannel(DMA1, dma_channel);
+}
+
+std::uint32_t readDmaFlags(std::uint32_t dma_channel)
+{
+    #define READ_DMA_FLAGS_CHANNEL(dma, channel)  \
+        if (::LL_DMA_IsActiveFlag_TC ## channel(dma))  \
+        {  \
+            flags |= (1 << DmaFlags::DMA_COMPLETE);  \
+            ::LL_DMA_ClearFlag_TC ## channel(dma);  \
+        }  \
+        if (::LL_DMA_IsActiveFlag_HT ## channel(dma))  \
+        {  \
+            flags |= (1 << DmaFlags::DMA_HALF_COMPLETE);  \
+            ::LL_DMA_ClearFlag_HT ## channel(dma);  \
+        }
+
+    std::uint32_t flags = 0;
+    switch (dma_channel)
+    {
+    case LL_DMA_CHANNEL_1: READ_DMA_FLAGS_CHANNEL(DMA1, 1); break;
+    case LL_DMA_CHANNEL_2: READ_DMA_FLAGS_CHANNEL(DMA1, 2); break;
+    case LL_DMA_CHANNEL_3: READ_DMA_FLAGS_CHANNEL(DMA1, 3); break;
+    case LL_DMA_CHANNEL_4: READ_DMA_FLAGS_CHANNEL(DMA1, 4); break;
+    case LL_DMA_CHANNEL_5: READ_DMA_FLAGS_CHANNEL(DMA1, 5); break;
+    case LL_DMA_CHANNEL_6: READ_DMA_FLAGS_CHANNEL(DMA1, 6); break;
+    case LL_DMA_CHANNEL_7: READ_DMA_FLAGS_CHANNEL(DMA1, 7); break;
+    }
+
+    #undef READ_DMA_FLAGS_CHANNEL
+    return flags;
+}
+
+/**
+ * @brief Fill part of the segment buffer from the melody
+ *
+ * @return The melody did not end
+ */
+bool fillSegments(Buzzer::Melody * melody, Buzzer::Segment * segments, std::size_t count)
+{
+    const std::size_t filled = melody->fill(segments, count);
+    for (std::size_t n = filled; n != count; ++n)
+        segments[n] = Buzzer::silenceSegment(1);
+    return filled == count;
+}
+
 
 }  // namespace
 
@@ -148,6 +288,13 @@ struct Buzzer::Private
 {
     ::TIM_TypeDef * tim;
     std::uint32_t channel;
+    std::uint32_t dma_channel;
+
+    Melody * melody;
+    /** @brief Number of half-buffer refills after the end of the melody, before the playback stops */
+    std::uint32_t remaining_refills;
+
+    Segment segments[SEGMENT_BUFFER_LENGTH];
 };
 
 
@@ -160,55 +307,120 @@ Buzzer::~Buzzer()
 }
 
 
-bool Buzzer::initialize(TimerId tim_id, uint8_t channel_id)
+auto Buzzer::toneSegment(MusicNote note, std::uint16_t periods) -> Segment
+{
+    return {
+        static_cast<std::uint16_t>(2 << (12 - note.octave())),
+        NOTES[note.tone()],
+        static_cast<std::uint16_t>(periods - 1),
+        0
+    };
+}
+
+auto Buzzer::silenceSegment(std::uint16_t duration) -> Segment
+{
+    return {SILENCE_PRESCALER, SILENCE_AUTO_RELOAD, static_cast<std::uint16_t>(duration - 1), SILENCE_COMPARE};
+}
+
+
+bool Buzzer::initialize(TimerId tim_id, uint8_t channel_id, DmaChannelId dma_channel_id)
 {
     auto * const tim = toTimer(tim_id);
     const std::uint32_t channel = toChannel(channel_id);
     if (nullptr == tim || 0 == channel)
         return false;
 
+    const std::uint32_t dma_request = toDmaRequest(tim_id);
+    const std::uint32_t dma_channel = toDmaChannel(dma_channel_id);
+    if (0 == dma_request || INVALID_DMA_CHANNEL == dma_channel)
+        return false;
+
     if (!initializeTimer(tim))
         return false;
 
     if (!initializeChannel(tim, channel))
         return false;
 
+    if (!initializeDma(dma_channel, dma_request, tim))
+        return false;
+
     auto & priv = *p_;
     priv.tim = tim;
     priv.channel = channel;
+    priv.dma_channel = dma_channel;
+    priv.melody = nullptr;
+    priv.remaining_refills = 0;
 
     setCompare(tim, channel, 0);
 
+    enableDmaIrq(dma_channel);
     startTimer(tim);
 
     return true;
 }
 
-void Buzzer::playNote(MusicNote note)
+bool Buzzer::play(Melody * melody)
 {
+    stop();
+
     auto & priv = *p_;
+    if (!fillSegments(melody, priv.segments, SEGMENT_BUFFER_LENGTH))
+        return false;
+    priv.melody = melody;
+    priv.remaining_refills = 0;
+
+    // Update event caused by the start segment transfers the first segment of
+    // the melody, which then starts with the next update event
+    writeSegment(priv.tim, priv.channel, START_SEGMENT);
+    startDma(priv.dma_channel, priv.segments, SEGMENT_BUFFER_LENGTH * SEGMENT_TRANSFERS);
+    ::LL_TIM_EnableDMAReq_UPDATE(priv.tim);
+    ::LL_TIM_GenerateEvent_UPDATE(priv.tim);
+    return true;
+}
 
-    if (note.isValid())
-    {
-        const std::uint32_t previous_auto_reload = ::LL_TIM_GetAutoReload(priv.tim);
+void Buzzer::stop()
+{
+    auto & priv = *p_;
 
-        ::LL_TIM_SetPrescaler(priv.tim, 2 << (12 - note.octave()));
-        ::LL_TIM_SetAutoReload(priv.tim, NOTES[note.tone()]);
+    ::LL_TIM_DisableDMAReq_UPDATE(priv.tim);
+    ::LL_DMA_DisableChannel(DMA1, priv.dma_channel);
+    readDmaFlags(priv.dma_channel);
+    priv.melody = nullptr;
 
-        // In case the timer is stopped, generate update event to transfer new
-        // auto-reload value into shadow register
-        if (0 == previous_auto_reload)
-            ::LL_TIM_GenerateEvent_UPDATE(priv.tim);
-    }
-    else
-    {
-        ::LL_TIM_SetPrescaler(priv.tim, 2 << 12);
-        ::LL_TIM_SetAutoReload(priv.tim, 0);
+    // Stop the counter at the silent segment
+    writeSegment(priv.tim, priv.channel, silenceSegment(1));
+    ::LL_TIM_GenerateEvent_UPDATE(priv.tim);
 
-        // Force toggling output-compare output into low state, otherwise ther's
-        // 50:50 chance that outputs stays high, causing buzzer to whine
-        resetOutput(priv.tim, priv.channel);
+    // Force toggling output-compare output into low state, otherwise ther's
+    // 50:50 chance that outputs stays high, causing buzzer to whine
+    resetOutput(priv.tim, priv.channel);
+}
+
+void Buzzer::maybeHandleDmaInterrupt()
+{
+    auto & priv = *p_;
+
+    const std::uint32_t flags = readDmaFlags(priv.dma_channel);
+    if (0 == flags || nullptr == priv.melody)
+        return;
+
+    // Refill the half-buffer, which was just transferred
+    const std::size_t half_id = (flags & (1 << DmaFlags::DMA_COMPLETE)) ? 1 : 0;
+    Segment * const half = priv.segments + (half_id * HALF_BUFFER_LENGTH);
+    Trace::record(TraceEvent::BUZZER_DMA, half_id);
+    if (0 != priv.remaining_refills)
+    {
+        // The melody ended, stop once its last segment was played
+        if (0 == --priv.remaining_refills)
+        {
+            stop();
+            return;
+        }
+        for (std::size_t n = 0; n != HALF_BUFFER_LENGTH; ++n)
+            half[n] = silenceSegment(1);
     }
+    else if (!fillSegments(priv.melody, half, HALF_BUFFER_LENGTH))
+        priv.remaining_refills = 2;
 }
 
 }  // namespace driver
@@ -5,6 +5,9 @@
 #ifndef DRIVER_BUZZER_HPP_
 #define DRIVER_BUZZER_HPP_
 
+#include <cstddef>
+#include <cstdint>
+
 #include "tools/hidden.hpp"
 #include "driver/common.hpp"
 #include "music_note.hpp"
@@ -13,9 +16,84 @@
 namespace driver
 {
 
+/**
+ * @brief Buzzer driven by a timer channel in toggle mode
+ *
+ * Melodies are played from a circular buffer of segments, which the DMA
+ * writes into the timer registers using DMA burst on every update event. The
+ * repetition counter of the timer delays the update event until the segment is
+ * over, so the CPU only refills half of the buffer every
+ * @ref SEGMENT_BUFFER_LENGTH / 2 segments.
+ */
 class Buzzer
 {
 public:
+    /** @brief Frequency of the timer counter */
+    static const inline std::uint32_t TIMER_CLOCK = 64000000;
+    /** @brief Timer ticks in a millisecond */
+    static const inline std::uint32_t TICKS_PER_MS = TIMER_CLOCK / 1000;
+    /** @brief Maximal number of counter periods in a segment (repetition counter is 8-bit) */
+    static const inline std::uint16_t MAX_SEGMENT_PERIODS = 256;
+    static const inline std::size_t SEGMENT_BUFFER_LENGTH = 16;
+
+    /**
+     * @brief Part of a melody, during which the buzzer plays a single tone or is silent
+     *
+     * The members are in the order of timer registers written by the DMA burst.
+     */
+    struct Segment
+    {
+        std::uint16_t prescaler;
+        std::uint16_t auto_reload;
+        /** @brief Number of counter periods minus one */
+        std::uint16_t repetition;
+        std::uint16_t compare;
+
+        std::uint32_t periodTicks() const
+        {
+            return (static_cast<std::uint32_t>(prescaler) + 1) * (static_cast<std::uint32_t>(auto_reload) + 1);
+        }
+    };
+
+    /**
+     * @brief Source of the melody segments
+     */
+    class Melody
+    {
+    public:
+        /**
+         * @brief Write following segments of the melody
+         *
+         * Called from the DMA interrupt.
+         *
+         * @param[out] segments Buffer receiving the segments
+         * @param count Number of segments to write
+         *
+         * @return Number of written segments, lower than @p count if the melody ended
+         */
+        virtual std::size_t fill(Segment * segments, std::size_t count) = 0;
+
+        virtual ~Melody() = default;
+    };
+
+    /**
+     * @brief Make segment playing a tone
+     *
+     * The output toggles every counter period, even number of periods leaves
+     * the output in the inactive state.
+     *
+     * @param note Note to play
+     * @param periods Number of counter periods (1 to @ref MAX_SEGMENT_PERIODS)
+     */
+    static Segment toneSegment(MusicNote note, std::uint16_t periods);
+
+    /**
+     * @brief Make silent segment
+     *
+     * @param duration Duration in milliseconds (1 to @ref MAX_SEGMENT_PERIODS)
+     */
+    static Segment silenceSegment(std::uint16_t duration);
+
     Buzzer();
     ~Buzzer();
 
@@ -24,21 +102,34 @@ public:
      *
      * @param tim_id Timer whose channel to initialize (it already needs to be initialized)
      * @param channel_id Channel to associate the Buzzer instance with
+     * @param dma_channel_id ID of the DMA channel to use
      *
      * @return Success
      */
-    bool initialize(TimerId tim_id, uint8_t channel_id);
+    bool initialize(TimerId tim_id, uint8_t channel_id, DmaChannelId dma_channel_id);
 
     /**
-     * @brief Play given note
+     * @brief Start playing a melody
      *
-     * @param note Note to play, invalid note to stop playing
+     * @param melody Melody to play, needs to stay valid until the playback is stopped
+     *
+     * @return The melody is playing
+     */
+    bool play(Melody * melody);
+
+    /**
+     * @brief Stop playing
+     */
+    void stop();
+
+    /**
+     * @brief Call from DMA interrupt
      */
-    void playNote(MusicNote note);
+    void maybeHandleDmaInterrupt();
 
 private:
     struct Private;
-    Hidden<Private, 8> p_;
+    Hidden<Private, 20 + (SEGMENT_BUFFER_LENGTH * sizeof(Segment))> p_;
 };
 
 }  // driver
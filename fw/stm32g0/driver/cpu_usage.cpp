@@ -94,6 +94,11 @@ void CpuUsage::startPeriod()
     previous_start_ = ::LL_TIM_GetCounter(p_->tim);
 }
 
+CpuUsage::TimerType CpuUsage::timestamp() const
+{
+    return ::LL_TIM_GetCounter(p_->tim);
+}
+
 void CpuUsage::endPeriod()
 {
     const TimerType elapsed = ::LL_TIM_GetCounter(p_->tim) - previous_start_;
@@ -19,10 +19,9 @@ namespace driver
  */
 class CpuUsage
 {
-private:
+public:
     using TimerType = std::uint16_t;
 
-public:
     struct Stats
     {
         TimerType min;
@@ -38,6 +37,11 @@ public:
     void startPeriod();
     void endPeriod();
 
+    /**
+     * @brief Get current value of the free running microsecond counter
+     */
+    TimerType timestamp() const;
+
     const Stats & stats() const
     {
         return stats_;
@@ -7,6 +7,7 @@
 #include "stm32g0xx_ll_dmamux.h"
 
 #include "driver/tools/irq.hpp"
+#include "driver/tools/trace.hpp"
 
 
 namespace driver
@@ -346,6 +347,8 @@ public:
         if (nullptr != transaction)
         {
             TransactionProcessor::setStatus(transaction, result);
+            Trace::record(TraceEvent::I2C_DONE,
+                    (static_cast<std::uint16_t>(transaction->address()) << 8) | static_cast<std::uint8_t>(result));
             done_.push(toNode(transaction));
         }
     }
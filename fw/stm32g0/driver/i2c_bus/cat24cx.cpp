@@ -6,14 +6,119 @@ namespace driver
 namespace i2c
 {
 
+namespace
+{
+
+inline void setMemoryAddress(I2cBus::Transaction * transaction, std::uint16_t mem_address)
+{
+    auto * const local = static_cast<std::uint8_t *>(transaction->localBuffer());
+    local[0] = static_cast<std::uint8_t>(mem_address >> 8);
+    local[1] = static_cast<std::uint8_t>(mem_address);
+}
+
+}  // namespace
+
+
+bool Cat24cx::start(Operation operation, std::uint16_t mem_address, void * data, std::size_t size, Result * result)
+{
+    if (isBusy() || size > 0xFFFFu)
+        return false;
+
+    operation_ = operation;
+    result_ = result;
+    *result_ = Result::PENDING;
+    in_flight_ = 0;
+    failed_ = false;
+    mem_address_ = mem_address;
+    attempts_ = 0;
+    remaining_ = static_cast<std::uint16_t>(size);
+    chunk_ = 0;
+    data_ = reinterpret_cast<std::uintptr_t>(data);
+
+    if (0 == size)
+        finish(Result::DONE);
+    return true;
+}
+
 void Cat24cx::handleResponse(const I2cBus::Transaction * transaction)
 {
-    (void)transaction;
+    if (0 == in_flight_)
+        return;
+
+    if (I2cBus::Transaction::Status::DONE != transaction->status())
+        failed_ = true;
+    if (0 != --in_flight_)
+        return;
+
+    if (failed_)
+    {
+        // The EEPROM does not answer while programming a page
+        failed_ = false;
+        if (++attempts_ >= MAX_ATTEMPTS)
+            finish(Result::FAILED);
+        return;
+    }
+
+    attempts_ = 0;
+    mem_address_ += chunk_;
+    data_ += chunk_;
+    remaining_ -= chunk_;
+    chunk_ = 0;
+    if (0 == remaining_)
+        finish(Result::DONE);
 }
 
 void Cat24cx::createRequest(I2cBus * bus)
 {
-    (void)bus;
+    if (!isBusy() || 0 != in_flight_)
+        return;
+
+    void * const data = reinterpret_cast<void *>(data_);
+
+    switch (operation_)
+    {
+    case Operation::READ:
+        {
+            // Random read: write the memory address, then read sequentially after a re-START
+            I2cBus::Transaction * const addr_tr = bus->allocate();
+            if (nullptr == addr_tr)
+                return;
+            I2cBus::Transaction * const data_tr = bus->allocate();
+            if (nullptr == data_tr)
+            {
+                bus->release(addr_tr);
+                return;
+            }
+
+            chunk_ = remaining_;
+            setMemoryAddress(addr_tr, mem_address_);
+            addr_tr->write(address(), 2);
+            data_tr->read(address(), 0, data, chunk_);
+            bus->enqueue(addr_tr);
+            bus->enqueue(data_tr);
+            in_flight_ = 2;
+        }
+        break;
+
+    case Operation::WRITE:
+        {
+            I2cBus::Transaction * const tr = bus->allocate();
+            if (nullptr == tr)
+                return;
+
+            // Page write must not cross the page boundary
+            const std::size_t page_remaining = PAGE_SIZE - (mem_address_ % PAGE_SIZE);
+            chunk_ = static_cast<std::uint16_t>(remaining_ < page_remaining ? remaining_ : page_remaining);
+            setMemoryAddress(tr, mem_address_);
+            tr->write(address(), 2, data, chunk_);
+            bus->enqueue(tr);
+            in_flight_ = 1;
+        }
+        break;
+
+    case Operation::NONE:
+        break;
+    }
 }
 
 }  // namespace i2c
@@ -5,6 +5,7 @@
 #ifndef DRIVER_I2C_BUS_CAT24CX_HPP_
 #define DRIVER_I2C_BUS_CAT24CX_HPP_
 
+#include <cstddef>
 #include <cstdint>
 #include "driver/i2c_bus.hpp"
 
@@ -14,14 +15,95 @@ namespace driver
 namespace i2c
 {
 
+/**
+ * @brief Driver of CAT24Cxx I2C EEPROM with 16-bit memory addresses
+ *
+ * Single operation can be in progress at a time, so several users can share
+ * the EEPROM by retrying to start their operations. Operations are split into
+ * I2C transactions by @ref createRequest() and completed by
+ * @ref handleResponse(). Write is split into page writes; the EEPROM does not
+ * answer while it is programming a page, so the transactions are repeated
+ * until it does (acknowledge polling).
+ */
 class Cat24cx
 {
 public:
+    /** @brief Size of the write page, smallest one of the 16-bit address parts */
+    static const inline std::size_t PAGE_SIZE = 32;
+    /** @brief Number of transaction attempts not answered by the EEPROM before the operation fails */
+    static const inline std::uint16_t MAX_ATTEMPTS = 1024;
+
+    enum class Result: std::uint8_t
+    {
+        NONE,
+        PENDING,
+        DONE,
+        FAILED,
+    };
+
     I2cBus::Address address() const { return I2cBus::Address(0b1010000); }
+
+    /**
+     * @brief Start reading data from the EEPROM
+     *
+     * @param mem_address Address within the EEPROM
+     * @param[out] data Buffer receiving the data, needs to be valid until the operation finishes
+     * @param size Number of bytes to read
+     * @param[out] result Result of the operation, updated once it finishes
+     *
+     * @return Operation was started
+     * @retval false Other operation is still in progress
+     */
+    bool read(std::uint16_t mem_address, void * data, std::size_t size, Result * result)
+    {
+        return start(Operation::READ, mem_address, data, size, result);
+    }
+
+    /**
+     * @brief Start writing data to the EEPROM
+     *
+     * @param mem_address Address within the EEPROM
+     * @param data Data to write, need to be valid until the operation finishes
+     * @param size Number of bytes to write
+     * @param[out] result Result of the operation, updated once it finishes
+     *
+     * @return Operation was started
+     * @retval false Other operation is still in progress
+     */
+    bool write(std::uint16_t mem_address, const void * data, std::size_t size, Result * result)
+    {
+        return start(Operation::WRITE, mem_address, const_cast<void *>(data), size, result);
+    }
+
+    /** @brief Check whether an operation is in progress */
+    bool isBusy() const { return Operation::NONE != operation_; }
+
     void handleResponse(const I2cBus::Transaction * transaction);
     void createRequest(I2cBus * bus);
 
 private:
+    enum class Operation: std::uint8_t
+    {
+        NONE, READ, WRITE,
+    };
+
+    Operation operation_ = Operation::NONE;
+    Result * result_ = nullptr;
+    /** @brief Number of transactions enqueued and not handled yet */
+    std::uint8_t in_flight_ = 0;
+    bool failed_ = false;
+    std::uint16_t mem_address_ = 0;
+    std::uint16_t attempts_ = 0;
+    std::uint16_t remaining_ = 0;
+    std::uint16_t chunk_ = 0;
+    std::uintptr_t data_ = 0;
+
+    bool start(Operation operation, std::uint16_t mem_address, void * data, std::size_t size, Result * result);
+    void finish(Result result)
+    {
+        operation_ = Operation::NONE;
+        *result_ = result;
+    }
 };
 
 }  // namespace i2c
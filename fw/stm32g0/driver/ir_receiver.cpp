@@ -2,6 +2,8 @@
 
 #include <utility>
 
+#include "driver/ir_receiver/capture_buffer.hpp"
+
 #include "stm32g0xx_ll_tim.h"
 #include "stm32g0xx_ll_dma.h"
 
@@ -11,125 +13,6 @@ namespace driver
 namespace
 {
 
-enum class Symbol
-{
-    BIT_ZERO = 0,
-    BIT_ONE = 1,
-    START,
-    REPEAT,
-    INVALID,
-};
-
-
-class BitBuffer
-{
-public:
-    static const inline std::size_t BUFFER_LENGTH = IrReceiver::BUFFER_LENGTH;
-
-    void * buffer() { return buffer_; }
-
-    std::pair<const std::uint8_t *, std::size_t> peek(std::size_t dma_data_length) const
-    {
-        const std::size_t write_pos = BUFFER_LENGTH - dma_data_length;
-        const std::uint8_t * const pos_ptr = buffer_ + pos_;
-
-        if (write_pos >= pos_)
-            return {pos_ptr, write_pos - pos_};
-        else
-            return {pos_ptr, BUFFER_LENGTH - pos_};
-    }
-
-    void process(std::size_t byte_cnt)
-    {
-        pos_ += byte_cnt;
-        if (pos_ >= BUFFER_LENGTH)
-            pos_ = 0;
-    }
-
-private:
-    std::size_t pos_ = 0;
-    std::uint8_t buffer_[BUFFER_LENGTH];
-};
-
-
-class PacketState
-{
-public:
-    using Code = IrReceiver::Code;
-
-    /**
-     * @brief Process IR symbol
-     * @param symbol Received symbol
-     * @return Is done
-     */
-    [[nodiscard]] bool processSymbol(Symbol symbol)
-    {
-        if (-1 == pos_)
-        {
-            if (Symbol::START != symbol)
-                return false;
-        }
-
-        switch (symbol)
-        {
-        case Symbol::BIT_ONE:
-            buffer_[pos_ >> 3] |= (1 << (pos_ & 7));
-            [[fallthrough]];
-        case Symbol::BIT_ZERO:
-            pos_ += 1;
-            if (32 == pos_)
-            {
-                pos_ = -1;
-                return true;
-            }
-            break;
-
-        case Symbol::START:
-            pos_ = 0;
-            for (auto & b: buffer_)
-                b = 0;
-            break;
-
-        case Symbol::REPEAT:
-        case Symbol::INVALID:
-            reset();
-            break;
-        }
-        return false;
-    }
-
-
-    Code checkAndGet() const
-    {
-        if (!check(buffer_[0], buffer_[1]) || !check(buffer_[2], buffer_[3]))
-            return {};
-        return Code(buffer_[0], buffer_[2]);
-    }
-
-    void clear()
-    {
-        // Mark data as cleared by making sure an invalid code is stored in the
-        // buffer
-        buffer_[0] = 0;
-        buffer_[1] = 0;
-    }
-
-    void reset()
-    {
-        pos_ = -1;
-    }
-
-private:
-    std::int32_t pos_ = -1;
-    std::uint8_t buffer_[4] = {0, 0, 0, 0};
-
-    static bool check(std::uint8_t value, std::uint8_t inverse)
-    {
-        return value == static_cast<std::uint8_t>(~inverse);
-    }
-};
-
-
 class RepeatTimer
 {
 public:
@@ -151,7 +34,10 @@ private:
 const std::uint32_t PERIOD_CHANNEL = LL_TIM_CHANNEL_CH1;
 const std::uint32_t WIDTH_CHANNEL = LL_TIM_CHANNEL_CH2;
 
-const std::uint32_t REPEAT_TIME = 120;
+const std::uint32_t IDLE_CHANNEL = LL_TIM_CHANNEL_CH3;
+
+// Frames of RC5 are repeated every 114 ms, give the polling some slack
+const std::uint32_t REPEAT_TIME = 150;
 
 // Sample at 64 MHz / 32 = 2 MHz, 8 consecutive events required to change value, i.e. signal
 // needs to be stable for 0.5 us * 8 = 4 us, we are measuring time with frequency of 10 kHz, i.e. in multiples of
@@ -159,16 +45,6 @@ const std::uint32_t REPEAT_TIME = 120;
 const std::uint32_t IC_FILTER = LL_TIM_IC_FILTER_FDIV32_N8;
 
 
-constexpr const std::uint8_t LEAD_WIDTH = 90;  // 9 ms
-constexpr const std::uint8_t START_PERIOD = LEAD_WIDTH + 45;  // 9 ms + 4.5 ms
-constexpr const std::uint8_t REPEAT_PERIOD = LEAD_WIDTH + 22;
-
-constexpr const std::uint8_t BIT_WIDTH = 6;
-constexpr const std::uint8_t BIT_ZERO_PERIOD = 11;
-constexpr const std::uint8_t BIT_ONE_PERIOD = 22;
-
-
-
 ::TIM_TypeDef * toTimer(TimerId tim_id)
 {
     switch (tim_id)
@@ -239,9 +115,17 @@ bool initializeTimer(::TIM_TypeDef * tim)
             return false;
     }
 
-    // 6. - 7. Slave mode - reset by edge of T1
+    // 6. - 7. Slave mode - reset and start by edge of T1, the counter stops
+    // at overflow, so period captured after a long silence reads as zero
     ::LL_TIM_SetTriggerInput(tim, LL_TIM_TS_TI1FP1);
-    ::LL_TIM_SetSlaveMode(tim, LL_TIM_SLAVEMODE_RESET);
+    ::LL_TIM_SetSlaveMode(tim, LL_TIM_SLAVEMODE_COMBINED_RESETTRIGGER);
+    ::LL_TIM_SetOnePulseMode(tim, LL_TIM_ONEPULSEMODE_SINGLE);
+
+    // Idle channel generates interrupt once the line is silent long enough to
+    // complete a frame
+    ::LL_TIM_OC_SetMode(tim, IDLE_CHANNEL, LL_TIM_OCMODE_FROZEN);
+    ::LL_TIM_OC_SetCompareCH3(tim, ir::Decoder::IDLE_TIMEOUT);
+    ::LL_TIM_EnableIT_CC3(tim);
 
     // 8. Enable the captures
     ::LL_TIM_CC_EnableChannel(tim, PERIOD_CHANNEL);
@@ -269,12 +153,12 @@ bool initializeDma(std::uint32_t dma_channel, std::uint32_t request, ::TIM_TypeD
             LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT |
             LL_DMA_PDATAALIGN_HALFWORD | LL_DMA_MDATAALIGN_BYTE |
             LL_DMA_PRIORITY_MEDIUM);
-    ::LL_DMA_SetPeriphAddress(DMA1, dma_channel, reinterpret_cast<std::uint32_t>(&(tim->DMAR)));
+    ::LL_DMA_SetPeriphAddress(DMA1, dma_channel, reinterpret_cast<std::uintptr_t>(&(tim->DMAR)));
     ::LL_DMA_SetMemoryAddress(DMA1, dma_channel, 0);
     ::LL_DMA_SetDataLength(DMA1, dma_channel, 0);
 
-    ::LL_DMA_DisableIT_TC(DMA1, dma_channel);
-    ::LL_DMA_DisableIT_HT(DMA1, dma_channel);
+    ::LL_DMA_EnableIT_TC(DMA1, dma_channel);
+    ::LL_DMA_EnableIT_HT(DMA1, dma_channel);
     ::LL_DMA_DisableIT_TE(DMA1, dma_channel);
 
     ::LL_TIM_ConfigDMABurst(tim, LL_TIM_DMABURST_BASEADDR_CCR1, LL_TIM_DMABURST_LENGTH_2TRANSFERS);
@@ -286,7 +170,7 @@ inline void startDma(std::uint32_t dma_channel, const void * data, std::size_t l
 {
     ::LL_DMA_DisableChannel(DMA1, dma_channel);
 
-    ::LL_DMA_SetMemoryAddress(DMA1, dma_channel, reinterpret_cast<std::uint32_t>(data));
+    ::LL_DMA_SetMemoryAddress(DMA1, dma_channel, reinterpret_cast<std::uintptr_t>(data));
     ::LL_DMA_SetDataLength(DMA1, dma_channel, length);
 
     ::LL_DMA_EnableChannel(DMA1, dma_channel);
@@ -297,34 +181,58 @@ inline std::size_t getDmaDataLength(std::uint32_t dma_channel)
     return ::LL_DMA_GetDataLength(DMA1, dma_channel);
 }
 
-template <std::uint8_t EXPECTED>
-inline bool classifyTimeLength(std::uint8_t value)
+void enableIrqs(std::uint32_t dma_channel)
 {
-    static const std::uint8_t NEIGHBORHOOD = 2;
-    const std::uint8_t diff = value - (EXPECTED - NEIGHBORHOOD);
-    return diff <= (NEIGHBORHOOD * 2);
+    switch (dma_channel)
+    {
+    case LL_DMA_CHANNEL_1:
+        ::NVIC_EnableIRQ(::DMA1_Channel1_IRQn);
+        break;
+    case LL_DMA_CHANNEL_2:
+    case LL_DMA_CHANNEL_3:
+        ::NVIC_EnableIRQ(::DMA1_Channel2_3_IRQn);
+        break;
+    case LL_DMA_CHANNEL_4:
+    case LL_DMA_CHANNEL_5:
+    case LL_DMA_CHANNEL_6:
+    case LL_DMA_CHANNEL_7:
+        ::NVIC_EnableIRQ(::DMA1_Ch4_7_DMAMUX1_OVR_IRQn);
+        break;
+    }
+
+    // Both interrupts run the decoder, they must not preempt each other, i.e.
+    // they need to stay at the same priority
+    ::NVIC_EnableIRQ(::TIM3_IRQn);
 }
 
-Symbol classifySymbol(const std::uint8_t * buffer)
+bool readAndClearDmaFlags(std::uint32_t dma_channel)
 {
-    const std::uint8_t period = buffer[0];
-    const std::uint8_t width = buffer[1];
+    #define READ_DMA_FLAGS_CHANNEL(dma, channel)  \
+        if (::LL_DMA_IsActiveFlag_TC ## channel(dma))  \
+        {  \
+            is_set = true;  \
+            ::LL_DMA_ClearFlag_TC ## channel(dma);  \
+        }  \
+        if (::LL_DMA_IsActiveFlag_HT ## channel(dma))  \
+        {  \
+            is_set = true;  \
+            ::LL_DMA_ClearFlag_HT ## channel(dma);  \
+        }
 
-    if (classifyTimeLength<BIT_WIDTH>(width)) [[likely]]
+    bool is_set = false;
+    switch (dma_channel)
     {
-        if (classifyTimeLength<BIT_ZERO_PERIOD>(period))
-            return Symbol::BIT_ZERO;
-        else if (classifyTimeLength<BIT_ONE_PERIOD>(period))
-            return Symbol::BIT_ONE;
+    case LL_DMA_CHANNEL_1: READ_DMA_FLAGS_CHANNEL(DMA1, 1); break;
+    case LL_DMA_CHANNEL_2: READ_DMA_FLAGS_CHANNEL(DMA1, 2); break;
+    case LL_DMA_CHANNEL_3: READ_DMA_FLAGS_CHANNEL(DMA1, 3); break;
+    case LL_DMA_CHANNEL_4: READ_DMA_FLAGS_CHANNEL(DMA1, 4); break;
+    case LL_DMA_CHANNEL_5: READ_DMA_FLAGS_CHANNEL(DMA1, 5); break;
+    case LL_DMA_CHANNEL_6: READ_DMA_FLAGS_CHANNEL(DMA1, 6); break;
+    case LL_DMA_CHANNEL_7: READ_DMA_FLAGS_CHANNEL(DMA1, 7); break;
     }
-    else if (classifyTimeLength<LEAD_WIDTH>(width))
-    {
-        if (classifyTimeLength<START_PERIOD>(period))
-            return Symbol::START;
-        else if (classifyTimeLength<REPEAT_PERIOD>(period))
-            return Symbol::REPEAT;
-    }
-    return Symbol::INVALID;
+
+    #undef READ_DMA_FLAGS_CHANNEL
+    return is_set;
 }
 
 }  // namespace
@@ -333,11 +241,11 @@ Symbol classifySymbol(const std::uint8_t * buffer)
 struct IrReceiver::Private
 {
     ::TIM_TypeDef * tim;
+    const CpuUsage * clock;
 
     std::uint32_t dma_channel;
 
-    BitBuffer buffer;
-    PacketState packet_state;
+    ir::CaptureBuffer<BUFFER_LENGTH> buffer;
     RepeatTimer repeat_timer;
 };
 
@@ -351,7 +259,7 @@ IrReceiver::~IrReceiver()
 }
 
 
-bool IrReceiver::initialize(TimerId tim_id, DmaChannelId dma_channel_id)
+bool IrReceiver::initialize(TimerId tim_id, DmaChannelId dma_channel_id, const CpuUsage * clock)
 {
     auto * const tim = toTimer(tim_id);
     if (nullptr == tim)
@@ -370,9 +278,11 @@ bool IrReceiver::initialize(TimerId tim_id, DmaChannelId dma_channel_id)
 
     auto & priv = *p_;
     priv.tim = tim;
+    priv.clock = clock;
     priv.dma_channel = dma_channel;
 
     startDma(dma_channel, priv.buffer.buffer(), priv.buffer.BUFFER_LENGTH);
+    enableIrqs(dma_channel);
     startTimer(tim);
 
     return true;
@@ -383,47 +293,20 @@ auto IrReceiver::read(std::uint32_t time) -> std::pair<Code, bool>
     auto & priv = *p_;
 
     bool is_new = false;
-    while (true)
+    ir::Frame frame;
+    while (decoder_.read(&frame))
     {
-        auto [buffer, length] = priv.buffer.peek(getDmaDataLength(priv.dma_channel));
-
-        if (length & 0x1)
-        {
-            // Just in case we manage to hit in the middle of DMA burst, do not
-            // process the odd byte at the end
-            length -= 1;
-        }
+        priv.repeat_timer.reset(time);
 
-        if (0 == length)
+        // Repeated frames continue the current key press, unless it already timed out
+        if (frame.code.isValid() && (!frame.repeat || frame.code != current_code_))
         {
-            // There is no more data, we are done
+            current_code_ = frame.code;
+            press_timestamp_ = frame.timestamp;
+            is_new = true;
             break;
         }
-
-        const std::uint8_t * pos = buffer;
-        const std::uint8_t * const end = buffer + length;  // Length is guaranteed to be even number here
-        for (; pos != end; pos += 2)
-        {
-            const Symbol symbol = classifySymbol(pos);
-
-            if (Symbol::REPEAT == symbol)
-                priv.repeat_timer.reset(time);
-
-            if (priv.packet_state.processSymbol(symbol))
-            {
-                priv.repeat_timer.reset(time);
-                is_new = true;
-                current_code_ = priv.packet_state.checkAndGet();
-
-                pos += 2;  // The current two bytes have been processed
-                break;
-            }
-        }
-
-        priv.buffer.process(pos - buffer);
-        if (is_new)
-            break;
-    };
+    }
 
     // Clear button code, when button is released
     const Code code = current_code_;
@@ -439,5 +322,40 @@ auto IrReceiver::read(std::uint32_t time) -> std::pair<Code, bool>
     return {code, is_new};
 }
 
+void IrReceiver::maybeHandleDmaInterrupt()
+{
+    if (readAndClearDmaFlags(p_->dma_channel))
+        decodeCaptured();
+}
+
+void IrReceiver::maybeHandleTimerInterrupt()
+{
+    auto & priv = *p_;
+
+    if (!::LL_TIM_IsActiveFlag_CC3(priv.tim))
+        return;
+    ::LL_TIM_ClearFlag_CC3(priv.tim);
+
+    decodeCaptured();
+    // Width of the last mark was captured, but it will be transferred only
+    // with the next falling edge
+    decoder_.flush(::LL_TIM_IC_GetCaptureCH2(priv.tim), priv.clock->timestamp());
+}
+
+void IrReceiver::decodeCaptured()
+{
+    auto & priv = *p_;
+
+    while (true)
+    {
+        const auto [buffer, length] = priv.buffer.peek(getDmaDataLength(priv.dma_channel));
+        if (0 == length)
+            break;
+
+        decoder_.process(buffer, length, priv.clock->timestamp());
+        priv.buffer.process(length);
+    }
+}
+
 
 }  // namespace driver
@@ -9,6 +9,8 @@
 
 #include "tools/hidden.hpp"
 #include "driver/common.hpp"
+#include "driver/cpu_usage.hpp"
+#include "driver/ir_receiver/decoder.hpp"
 
 
 namespace driver
@@ -17,54 +19,12 @@ namespace driver
 class IrReceiver
 {
 public:
-    class Code
-    {
-    public:
-        static Code Invalid() { return Code{}; }
-
-        Code():
-            is_valid_(false), address_(), command_()
-        { }
-
-        Code(std::uint8_t address, std::uint8_t command):
-            is_valid_(true), address_(address), command_(command)
-        { }
-
-        Code(const Code &) = default;
-        Code & operator =(const Code &) = default;
-
-        bool isValid() const { return is_valid_; }
-        std::uint8_t address() const { return address_; }
-        std::uint8_t command() const { return command_; }
-
-        friend bool operator ==(const Code & lhs, const Code & rhs)
-        {
-            if (lhs.is_valid_ != rhs.is_valid_)
-                return false;
-            if (!lhs.is_valid_)
-                return true;
-            if (lhs.address_ != rhs.address_)
-                return false;
-            if (lhs.command_ != rhs.command_)
-                return false;
-            return true;
-        }
-
-        friend bool operator !=(const Code & lhs, const Code & rhs)
-        {
-            return ! operator ==(lhs, rhs);
-        }
-
-    private:
-        std::uint32_t is_valid_: 8;
-        std::uint32_t address_: 8;
-        std::uint32_t command_: 8;
-    };
+    using Code = ir::Code;
 
     /**
      * @brief Length of the intermediate DMA buffer in data bytes
      */
-    static const inline std::size_t BUFFER_LENGTH = 256;
+    static const inline std::size_t BUFFER_LENGTH = 64;
 
     IrReceiver();
     ~IrReceiver();
@@ -74,10 +34,11 @@ public:
      *
      * @param tim_id Timer whose channel to initialize (it already needs to be initialized)
      * @param dma_channel_id ID of the DMA channel to use for
+     * @param clock Free running microsecond counter used to timestamp the frames
      *
      * @return Success
      */
-    bool initialize(TimerId tim_id, DmaChannelId dma_channel_id);
+    bool initialize(TimerId tim_id, DmaChannelId dma_channel_id, const CpuUsage * clock);
 
     /**
      * @brief Read received IR packet
@@ -88,10 +49,31 @@ public:
      */
     std::pair<Code, bool> read(std::uint32_t time);
 
+    /**
+     * @brief Get the microsecond timestamp of the frame which started the current button press
+     *
+     * The frame is timestamped in the interrupt handler, which decoded it.
+     */
+    std::uint16_t pressTimestamp() const { return press_timestamp_; }
+
+    /**
+     * @brief Handle the DMA interrupt, decode captured symbols
+     */
+    void maybeHandleDmaInterrupt();
+
+    /**
+     * @brief Handle the timer interrupt, complete frames once the line is idle
+     */
+    void maybeHandleTimerInterrupt();
+
 private:
     struct Private;
-    Hidden<Private, 8 + (BUFFER_LENGTH + 4) + 8 + 4> p_;
+    Hidden<Private, 12 + (BUFFER_LENGTH + 4) + 4> p_;
+    ir::Decoder decoder_;
     Code current_code_ = Code::Invalid();
+    std::uint16_t press_timestamp_ = 0;
+
+    void decodeCaptured();
 };
 
 }  // driver
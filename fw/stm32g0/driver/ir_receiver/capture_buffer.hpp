@@ -0,0 +1,69 @@
+/**
+ * @file
+ */
+
+#ifndef DRIVER_IR_RECEIVER_CAPTURE_BUFFER_HPP_
+#define DRIVER_IR_RECEIVER_CAPTURE_BUFFER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+
+namespace driver
+{
+namespace ir
+{
+
+/**
+ * @brief Circular buffer filled by DMA with pairs of captured period and width
+ *
+ * @tparam L Length of the buffer in bytes, needs to be an even number
+ */
+template <std::size_t L>
+class CaptureBuffer
+{
+public:
+    static const inline std::size_t BUFFER_LENGTH = L;
+
+    static_assert(0 == (BUFFER_LENGTH & 1), "Capture buffer needs to store whole symbols");
+
+    void * buffer() { return buffer_; }
+
+    /**
+     * @brief Get contiguous block of captured data not processed yet
+     *
+     * @param dma_data_length Number of bytes remaining to be transferred by DMA
+     *
+     * @return Pointer to the data and their length in bytes, always an even number
+     */
+    std::pair<const std::uint8_t *, std::size_t> peek(std::size_t dma_data_length) const
+    {
+        const std::size_t write_pos = BUFFER_LENGTH - dma_data_length;
+        const std::uint8_t * const pos_ptr = buffer_ + pos_;
+
+        // Just in case we manage to hit in the middle of DMA burst, do not
+        // process the odd byte at the end
+        if (write_pos >= pos_)
+            return {pos_ptr, (write_pos - pos_) & ~std::size_t{1}};
+        else
+            return {pos_ptr, BUFFER_LENGTH - pos_};
+    }
+
+    void process(std::size_t byte_cnt)
+    {
+        pos_ += byte_cnt;
+        if (pos_ >= BUFFER_LENGTH)
+            pos_ = 0;
+    }
+
+private:
+    std::size_t pos_ = 0;
+    std::uint8_t buffer_[BUFFER_LENGTH];
+};
+
+}  // namespace ir
+}  // namespace driver
+
+
+#endif  // DRIVER_IR_RECEIVER_CAPTURE_BUFFER_HPP_
@@ -0,0 +1,421 @@
+#include "driver/ir_receiver/decoder.hpp"
+
+#include "driver/tools/trace.hpp"
+
+
+namespace driver
+{
+namespace ir
+{
+namespace
+{
+
+constexpr std::uint8_t NO_FIELD = 0xFF;
+
+/**
+ * @brief Position of a field in a frame
+ */
+struct Field
+{
+    std::uint8_t pos;
+    std::uint8_t length;
+};
+
+/**
+ * @brief Description of bits carried by a frame
+ */
+struct FrameLayout
+{
+    std::uint8_t bit_count;
+    bool lsb_first;
+    /** @brief Field with fixed value, e.g. start and mode bits */
+    Field fixed;
+    std::uint8_t fixed_value;
+    Field address;
+    /** @brief Position of inverted copy of the address or @ref NO_FIELD */
+    std::uint8_t address_inverse;
+    Field command;
+    /** @brief Position of inverted copy of the command or @ref NO_FIELD */
+    std::uint8_t command_inverse;
+    /** @brief Position of the toggle bit or @ref NO_FIELD */
+    std::uint8_t toggle;
+    /** @brief Position of inverted extension bit of the command (RC5X) or @ref NO_FIELD */
+    std::uint8_t command_extension;
+};
+
+/**
+ * @brief Timing of a single symbol in multiples of 100 us
+ */
+struct PulseTiming
+{
+    std::uint8_t width;
+    std::uint8_t period;
+};
+
+/**
+ * @brief Description of pulse-distance and pulse-width protocols
+ */
+struct PulseProtocol
+{
+    Protocol protocol;
+    PulseTiming header;
+    /** @brief Timing of the repeat code, zero width if the protocol does not use one */
+    PulseTiming repeat;
+    PulseTiming zero;
+    PulseTiming one;
+    /** @brief Last bit is followed by silence, it can be distinguished only by its width */
+    bool last_bit_by_width;
+    FrameLayout layout;
+};
+
+/**
+ * @brief Description of Manchester coded protocols
+ */
+struct ManchesterProtocol
+{
+    Protocol protocol;
+    /** @brief Duration of half-bit in 1/16 of 100 us */
+    std::uint8_t unit;
+    /** @brief Number of half-bit units of the leader mark and space */
+    std::uint8_t leader_mark;
+    std::uint8_t leader_space;
+    /** @brief Number of invisible space half-bits preceding the first mark */
+    std::uint8_t lead_in;
+    /** @brief Bit starting with mark has value one */
+    bool mark_first_is_one;
+    /** @brief Bit having double duration (RC6 trailer bit) or @ref NO_FIELD */
+    std::uint8_t long_bit;
+    FrameLayout layout;
+
+    constexpr std::uint8_t halfCount() const
+    {
+        return leader_mark + leader_space + (layout.bit_count * 2) + (NO_FIELD != long_bit ? 2 : 0);
+    }
+};
+
+
+constexpr PulseProtocol PULSE_PROTOCOLS[Decoder::PULSE_PROTOCOL_COUNT] = {
+    {
+        Protocol::NEC,
+        {90, 135}, {90, 112}, {6, 11}, {6, 22}, false,
+        {32, true, {0, 0}, 0, {0, 8}, 8, {16, 8}, 24, NO_FIELD, NO_FIELD},
+    },
+    {
+        Protocol::SIRC,
+        {24, 30}, {0, 0}, {6, 12}, {12, 18}, true,
+        {12, true, {0, 0}, 0, {7, 5}, NO_FIELD, {0, 7}, NO_FIELD, NO_FIELD, NO_FIELD},
+    },
+};
+
+constexpr ManchesterProtocol MANCHESTER_PROTOCOLS[Decoder::MANCHESTER_PROTOCOL_COUNT] = {
+    {
+        Protocol::RC5,
+        142, 0, 0, 1, false, NO_FIELD,  // 889 us
+        {14, false, {0, 1}, 1, {3, 5}, NO_FIELD, {8, 6}, NO_FIELD, 2, 1},
+    },
+    {
+        Protocol::RC6,
+        71, 6, 2, 0, true, 4,  // 444 us
+        {21, false, {0, 4}, 0x8, {5, 8}, NO_FIELD, {13, 8}, NO_FIELD, 4, NO_FIELD},
+    },
+};
+
+static_assert(MANCHESTER_PROTOCOLS[0].halfCount() <= 64 && MANCHESTER_PROTOCOLS[1].halfCount() <= 64,
+        "Manchester frames do not fit the half-bit buffer");
+
+
+inline bool matches(std::uint8_t expected, std::uint8_t value)
+{
+    static const std::uint8_t NEIGHBORHOOD = 2;
+    const std::uint8_t diff = value - (expected - NEIGHBORHOOD);
+    return diff <= (NEIGHBORHOOD * 2);
+}
+
+inline bool matches(const PulseTiming & timing, std::uint8_t period, std::uint8_t width)
+{
+    return matches(timing.width, width) && matches(timing.period, period);
+}
+
+/**
+ * @brief Convert duration to number of half-bit units
+ *
+ * @return Number of units
+ * @retval 0 Duration is not a multiple of the unit
+ */
+inline std::uint8_t toUnits(std::uint8_t duration, std::uint8_t unit)
+{
+    const std::int32_t scaled = duration * 16;
+    const std::int32_t units = (scaled + (unit / 2)) / unit;
+    const std::int32_t diff = scaled - (units * unit);
+    const std::int32_t tolerance = (unit * 3) / 8;
+    if (diff > tolerance || diff < -tolerance)
+        return 0;
+    return units;
+}
+
+std::uint32_t readField(std::uint64_t bits, Field field, bool lsb_first)
+{
+    std::uint32_t value = 0;
+    for (std::uint8_t n = 0; n != field.length; ++n)
+    {
+        const std::uint32_t bit = (bits >> (field.pos + n)) & 1;
+        value |= bit << (lsb_first ? n : (field.length - 1 - n));
+    }
+    return value;
+}
+
+bool checkInverse(std::uint64_t bits, const FrameLayout & layout, Field field, std::uint8_t inverse_pos,
+        std::uint32_t value)
+{
+    if (NO_FIELD == inverse_pos)
+        return true;
+    const std::uint32_t mask = (std::uint32_t{1} << field.length) - 1;
+    return readField(bits, {inverse_pos, field.length}, layout.lsb_first) == (~value & mask);
+}
+
+/**
+ * @brief Extract code from received bits
+ *
+ * @param bits Received bits, bit `n` holds `n`-th received bit
+ * @param layout Layout of the frame
+ * @param protocol Protocol of the frame
+ * @param[out] code Extracted code
+ * @param[out] toggle Value of the toggle bit
+ *
+ * @return Frame is valid
+ */
+bool extract(std::uint64_t bits, const FrameLayout & layout, Protocol protocol, Code * code, std::uint8_t * toggle)
+{
+    if (readField(bits, layout.fixed, layout.lsb_first) != layout.fixed_value)
+        return false;
+
+    const std::uint32_t address = readField(bits, layout.address, layout.lsb_first);
+    if (!checkInverse(bits, layout, layout.address, layout.address_inverse, address))
+        return false;
+
+    std::uint32_t command = readField(bits, layout.command, layout.lsb_first);
+    if (!checkInverse(bits, layout, layout.command, layout.command_inverse, command))
+        return false;
+    if (NO_FIELD != layout.command_extension)
+        command |= (~(bits >> layout.command_extension) & 1) << layout.command.length;
+
+    *toggle = (NO_FIELD != layout.toggle) ? ((bits >> layout.toggle) & 1) : 0;
+    *code = Code(address, command, protocol);
+    return true;
+}
+
+/**
+ * @brief Get level of a run of half-bits
+ *
+ * @return Level of the half-bits (0 - space, 1 - mark)
+ * @retval -1 Half-bits do not have the same level
+ */
+inline int runLevel(std::uint64_t halves, std::uint8_t pos, std::uint8_t length)
+{
+    const std::uint64_t mask = ((std::uint64_t{1} << length) - 1) << pos;
+    const std::uint64_t run = halves & mask;
+    if (0 == run)
+        return 0;
+    if (mask == run)
+        return 1;
+    return -1;
+}
+
+/**
+ * @brief Convert Manchester coded half-bits into bits
+ *
+ * @return Success
+ */
+bool decodeHalves(const ManchesterProtocol & protocol, std::uint64_t halves, std::uint64_t * bits)
+{
+    if (0 != protocol.leader_mark)
+    {
+        if (1 != runLevel(halves, 0, protocol.leader_mark) ||
+                0 != runLevel(halves, protocol.leader_mark, protocol.leader_space))
+            return false;
+    }
+
+    std::uint8_t pos = protocol.leader_mark + protocol.leader_space;
+    *bits = 0;
+    for (std::uint8_t n = 0; n != protocol.layout.bit_count; ++n)
+    {
+        const std::uint8_t width = (n == protocol.long_bit) ? 2 : 1;
+        const int first = runLevel(halves, pos, width);
+        const int second = runLevel(halves, pos + width, width);
+        if (-1 == first || -1 == second || first == second)
+            return false;
+
+        const bool bit = (1 == first) == protocol.mark_first_is_one;
+        *bits |= std::uint64_t{bit} << n;
+        pos += width * 2;
+    }
+    return true;
+}
+
+/**
+ * @brief Append a run of half-bits
+ *
+ * @return Success
+ */
+inline bool appendHalves(std::uint64_t * halves, std::uint8_t * count, std::uint8_t total, bool mark,
+        std::uint8_t length)
+{
+    if (*count + length > total)
+    {
+        // Spaces longer than the rest of the frame just merge with the idle line
+        if (mark)
+            return false;
+        length = total - *count;
+    }
+
+    if (mark)
+        *halves |= ((std::uint64_t{1} << length) - 1) << *count;
+    *count += length;
+    return true;
+}
+
+}  // namespace
+
+
+void Decoder::process(const std::uint8_t * data, std::size_t length, std::uint16_t timestamp)
+{
+    timestamp_ = timestamp;
+    const std::uint8_t * const end = data + length;
+    for (; data != end; data += 2)
+    {
+        const std::uint8_t period = data[0];
+        const std::uint8_t width = data[1];
+
+        // Symbols following the idle line were already completed by flush()
+        if (0 == period || period >= IDLE_TIMEOUT)
+            continue;
+
+        processSymbol(period, width);
+    }
+}
+
+void Decoder::flush(std::uint8_t trailing_width, std::uint16_t timestamp)
+{
+    timestamp_ = timestamp;
+    processSymbol(0, trailing_width);
+}
+
+void Decoder::processSymbol(std::uint8_t period, std::uint8_t width)
+{
+    Trace::record(TraceEvent::IR_SYMBOL, (static_cast<std::uint16_t>(period) << 8) | width);
+    const bool is_gap = 0 == period;
+
+    for (std::size_t n = 0; n != PULSE_PROTOCOL_COUNT; ++n)
+    {
+        const auto & protocol = PULSE_PROTOCOLS[n];
+        auto & state = pulse_[n];
+
+        if (!is_gap)
+        {
+            if (matches(protocol.header, period, width))
+            {
+                state.pos = 0;
+                state.bits = 0;
+                continue;
+            }
+            if (0 != protocol.repeat.width && matches(protocol.repeat, period, width))
+            {
+                state.pos = -1;
+                mailbox_.push({Code::Invalid(), true, timestamp_});
+                continue;
+            }
+        }
+
+        if (state.pos < 0)
+            continue;
+
+        const bool by_width = is_gap && protocol.last_bit_by_width &&
+                (protocol.layout.bit_count - 1) == state.pos;
+        bool bit;
+        if (by_width ? matches(protocol.one.width, width) : matches(protocol.one, period, width))
+            bit = true;
+        else if (by_width ? matches(protocol.zero.width, width) : matches(protocol.zero, period, width))
+            bit = false;
+        else
+        {
+            state.pos = -1;
+            continue;
+        }
+
+        state.bits |= std::uint64_t{bit} << state.pos;
+        state.pos += 1;
+        if (protocol.layout.bit_count != state.pos)
+        {
+            if (is_gap)
+                state.pos = -1;
+            continue;
+        }
+        state.pos = -1;
+
+        Code code;
+        std::uint8_t toggle;
+        if (!extract(state.bits, protocol.layout, protocol.protocol, &code, &toggle))
+            continue;
+
+        // Protocols with a repeat code send the full frame only once per key press
+        const bool repeat = 0 == protocol.repeat.width && code == state.last_code && toggle == state.last_toggle;
+        state.last_code = code;
+        state.last_toggle = toggle;
+        mailbox_.push({code, repeat, timestamp_});
+    }
+
+    for (std::size_t n = 0; n != MANCHESTER_PROTOCOL_COUNT; ++n)
+    {
+        const auto & protocol = MANCHESTER_PROTOCOLS[n];
+        auto & state = manchester_[n];
+        const std::uint8_t total = protocol.halfCount();
+
+        const std::uint8_t marks = toUnits(width, protocol.unit);
+        std::uint8_t units = is_gap ? 0xFF : toUnits(period, protocol.unit);
+        if (0 == marks || units <= marks)
+        {
+            state.count = 0;
+            continue;
+        }
+
+        // In case the symbol does not fit the current frame, try to start a new frame with it
+        for (int attempt = 0; attempt != 2; ++attempt)
+        {
+            if (0 == state.count)
+            {
+                if (is_gap)
+                    break;
+                state.halves = 0;
+                state.count = protocol.lead_in;
+            }
+
+            if (appendHalves(&state.halves, &state.count, total, true, marks) &&
+                    appendHalves(&state.halves, &state.count, total, false, units - marks))
+                break;
+            state.count = 0;
+        }
+
+        if (total != state.count)
+        {
+            if (is_gap)
+                state.count = 0;
+            continue;
+        }
+        state.count = 0;
+
+        std::uint64_t bits;
+        Code code;
+        std::uint8_t toggle;
+        if (!decodeHalves(protocol, state.halves, &bits) ||
+                !extract(bits, protocol.layout, protocol.protocol, &code, &toggle))
+            continue;
+
+        const bool repeat = code == state.last_code && toggle == state.last_toggle;
+        state.last_code = code;
+        state.last_toggle = toggle;
+        mailbox_.push({code, repeat, timestamp_});
+    }
+}
+
+}  // namespace ir
+}  // namespace driver
@@ -0,0 +1,185 @@
+/**
+ * @file
+ */
+
+#ifndef DRIVER_IR_RECEIVER_DECODER_HPP_
+#define DRIVER_IR_RECEIVER_DECODER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tools/mailbox.hpp"
+
+
+namespace driver
+{
+namespace ir
+{
+
+/**
+ * @brief Supported IR remote protocols
+ */
+enum class Protocol: std::uint8_t
+{
+    NEC,
+    SIRC,
+    RC5,
+    RC6,
+};
+
+
+class Code
+{
+public:
+    static Code Invalid() { return Code{}; }
+
+    Code():
+        is_valid_(false), protocol_(), address_(), command_()
+    { }
+
+    Code(std::uint8_t address, std::uint8_t command, Protocol protocol = Protocol::NEC):
+        is_valid_(true), protocol_(static_cast<std::uint8_t>(protocol)), address_(address), command_(command)
+    { }
+
+    Code(const Code &) = default;
+    Code & operator =(const Code &) = default;
+
+    bool isValid() const { return is_valid_; }
+    Protocol protocol() const { return static_cast<Protocol>(protocol_); }
+    std::uint8_t address() const { return address_; }
+    std::uint8_t command() const { return command_; }
+
+    friend bool operator ==(const Code & lhs, const Code & rhs)
+    {
+        if (lhs.is_valid_ != rhs.is_valid_)
+            return false;
+        if (!lhs.is_valid_)
+            return true;
+        if (lhs.protocol_ != rhs.protocol_)
+            return false;
+        if (lhs.address_ != rhs.address_)
+            return false;
+        if (lhs.command_ != rhs.command_)
+            return false;
+        return true;
+    }
+
+    friend bool operator !=(const Code & lhs, const Code & rhs)
+    {
+        return ! operator ==(lhs, rhs);
+    }
+
+private:
+    std::uint32_t is_valid_: 8;
+    std::uint32_t protocol_: 8;
+    std::uint32_t address_: 8;
+    std::uint32_t command_: 8;
+};
+
+
+/**
+ * @brief Decoded IR frame
+ */
+struct Frame
+{
+    /** @brief Received code, invalid for NEC repeat frames */
+    Code code;
+    /** @brief Frame only repeats previously received code, the button is being held */
+    bool repeat;
+    /** @brief Microsecond timestamp of the decoding of the frame */
+    std::uint16_t timestamp;
+};
+
+
+/**
+ * @brief Incremental decoder of captured IR symbols
+ *
+ * Each symbol is a pair of bytes: period between two falling edges and width
+ * of the mark (low level) in between, both in multiples of 100 us. Decoded
+ * frames are published into a lock-free mailbox, so the decoder can run in an
+ * interrupt handler. All calls to @ref process() and @ref flush() need to come
+ * from interrupts, which can not preempt each other.
+ */
+class Decoder
+{
+public:
+    /**
+     * @brief Silence after the last falling edge, after which a frame is considered complete
+     *
+     * It is longer than any period within a frame of the supported protocols.
+     * Captured periods equal or longer than this, and periods equal to zero
+     * (counter stopped at overflow), follow the end of a frame.
+     */
+    static const inline std::uint8_t IDLE_TIMEOUT = 140;  // 14 ms
+
+    static const inline std::size_t PULSE_PROTOCOL_COUNT = 2;
+    static const inline std::size_t MANCHESTER_PROTOCOL_COUNT = 2;
+
+    /**
+     * @brief Process captured symbols
+     *
+     * @param data Pairs of period and width
+     * @param length Length of the data in bytes, needs to be an even number
+     * @param timestamp Microsecond timestamp given to the frames completed by the data
+     */
+    void process(const std::uint8_t * data, std::size_t length, std::uint16_t timestamp);
+
+    /**
+     * @brief Complete frames after the line was idle for @ref IDLE_TIMEOUT
+     *
+     * @param trailing_width Width of the last mark, whose period was not captured
+     * @param timestamp Microsecond timestamp given to the completed frames
+     */
+    void flush(std::uint8_t trailing_width, std::uint16_t timestamp);
+
+    /**
+     * @brief Read decoded frame (consumer side)
+     *
+     * @param[out] frame Object receiving the frame
+     *
+     * @return A frame was read
+     */
+    bool read(Frame * frame) { return mailbox_.pop(frame); }
+
+    /**
+     * @brief Get number of decoded frames, which were not read in time
+     */
+    std::uint32_t dropCount() const { return mailbox_.dropCount(); }
+
+private:
+    /**
+     * @brief State of decoder of pulse-distance and pulse-width protocols
+     */
+    struct PulseState
+    {
+        std::uint64_t bits = 0;
+        std::int8_t pos = -1;
+        std::uint8_t last_toggle = 0;
+        Code last_code;
+    };
+
+    /**
+     * @brief State of decoder of Manchester coded protocols
+     */
+    struct ManchesterState
+    {
+        /** @brief Received half-bits, bit `n` is set if the `n`-th half-bit was a mark */
+        std::uint64_t halves = 0;
+        std::uint8_t count = 0;
+        std::uint8_t last_toggle = 0;
+        Code last_code;
+    };
+
+    PulseState pulse_[PULSE_PROTOCOL_COUNT];
+    ManchesterState manchester_[MANCHESTER_PROTOCOL_COUNT];
+    Mailbox<Frame, 8> mailbox_;
+    std::uint16_t timestamp_ = 0;
+
+    void processSymbol(std::uint8_t period, std::uint8_t width);
+};
+
+}  // namespace ir
+}  // namespace driver
+
+
+#endif  // DRIVER_IR_RECEIVER_DECODER_HPP_
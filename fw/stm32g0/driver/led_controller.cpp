@@ -1,6 +1,8 @@
 #include "driver/led_controller.hpp"
 
-#include <algorithm>
+#include "driver/tools/profiler.hpp"
+#include "driver/tools/trace.hpp"
+#include "driver/led_controller/led_data_buffer.hpp"
 
 #include "stm32g0xx_ll_tim.h"
 #include "stm32g0xx_ll_cortex.h"
@@ -13,42 +15,6 @@ namespace driver
 namespace
 {
 
-// T1H = 0.8 us, (0.8us / 1.25us) * (80 - 1) ~= 51
-const std::uint8_t ONE_BIT_LENGTH = 51;
-// T1H = 0.4 us, (0.4us / 1.25us) * (80 - 1) ~= 25
-const std::uint8_t ZERO_BIT_LENGTH = 25;
-
-
-class NibbleBitPatternTable
-{
-public:
-    constexpr NibbleBitPatternTable()
-    {
-        for (std::size_t n = 0; n != 16; ++n)
-            values_[n] = makeNibbleBits(n);
-    }
-
-    std::uint32_t operator [](std::size_t n) const { return values_[n]; }
-
-private:
-     std::uint32_t values_[16];
-
-    static constexpr std::uint32_t makeNibbleBits(std::uint8_t nibble)
-    {
-        std::uint32_t value = 0;
-        for (std::size_t n = 0; n != 4; ++n)
-        {
-            value <<= 8;
-            value |= (nibble & 0x01) ? ONE_BIT_LENGTH : ZERO_BIT_LENGTH;
-            nibble >>= 1;
-        }
-        return value;
-    }
-};
-
-
-const NibbleBitPatternTable NIBBLE_BIT_PATTERN;
-
 enum DmaFlags
 {
     DMA_COMPLETE,
@@ -57,118 +23,6 @@ enum DmaFlags
 };
 
 
-/**
- * @brief Tool used to write bit patterns into a circular buffer
- */
-class BitCircularBuffer
-{
-public:
-    static const inline std::size_t HALF_CAPACITY = LedController::BUFFER_HALF_LENGTH;
-
-    const void * data() const { return buffer_; }
-    std::size_t length() const { return sizeof(buffer_); }
-
-    /**
-     * @brief Read data to bit buffer
-     *
-     * @param half Which half of the buffer to fill
-     * @param data[in] Data to be written in the buffer
-     * @param length Length of the data
-     * @param offset Offset in the data to start reading from
-     *
-     * @return Number of bytes processed from the buffer, the length of the data
-     *         in the buffer is 8 times the returned value
-     * @retval 0 Done writing or insufficient buffer
-     */
-    std::size_t read(std::size_t half, const void * data, std::size_t length, std::size_t offset)
-    {
-        BytePattern * buffer_pos = buffer_ + (half * HALF_CAPACITY);
-        BytePattern * const buffer_end = buffer_pos + HALF_CAPACITY;
-
-        if (0 == offset)
-        {
-            // Synchronization sequence ensures the DMA is synchronized with the
-            // timer. This is only added when starting the transmission.
-            (buffer_pos++)->blank();
-        }
-
-        const std::uint8_t * const data_start = reinterpret_cast<const std::uint8_t *>(data) + offset;
-        const std::uint8_t * const data_end = data_start +
-                std::min<std::size_t>(length - offset, buffer_end - buffer_pos);
-        const std::uint8_t * data_pos = data_start;
-        for (; data_pos != data_end; ++data_pos)
-            (buffer_pos++)->setByte(*data_pos);
-
-        // Fill the rest of the buffer with blank bits, in case we run out of data to send
-        for (; buffer_pos != buffer_end; ++buffer_pos)
-            buffer_pos->blank();
-
-        return data_pos - data_start;
-    }
-
-    /**
-     * @brief Check whether given half-buffer ends with blank bits
-     *
-     * @param half The required half-buffer
-     *
-     * @return Is blank-terminated
-     */
-    bool isBlankTerminated(std::size_t half) const
-    {
-        return (buffer_ + (half * HALF_CAPACITY))[HALF_CAPACITY - 1].isBlank();
-    }
-
-private:
-    class BytePattern
-    {
-    public:
-        void setByte(std::uint8_t value)
-        {
-            upper_ = NIBBLE_BIT_PATTERN[value >> 4];
-            lower_ = NIBBLE_BIT_PATTERN[value & 0xF];
-        }
-
-        void blank() { upper_ = 0; lower_ = 0; }
-        bool isBlank() const { return 0 == lower_; }
-
-    private:
-        std::uint32_t upper_, lower_;
-    };
-
-    BytePattern buffer_[HALF_CAPACITY * 2];
-};
-
-
-/**
- * @brief Simple object keeping track of data to be pushed into LEDs
- */
-class LedDataBuffer
-{
-public:
-    static const inline std::size_t SIZE = LedController::MAX_DATA_LENGTH;
-
-    void start(const LedState * leds, std::size_t count, const LedCorrection * correction)
-    {
-        length_ = correction->correct(leds, count, buffer_, SIZE);
-        pos_ = 0;
-    }
-
-    bool readInto(std::size_t half, BitCircularBuffer * buffer)
-    {
-        const std::size_t done = buffer->read(half, buffer_, length_, pos_);
-        if (0 == done)
-            return false;
-        pos_ += done;
-        return true;
-    }
-
-private:
-    std::uint8_t buffer_[SIZE];
-    std::size_t length_ = 0;
-    std::size_t pos_ = 0;
-};
-
-
 ::TIM_TypeDef * toTimer(TimerId tim_id)
 {
     switch (tim_id)
@@ -204,14 +58,14 @@ std::uint32_t toDmaRequest(TimerId tim_id)
     return 0;
 }
 
-std::uint32_t timerRegisterAddress(::TIM_TypeDef * tim, std::uint32_t channel)
+std::uintptr_t timerRegisterAddress(::TIM_TypeDef * tim, std::uint32_t channel)
 {
     switch (channel)
     {
-    case LL_TIM_CHANNEL_CH1: return reinterpret_cast<std::uint32_t>(&(tim->CCR1));
-    case LL_TIM_CHANNEL_CH2: return reinterpret_cast<std::uint32_t>(&(tim->CCR2));
-    case LL_TIM_CHANNEL_CH3: return reinterpret_cast<std::uint32_t>(&(tim->CCR3));
-    case LL_TIM_CHANNEL_CH4: return reinterpret_cast<std::uint32_t>(&(tim->CCR4));
+    case LL_TIM_CHANNEL_CH1: return reinterpret_cast<std::uintptr_t>(&(tim->CCR1));
+    case LL_TIM_CHANNEL_CH2: return reinterpret_cast<std::uintptr_t>(&(tim->CCR2));
+    case LL_TIM_CHANNEL_CH3: return reinterpret_cast<std::uintptr_t>(&(tim->CCR3));
+    case LL_TIM_CHANNEL_CH4: return reinterpret_cast<std::uintptr_t>(&(tim->CCR4));
     }
     return 0;
 }
@@ -353,7 +207,7 @@ inline void startDma(std::uint32_t dma_channel, const void * data, std::size_t l
 {
     ::LL_DMA_DisableChannel(DMA1, dma_channel);
 
-    ::LL_DMA_SetMemoryAddress(DMA1, dma_channel, reinterpret_cast<std::uint32_t>(data));
+    ::LL_DMA_SetMemoryAddress(DMA1, dma_channel, reinterpret_cast<std::uintptr_t>(data));
     ::LL_DMA_SetDataLength(DMA1, dma_channel, length);
 
     ::LL_DMA_EnableChannel(DMA1, dma_channel);
@@ -413,8 +267,8 @@ struct LedController::Private
     std::uint32_t channel;
     std::uint32_t dma_channel;
 
-    BitCircularBuffer dma_buffer;
-    LedDataBuffer data;
+    led::BitCircularBuffer dma_buffer;
+    led::LedDataBuffer data;
 };
 
 LedController::LedController():
@@ -467,30 +321,54 @@ bool LedController::update(const AbstractLedStrip * led_strip)
     if (isDmaOngoing(priv.dma_channel))
         return false;
 
-    priv.data.start(led_strip->leds, led_strip->led_count, correction_.get());
+    {
+        const Profiler::Scope scope(Profiler::Zone::CORRECTION);
+        priv.data.start(led_strip->leds, led_strip->led_count, correction_.get());
+    }
+    startTransfer();
+    return true;
+}
+
+bool LedController::update(const AbstractIndexedLedStrip * led_strip)
+{
+    auto & priv = *p_;
 
+    if (isDmaOngoing(priv.dma_channel))
+        return false;
+
+    {
+        const Profiler::Scope scope(Profiler::Zone::CORRECTION);
+        priv.data.start(led_strip, correction_.get());
+    }
+    startTransfer();
+    return true;
+}
+
+void LedController::startTransfer()
+{
+    auto & priv = *p_;
+
+    const Profiler::Scope scope(Profiler::Zone::DMA_START);
     if (!priv.data.readInto(0, &priv.dma_buffer))
-        return true;
+        return;
     priv.data.readInto(1, &priv.dma_buffer);
 
     startDma(priv.dma_channel, priv.dma_buffer.data(), priv.dma_buffer.length());
-
-    return true;
 }
 
-void LedController::maybeHandleDmaInterrupt()
+bool LedController::maybeHandleDmaInterrupt()
 {
     auto & priv = *p_;
 
     const std::uint32_t dma_flags = readDmaFlags(priv.dma_channel);
     if (0 == dma_flags)
-        return;
+        return false;
 
     if (dma_flags & (1 << DmaFlags::DMA_ERROR))
     {
         // There is not error handling for now, just stop the DMA
         stopDma(priv.dma_channel);
-        return;
+        return false;
     }
 
     const std::size_t half = (dma_flags & (1 << DmaFlags::DMA_HALF_COMPLETE)) ? 0 : 1;
@@ -501,10 +379,13 @@ void LedController::maybeHandleDmaInterrupt()
         // transmitting was terminated by zeros, i.e. there was no more data to
         // be transmitted.
         stopDma(priv.dma_channel);
-        return;
+        Trace::record(TraceEvent::LED_DMA_DONE);
+        return true;
     }
 
+    Trace::record(TraceEvent::LED_DMA_HALF, half);
     priv.data.readInto(half, &priv.dma_buffer);
+    return false;
 }
 
 void LedController::configure(LedOrder order, std::uint32_t intensity)
@@ -9,6 +9,7 @@
 #include "tools/hidden.hpp"
 #include "driver/common.hpp"
 #include "led_strip.hpp"
+#include "indexed_led_strip.hpp"
 #include "app/led_correction.hpp"
 
 
@@ -56,10 +57,24 @@ public:
      */
     bool update(const AbstractLedStrip * led_strip);
 
+    /**
+     * @brief Initiate LED strip update process from an indexed strip
+     *
+     * The palette is corrected once and expanded into the LED colors while
+     * the data are transferred, so a longer strip fits the data buffer.
+     *
+     * @param[in] led_strip Indexed LED Data to use
+     *
+     * @return Success
+     */
+    bool update(const AbstractIndexedLedStrip * led_strip);
+
     /**
      * @brief Handle the DMA interrupt
+     *
+     * @return The LED strip update was just finished
      */
-    void maybeHandleDmaInterrupt();
+    bool maybeHandleDmaInterrupt();
 
     /**
      * @brief Configure LED driver
@@ -69,11 +84,27 @@ public:
      */
     void configure(LedOrder order, std::uint32_t intensity = DEFAULT_INTENSITY);
 
+    /**
+     * @brief Configure LED driver for a strip chained from different segments
+     *
+     * Indexed strips have a single palette, all their LEDs are written as the
+     * LEDs of the first segment.
+     *
+     * @param segments Segments in the order of the chain, see @ref SegmentedLedCorrection
+     */
+    template <LedWriter... WTs>
+    void configure(const LedSegment<WTs> &... segments)
+    {
+        correction_.create<SegmentedLedCorrection<WTs...>>(segments...);
+    }
+
 private:
-    PolymorphicStorage<LedCorrection, 32> correction_;
+    PolymorphicStorage<LedCorrection, 64> correction_;
 
     struct Private;
-    Hidden<Private, 12 + 4 + (BUFFER_HALF_LENGTH * 16) + 4 + MAX_DATA_LENGTH> p_;
+    Hidden<Private, 12 + 4 + (BUFFER_HALF_LENGTH * 16) + 4 + MAX_DATA_LENGTH + 8> p_;
+
+    void startTransfer();
 };
 
 }  // driver
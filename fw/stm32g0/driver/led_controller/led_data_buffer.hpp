@@ -0,0 +1,246 @@
+/**
+ * @file
+ */
+
+#ifndef DRIVER_LED_CONTROLLER_LED_DATA_BUFFER_HPP_
+#define DRIVER_LED_CONTROLLER_LED_DATA_BUFFER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "driver/led_controller.hpp"
+
+
+namespace driver
+{
+namespace led
+{
+
+// T1H = 0.8 us, (0.8us / 1.25us) * (80 - 1) ~= 51
+const std::uint8_t ONE_BIT_LENGTH = 51;
+// T1H = 0.4 us, (0.4us / 1.25us) * (80 - 1) ~= 25
+const std::uint8_t ZERO_BIT_LENGTH = 25;
+
+
+class NibbleBitPatternTable
+{
+public:
+    constexpr NibbleBitPatternTable()
+    {
+        for (std::size_t n = 0; n != 16; ++n)
+            values_[n] = makeNibbleBits(n);
+    }
+
+    std::uint32_t operator [](std::size_t n) const { return values_[n]; }
+
+private:
+     std::uint32_t values_[16];
+
+    static constexpr std::uint32_t makeNibbleBits(std::uint8_t nibble)
+    {
+        std::uint32_t value = 0;
+        for (std::size_t n = 0; n != 4; ++n)
+        {
+            value <<= 8;
+            value |= (nibble & 0x01) ? ONE_BIT_LENGTH : ZERO_BIT_LENGTH;
+            nibble >>= 1;
+        }
+        return value;
+    }
+};
+
+
+const NibbleBitPatternTable NIBBLE_BIT_PATTERN;
+
+
+/**
+ * @brief Tool used to write bit patterns into a circular buffer
+ */
+class BitCircularBuffer
+{
+public:
+    static const inline std::size_t HALF_CAPACITY = LedController::BUFFER_HALF_LENGTH;
+
+    const void * data() const { return buffer_; }
+    std::size_t length() const { return sizeof(buffer_); }
+
+    /**
+     * @brief Read data to bit buffer
+     *
+     * @param half Which half of the buffer to fill
+     * @param data[in] Data to be written in the buffer
+     * @param length Length of the data
+     * @param offset Offset in the data to start reading from
+     *
+     * @return Number of bytes processed from the buffer, the length of the data
+     *         in the buffer is 8 times the returned value
+     * @retval 0 Done writing or insufficient buffer
+     */
+    std::size_t read(std::size_t half, const void * data, std::size_t length, std::size_t offset)
+    {
+        const std::uint8_t * data_pos = reinterpret_cast<const std::uint8_t *>(data) + offset;
+        return write(half, length - offset, 0 == offset, [&data_pos]() { return *(data_pos++); });
+    }
+
+    /**
+     * @brief Write generated data to bit buffer
+     *
+     * @param half Which half of the buffer to fill
+     * @param remaining Number of bytes the generator has left
+     * @param is_start The transmission starts with this half
+     * @param next_byte Generator of the data bytes
+     *
+     * @return Number of bytes taken from the generator
+     * @retval 0 Done writing or insufficient buffer
+     */
+    template <typename G>
+    std::size_t write(std::size_t half, std::size_t remaining, bool is_start, G && next_byte)
+    {
+        BytePattern * buffer_pos = buffer_ + (half * HALF_CAPACITY);
+        BytePattern * const buffer_end = buffer_pos + HALF_CAPACITY;
+
+        if (is_start)
+        {
+            // Synchronization sequence ensures the DMA is synchronized with the
+            // timer. This is only added when starting the transmission.
+            (buffer_pos++)->blank();
+        }
+
+        const std::size_t count = std::min<std::size_t>(remaining, buffer_end - buffer_pos);
+        for (std::size_t n = 0; n != count; ++n)
+            (buffer_pos++)->setByte(next_byte());
+
+        // Fill the rest of the buffer with blank bits, in case we run out of data to send
+        for (; buffer_pos != buffer_end; ++buffer_pos)
+            buffer_pos->blank();
+
+        return count;
+    }
+
+    /**
+     * @brief Check whether given half-buffer ends with blank bits
+     *
+     * @param half The required half-buffer
+     *
+     * @return Is blank-terminated
+     */
+    bool isBlankTerminated(std::size_t half) const
+    {
+        return (buffer_ + (half * HALF_CAPACITY))[HALF_CAPACITY - 1].isBlank();
+    }
+
+private:
+    class BytePattern
+    {
+    public:
+        void setByte(std::uint8_t value)
+        {
+            upper_ = NIBBLE_BIT_PATTERN[value >> 4];
+            lower_ = NIBBLE_BIT_PATTERN[value & 0xF];
+        }
+
+        void blank() { upper_ = 0; lower_ = 0; }
+        bool isBlank() const { return 0 == lower_; }
+
+    private:
+        std::uint32_t upper_, lower_;
+    };
+
+    BytePattern buffer_[HALF_CAPACITY * 2];
+};
+
+
+/**
+ * @brief Simple object keeping track of data to be pushed into LEDs
+ *
+ * Indexed strips store the corrected palette followed by a copy of the
+ * indices, the colors are expanded while filling the bit buffer.
+ */
+class LedDataBuffer
+{
+public:
+    static const inline std::size_t SIZE = LedController::MAX_DATA_LENGTH;
+
+    void start(const LedState * leds, std::size_t count, const LedCorrection * correction)
+    {
+        index_bits_ = 0;
+        length_ = correction->correct(leds, count, buffer_, SIZE);
+        pos_ = 0;
+    }
+
+    void start(const AbstractIndexedLedStrip * strip, const LedCorrection * correction)
+    {
+        length_ = 0;
+        pos_ = 0;
+        // Indices beyond the palette in use are sent as its first color
+        palette_length_ = std::min<std::uint8_t>(strip->palette_length, AbstractIndexedLedStrip::MAX_PALETTE_LENGTH);
+        const std::size_t palette_size = correction->correctColors(strip->palette, palette_length_, buffer_, SIZE);
+        if (0 == palette_size)
+            return;
+
+        // Indices are copied, so the strip can be rendered during the transfer
+        index_bits_ = strip->index_bits;
+        led_length_ = static_cast<std::uint8_t>(palette_size / palette_length_);
+        const std::size_t indices_length = std::min<std::size_t>(strip->indicesLength(), SIZE - palette_size);
+        std::copy_n(strip->indices, indices_length, buffer_ + palette_size);
+        led_count_ = std::min<std::size_t>(strip->led_count, (indices_length * 8) / index_bits_);
+        length_ = led_count_ * led_length_;
+    }
+
+    bool readInto(std::size_t half, BitCircularBuffer * buffer)
+    {
+        const std::size_t done = 0 == index_bits_ ?
+                buffer->read(half, buffer_, length_, pos_) :
+                readIndexedInto(half, buffer);
+        if (0 == done)
+            return false;
+        pos_ += done;
+        return true;
+    }
+
+private:
+    std::uint8_t buffer_[SIZE];
+    std::size_t length_ = 0;
+    std::size_t pos_ = 0;
+
+    std::size_t led_count_ = 0;
+    /** @brief Width of the indices, zero when the buffer holds corrected LEDs */
+    std::uint8_t index_bits_ = 0;
+    std::uint8_t led_length_ = 0;
+    std::uint8_t palette_length_ = 0;
+
+    const std::uint8_t * paletteColor(std::size_t led) const
+    {
+        if (led >= led_count_)
+            return buffer_;
+        const std::uint8_t * const indices = buffer_ + (palette_length_ * led_length_);
+        const std::uint8_t index = 8 == index_bits_ ?
+                indices[led] : ((indices[led >> 1] >> ((led & 0x01) << 2)) & 0x0F);
+        return buffer_ + ((index < palette_length_ ? index : 0) * led_length_);
+    }
+
+    std::size_t readIndexedInto(std::size_t half, BitCircularBuffer * buffer) const
+    {
+        std::size_t led = pos_ / led_length_;
+        std::size_t component = pos_ % led_length_;
+        const std::uint8_t * color = paletteColor(led);
+        return buffer->write(half, length_ - pos_, 0 == pos_,
+            [&]()
+            {
+                const std::uint8_t value = color[component];
+                if (led_length_ == ++component)
+                {
+                    component = 0;
+                    color = paletteColor(++led);
+                }
+                return value;
+            });
+    }
+};
+
+}  // namespace led
+}  // namespace driver
+
+
+#endif  // DRIVER_LED_CONTROLLER_LED_DATA_BUFFER_HPP_
@@ -0,0 +1,77 @@
+/**
+ * @file
+ */
+
+#ifndef DRIVER_TOOLS_LATENCY_HISTOGRAM_HPP_
+#define DRIVER_TOOLS_LATENCY_HISTOGRAM_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace driver
+{
+
+/**
+ * @brief Histogram of latencies with logarithmic buckets
+ *
+ * Bucket `n` counts latencies in interval [2^n, 2^(n+1)) microseconds, bucket 0
+ * also counts zero latencies.
+ */
+class LatencyHistogram
+{
+public:
+    using Latency = std::uint16_t;
+
+    static const inline std::size_t BUCKET_COUNT = 16;
+
+    void record(Latency latency)
+    {
+        ++buckets_[bucketOf(latency)];
+        ++count_;
+        if (latency < min_)
+            min_ = latency;
+        if (latency > max_)
+            max_ = latency;
+    }
+
+    void clear()
+    {
+        *this = LatencyHistogram{};
+    }
+
+    std::uint32_t bucket(std::size_t n) const { return buckets_[n]; }
+    std::uint32_t count() const { return count_; }
+    Latency min() const { return min_; }
+    Latency max() const { return max_; }
+
+    /**
+     * @brief Get the lowest latency counted in given bucket
+     */
+    static constexpr std::uint32_t bucketStart(std::size_t n)
+    {
+        return 0 == n ? 0 : (std::uint32_t{1} << n);
+    }
+
+private:
+    std::uint32_t buckets_[BUCKET_COUNT] = {};
+    std::uint32_t count_ = 0;
+    Latency min_ = 0xFFFF;
+    Latency max_ = 0;
+
+    static std::size_t bucketOf(Latency latency)
+    {
+        std::size_t n = 0;
+        while (latency > 1)
+        {
+            latency >>= 1;
+            ++n;
+        }
+        return n;
+    }
+};
+
+}  // namespace driver
+
+
+#endif  // DRIVER_TOOLS_LATENCY_HISTOGRAM_HPP_
@@ -0,0 +1,160 @@
+/**
+ * @file
+ */
+
+#ifndef DRIVER_TOOLS_PROFILER_HPP_
+#define DRIVER_TOOLS_PROFILER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "driver/tools/latency_histogram.hpp"
+
+#ifdef STM32G0
+#   include "driver/cpu_usage.hpp"
+#endif  // STM32G0
+
+// The simulator runs the code natively, without advancing the simulated
+// counters, the zones are timed by the host clock there
+#if defined(STM32G0) && !defined(SIMULATOR)
+#   define PROFILER_CPU_USAGE
+#else
+#   include <chrono>
+#endif
+
+
+namespace driver
+{
+
+/**
+ * @brief Profiler measuring durations of the stages of a frame
+ *
+ * Every zone keeps a histogram and a rolling mean of its durations in a fixed
+ * table. The profiler is compiled in only if `PROFILER` is defined (build with
+ * `PROFILE=yes`), otherwise the zones compile to nothing.
+ *
+ * In the firmware, the durations are measured by the microsecond counter of
+ * @ref CpuUsage, in the simulator and the other host builds by the steady
+ * clock.
+ */
+class Profiler
+{
+public:
+    using Timestamp = std::uint16_t;
+
+    enum class Zone: std::uint8_t
+    {
+        INPUT_UPDATE,
+        EVENT_HANDLING,
+        MUSIC,
+        RENDER,
+        MODIFIER,
+        CORRECTION,
+        DMA_START,
+
+        ZONE_COUNT_,
+    };
+
+    static const inline std::size_t ZONE_COUNT = static_cast<std::size_t>(Zone::ZONE_COUNT_);
+
+    /**
+     * @brief Object measuring a zone from its construction until its destruction
+     */
+    class Scope
+    {
+    public:
+#ifdef PROFILER
+        explicit Scope(Zone zone):
+            zone_(zone),
+            start_(now())
+        { }
+
+        ~Scope()
+        {
+            record(zone_, now() - start_);
+        }
+
+    private:
+        Zone zone_;
+        Timestamp start_;
+#else
+        explicit Scope(Zone zone)
+        {
+            (void) zone;
+        }
+#endif  // PROFILER
+    };
+
+#ifdef STM32G0
+    /**
+     * @brief Use the microsecond counter of the CPU usage driver
+     */
+    static void initialize(const CpuUsage * cpu_usage)
+    {
+#   if defined(PROFILER) && defined(PROFILER_CPU_USAGE)
+        cpu_usage_ = cpu_usage;
+#   else
+        (void) cpu_usage;
+#   endif
+    }
+#endif  // STM32G0
+
+#ifdef PROFILER
+    struct ZoneStats
+    {
+        LatencyHistogram histogram;
+        /** @brief Rolling mean in 1/2^MEAN_FILTER_SHIFT microseconds */
+        std::uint32_t mean;
+
+        std::uint32_t meanUs() const { return mean >> MEAN_FILTER_SHIFT; }
+    };
+
+    /** @brief Weight of a new duration in the rolling mean is 1/2^MEAN_FILTER_SHIFT */
+    static const inline std::uint32_t MEAN_FILTER_SHIFT = 4;
+
+#   ifdef PROFILER_CPU_USAGE
+    static Timestamp now()
+    {
+        return nullptr == cpu_usage_ ? 0 : cpu_usage_->timestamp();
+    }
+#   else
+    static Timestamp now()
+    {
+        const auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<Timestamp>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+#   endif  // PROFILER_CPU_USAGE
+
+    static void record(Zone zone, Timestamp duration)
+    {
+        ZoneStats & stats = zones_[static_cast<std::size_t>(zone)];
+        if (0 == stats.histogram.count())
+            stats.mean = static_cast<std::uint32_t>(duration) << MEAN_FILTER_SHIFT;
+        else
+            stats.mean = stats.mean - (stats.mean >> MEAN_FILTER_SHIFT) + duration;
+        stats.histogram.record(duration);
+    }
+
+    static const ZoneStats & stats(Zone zone)
+    {
+        return zones_[static_cast<std::size_t>(zone)];
+    }
+
+    static void clear()
+    {
+        for (auto & stats : zones_)
+            stats = ZoneStats{};
+    }
+
+private:
+    static inline ZoneStats zones_[ZONE_COUNT] = {};
+#   ifdef PROFILER_CPU_USAGE
+    static inline const CpuUsage * cpu_usage_ = nullptr;
+#   endif  // PROFILER_CPU_USAGE
+#endif  // PROFILER
+};
+
+}  // namespace driver
+
+
+#endif  // DRIVER_TOOLS_PROFILER_HPP_
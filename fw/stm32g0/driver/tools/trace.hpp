@@ -0,0 +1,154 @@
+/**
+ * @file
+ */
+
+#ifndef DRIVER_TOOLS_TRACE_HPP_
+#define DRIVER_TOOLS_TRACE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef STM32G0
+#   include "driver/tools/irq.hpp"
+#   include "stm32g0xx_ll_tim.h"
+#else
+#   include <atomic>
+#   include <chrono>
+#endif  // STM32G0
+
+
+namespace driver
+{
+
+/**
+ * @brief Identifiers of the trace events
+ *
+ * The host-side decoder (`tool/trace_decode.py`) reads the names of the events
+ * from this enumeration, keep one event per line.
+ */
+enum class TraceEvent: std::uint8_t
+{
+    NONE = 0,
+    FRAME_START,  /**< Payload: lower 16 bits of the step time in milliseconds */
+    FRAME_DROPPED,  /**< Payload: number of skipped steps, 0 if the LED DMA was still busy */
+    LED_DMA_HALF,  /**< Payload: half of the buffer, which was just sent */
+    LED_DMA_DONE,  /**< Payload: none */
+    BUZZER_DMA,  /**< Payload: half of the buffer to be refilled */
+    I2C_DONE,  /**< Payload: device address in upper byte, transaction status in lower byte */
+    IR_SYMBOL,  /**< Payload: period in upper byte, mark width in lower byte, in 100 us units */
+    SLOT_CHANGE,  /**< Payload: ID of the new animation slot */
+};
+
+
+/**
+ * @brief Trace of events kept in a ring buffer in the RAM
+ *
+ * Events are recorded from the main loop and from interrupts. Every event
+ * reserves its entry by incrementing a single word (with interrupts masked for
+ * the increment only on the Cortex-M0+, which has no atomic read-modify-write
+ * instructions), then it fills the entry without any locking. The first word
+ * of the ring is a magic number, so the ring can be found in a memory dump and
+ * decoded by `tool/trace_decode.py`.
+ *
+ * Timestamps are values of the free running microsecond counter, which wraps
+ * at 16 bits. Steps are traced every few milliseconds, which lets the decoder
+ * reconstruct the time.
+ *
+ * Builds defining `NO_TRACE` record nothing. Host benchmarks use it, the clock
+ * read of each entry would take longer than the code being measured.
+ */
+class Trace
+{
+public:
+    static const inline std::uint32_t MAGIC = 0x31435254;  // "TRC1"
+    static const inline std::size_t CAPACITY_BITS = 7;
+    static const inline std::size_t CAPACITY = std::size_t{1} << CAPACITY_BITS;
+#ifdef NO_TRACE
+    static const inline bool ENABLED = false;
+#else
+    static const inline bool ENABLED = true;
+#endif  // NO_TRACE
+
+    struct Entry
+    {
+        std::uint16_t timestamp;
+        std::uint16_t payload;
+        TraceEvent event;
+        /** @brief Lower bits of the number of times the ring was wrapped, when the entry was written */
+        std::uint8_t lap;
+    };
+
+    /**
+     * @brief Record an event
+     *
+     * Can be called from an interrupt handler.
+     *
+     * @param event Event to record
+     * @param payload Payload of the event
+     */
+    static void record(TraceEvent event, std::uint16_t payload = 0)
+    {
+        if (!ENABLED)
+            return;
+        const std::uint32_t index = reserve();
+        Entry & entry = ring_.entries[index & (CAPACITY - 1)];
+        entry.timestamp = timestamp();
+        entry.payload = payload;
+        entry.event = event;
+        entry.lap = static_cast<std::uint8_t>(index >> CAPACITY_BITS);
+    }
+
+    /**
+     * @brief Get the raw ring, e.g. to save it from host builds
+     */
+    static const void * data() { return &ring_; }
+    static std::size_t size() { return sizeof(Ring); }
+
+private:
+    struct Ring
+    {
+        std::uint32_t magic;
+        std::uint16_t capacity;
+        std::uint16_t entry_size;
+#ifdef STM32G0
+        /** @brief Number of entries reserved so far */
+        volatile std::uint32_t head;
+#else
+        std::atomic<std::uint32_t> head;
+#endif  // STM32G0
+        Entry entries[CAPACITY];
+    };
+
+    static inline Ring ring_ = {MAGIC, CAPACITY, sizeof(Entry), 0, {}};
+
+#ifdef STM32G0
+    static std::uint32_t reserve()
+    {
+        const IrqGuard guard;
+        const std::uint32_t index = ring_.head;
+        ring_.head = index + 1;
+        return index;
+    }
+
+    static std::uint16_t timestamp()
+    {
+        return ::LL_TIM_GetCounter(TIM6);
+    }
+#else
+    static std::uint32_t reserve()
+    {
+        return ring_.head.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::uint16_t timestamp()
+    {
+        const auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<std::uint16_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+#endif  // STM32G0
+};
+
+}  // namespace driver
+
+
+#endif  // DRIVER_TOOLS_TRACE_HPP_
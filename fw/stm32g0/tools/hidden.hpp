@@ -10,10 +10,25 @@
 #include <new>
 
 
+#ifdef SIMULATOR
+/**
+ * @brief Host builds of the firmware (`tool/sim`) have wider pointers, so the
+ *        storage is doubled and the type only needs to fit in it
+ */
+static const inline std::size_t HIDDEN_SIZE_FACTOR = 2;
+
+template <typename T, std::size_t SZ, std::size_t AL>
+concept CompleteHiddenType =
+    sizeof(T) <= SZ &&  // Type does not fit the storage
+    alignof(T) <= AL;  // Type exceeds alignment
+#else
+static const inline std::size_t HIDDEN_SIZE_FACTOR = 1;
+
 template <typename T, std::size_t SZ, std::size_t AL>
 concept CompleteHiddenType =
     sizeof(T) == SZ &&  // Type does not fit the storage
     alignof(T) <= AL;  // Type exceeds alignment
+#endif  // SIMULATOR
 
 
 template <typename T, std::size_t SZ, std::size_t AL = alignof(void *)>
@@ -22,7 +37,7 @@ class Hidden
 public:
     using Type = T;
     static const inline std::size_t ALIGN = AL;
-    static const inline std::size_t SIZE = SZ;
+    static const inline std::size_t SIZE = SZ * HIDDEN_SIZE_FACTOR;
 
     Type * get() { return reinterpret_cast<Type *>(&storage_); }
     const Type * get() const { return reinterpret_cast<const Type *>(&storage_); }
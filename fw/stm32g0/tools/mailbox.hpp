@@ -0,0 +1,107 @@
+/**
+ * @file
+ */
+
+#ifndef TOOLS_MAILBOX_HPP_
+#define TOOLS_MAILBOX_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <type_traits>
+
+
+/**
+ * @brief Lock-free single-producer single-consumer queue of small values
+ *
+ * The producer is typically an interrupt handler and the consumer is the main
+ * loop.
+ *
+ * @tparam T Type of the stored values
+ * @tparam N Capacity of the mailbox, needs to be a power of two
+ */
+template <typename T, std::size_t N>
+class Mailbox
+{
+public:
+    static_assert(0 != N && 0 == (N & (N - 1)), "Mailbox capacity needs to be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "Mailbox values need to be trivially copyable");
+
+    static const inline std::size_t CAPACITY = N;
+
+    /**
+     * @brief Store a value in the mailbox (producer side)
+     *
+     * @param value Value to store
+     *
+     * @return Success
+     * @retval false Mailbox is full, the value was counted as dropped
+     */
+    bool push(const T & value)
+    {
+        const std::uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N)
+        {
+            drop_count_.store(drop_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        items_[head % N] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest value from the mailbox (consumer side)
+     *
+     * @param[out] value Object receiving the value
+     *
+     * @return A value was taken
+     */
+    bool pop(T * value)
+    {
+        const std::uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail)
+            return false;
+
+        *value = items_[tail % N];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get the oldest value without taking it (consumer side)
+     *
+     * @return Pointer to the value, valid until it is taken
+     * @retval nullptr The mailbox is empty
+     */
+    const T * peek() const
+    {
+        const std::uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail)
+            return nullptr;
+        return &items_[tail % N];
+    }
+
+    /**
+     * @brief Remove all values (consumer side)
+     */
+    void clear()
+    {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    /**
+     * @brief Get number of values, which did not fit in the mailbox
+     */
+    std::uint32_t dropCount() const { return drop_count_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint32_t> head_ = 0;
+    std::atomic<std::uint32_t> tail_ = 0;
+    std::atomic<std::uint32_t> drop_count_ = 0;
+    T items_[N];
+};
+
+
+#endif  // TOOLS_MAILBOX_HPP_
@@ -0,0 +1,160 @@
+/**
+ * @file
+ */
+
+#ifndef TOOLS_PERFECT_HASH_MAP_HPP_
+#define TOOLS_PERFECT_HASH_MAP_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+
+
+/**
+ * @brief Read-only map of 24-bit keys to 8-bit values using a perfect hash
+ *
+ * The map is meant to be built by a constexpr constructor, so it is placed in
+ * flash. It uses hash-and-displace: keys are distributed into buckets by their
+ * hash, and every bucket is assigned an 8-bit seed, which moves all its keys to
+ * distinct free slots. Lookup computes two hashes and compares one slot.
+ *
+ * Every slot stores the key and the value packed in a single word, the map
+ * therefore takes `4 * SLOT_COUNT + BUCKET_COUNT` bytes.
+ *
+ * @tparam N Number of entries
+ */
+template <std::size_t N>
+class PerfectHashMap
+{
+public:
+    struct Entry
+    {
+        std::uint32_t key;
+        std::uint8_t value;
+    };
+
+    static const inline std::uint32_t MAX_KEY = 0x00FFFFFEu;
+    static const inline std::size_t SLOT_COUNT = std::bit_ceil(N + (N / 4) + 1);
+    static const inline std::size_t BUCKET_COUNT = std::bit_ceil((N + 1) / 2);
+
+    /**
+     * @brief Build the map
+     *
+     * Use @ref isValid() in a `static_assert` to check the map could be built:
+     * it fails on duplicate keys and keys above @ref MAX_KEY.
+     *
+     * @param entries Entries of the map
+     */
+    constexpr explicit PerfectHashMap(const Entry (& entries)[N]):
+        seeds_(), slots_()
+    {
+        for (auto & slot : slots_)
+            slot = EMPTY_SLOT;
+        for (const auto & entry : entries)
+        {
+            if (entry.key > MAX_KEY)
+                return;
+        }
+
+        std::size_t bucket_size[BUCKET_COUNT] = {};
+        for (const auto & entry : entries)
+            ++bucket_size[bucketOf(mix(entry.key))];
+
+        // Place the largest buckets first, while there are many free slots
+        for (std::size_t size = N; size != 0; --size)
+        {
+            for (std::size_t bucket = 0; bucket != BUCKET_COUNT; ++bucket)
+            {
+                if (size == bucket_size[bucket] && !placeBucket(entries, bucket))
+                    return;
+            }
+        }
+        valid_ = true;
+    }
+
+    constexpr bool isValid() const { return valid_; }
+
+    /**
+     * @brief Find value of a key
+     *
+     * @param key Key to look for
+     * @param fallback Value returned if the key is not in the map
+     *
+     * @return Value of the key or @p fallback
+     */
+    constexpr std::uint8_t find(std::uint32_t key, std::uint8_t fallback) const
+    {
+        const std::uint32_t hash = mix(key);
+        const std::uint32_t slot = slots_[slotOf(hash, seeds_[bucketOf(hash)])];
+        return (slot >> 8) == key ? static_cast<std::uint8_t>(slot) : fallback;
+    }
+
+private:
+    static const inline std::uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+    static const inline std::size_t MAX_SEED = 0xFF;
+
+    std::uint8_t seeds_[BUCKET_COUNT];
+    std::uint32_t slots_[SLOT_COUNT];
+    bool valid_ = false;
+
+    static constexpr std::uint32_t mix(std::uint32_t value)
+    {
+        value ^= value >> 16;
+        value *= 0x7FEB352Du;
+        value ^= value >> 15;
+        value *= 0x846CA68Bu;
+        value ^= value >> 16;
+        return value;
+    }
+
+    static constexpr std::size_t bucketOf(std::uint32_t hash)
+    {
+        return hash & (BUCKET_COUNT - 1);
+    }
+
+    static constexpr std::size_t slotOf(std::uint32_t hash, std::uint8_t seed)
+    {
+        return mix(hash ^ (static_cast<std::uint32_t>(seed) << 24)) & (SLOT_COUNT - 1);
+    }
+
+    constexpr bool placeBucket(const Entry (& entries)[N], std::size_t bucket)
+    {
+        for (std::size_t seed = 0; seed <= MAX_SEED; ++seed)
+        {
+            if (tryPlaceBucket(entries, bucket, static_cast<std::uint8_t>(seed)))
+            {
+                seeds_[bucket] = static_cast<std::uint8_t>(seed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr bool tryPlaceBucket(const Entry (& entries)[N], std::size_t bucket, std::uint8_t seed)
+    {
+        std::size_t placed[N] = {};
+        std::size_t placed_cnt = 0;
+
+        for (const auto & entry : entries)
+        {
+            const std::uint32_t hash = mix(entry.key);
+            if (bucket != bucketOf(hash))
+                continue;
+
+            const std::size_t slot = slotOf(hash, seed);
+            if (EMPTY_SLOT != slots_[slot])
+            {
+                // Collision with this or other bucket, roll back
+                for (std::size_t n = 0; n != placed_cnt; ++n)
+                    slots_[placed[n]] = EMPTY_SLOT;
+                return false;
+            }
+            slots_[slot] = (entry.key << 8) | entry.value;
+            placed[placed_cnt++] = slot;
+        }
+        return true;
+    }
+};
+
+
+#endif  // TOOLS_PERFECT_HASH_MAP_HPP_
@@ -17,6 +17,14 @@ struct TypeTag
 };
 
 
+#ifdef SIMULATOR
+/** @brief Host builds of the firmware (`tool/sim`) have wider pointers */
+static const inline std::size_t POLYMORPHIC_STORAGE_SIZE_FACTOR = 2;
+#else
+static const inline std::size_t POLYMORPHIC_STORAGE_SIZE_FACTOR = 1;
+#endif  // SIMULATOR
+
+
 template <typename T, typename I, std::size_t MAX_S, std::size_t MAX_A>
 concept PolymorphicStorageType =
         sizeof(T) <= MAX_S &&  // Type does not fit the storage
@@ -37,7 +45,7 @@ public:
     /** @brief Interface represented by the object */
     using Interface = I;
 
-    static inline const std::size_t MAX_SIZE = MAX_S;
+    static inline const std::size_t MAX_SIZE = MAX_S * POLYMORPHIC_STORAGE_SIZE_FACTOR;
     static inline const std::size_t MAX_ALIGN = MAX_A;
 
     PolymorphicStorage()
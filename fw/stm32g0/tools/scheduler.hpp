@@ -0,0 +1,156 @@
+/**
+ * @file
+ */
+
+#ifndef TOOLS_SCHEDULER_HPP_
+#define TOOLS_SCHEDULER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * @brief Cooperative scheduler of periodic tasks with deadlines
+ *
+ * Tasks are released on a fixed grid of their periods. Tasks are listed in
+ * the order of their priority, the first task has the highest priority. When
+ * several tasks are due, the one with the highest priority runs first; a
+ * running task is never interrupted by another one.
+ *
+ * A task finishing later than its deadline after its release is counted as
+ * an overrun. Releases missed because of an overrun are skipped and counted
+ * as catch-ups, the task is not run several times in a row to make up for
+ * them.
+ *
+ * @tparam N Number of tasks
+ */
+template <std::size_t N>
+class Scheduler
+{
+public:
+    /**
+     * @brief Function running the task
+     *
+     * @param time Release time of the task in milliseconds
+     */
+    using Handler = void (*)(std::uint32_t time);
+
+    /**
+     * @brief Function getting the current time in milliseconds
+     */
+    using Clock = std::uint32_t (*)();
+
+    struct Task
+    {
+        Handler handler;
+        /** @brief Period in milliseconds */
+        std::uint16_t period;
+        /** @brief Time since release until the task has to finish in milliseconds */
+        std::uint16_t deadline;
+    };
+
+    struct TaskStats
+    {
+        std::uint32_t runs;
+        std::uint32_t overruns;
+        std::uint32_t catch_ups;
+        /** @brief Longest time since release until the task finished in milliseconds */
+        std::uint16_t max_response;
+    };
+
+    /**
+     * @param tasks Tasks in the order of their priority
+     * @param clock Source of the current time
+     */
+    Scheduler(const Task (& tasks)[N], Clock clock):
+        tasks_(tasks),
+        clock_(clock)
+    { }
+
+    /**
+     * @brief Release all tasks now
+     *
+     * @param time Current time in milliseconds
+     */
+    void start(std::uint32_t time)
+    {
+        for (auto & release : releases_)
+            release = time;
+    }
+
+    /**
+     * @brief Check whether some of the tasks is due
+     *
+     * @param time Current time in milliseconds
+     */
+    bool isDue(std::uint32_t time) const
+    {
+        return N != nextDue(time);
+    }
+
+    /**
+     * @brief Run the due task with the highest priority
+     *
+     * @param time Current time in milliseconds
+     *
+     * @return A task was run
+     */
+    bool runNext(std::uint32_t time)
+    {
+        const std::size_t id = nextDue(time);
+        if (N == id)
+            return false;
+
+        const Task & task = tasks_[id];
+        TaskStats & stats = stats_[id];
+        const std::uint32_t release = releases_[id];
+
+        task.handler(release);
+
+        const std::uint32_t finish = clock_();
+        const std::uint32_t response = finish - release;
+        ++stats.runs;
+        if (response > task.deadline)
+            ++stats.overruns;
+        if (response > stats.max_response)
+            stats.max_response = response > 0xFFFF ? 0xFFFF : static_cast<std::uint16_t>(response);
+
+        // Skip the releases, which were already missed
+        std::uint32_t next = release + task.period;
+        if (static_cast<std::int32_t>(finish - next) >= static_cast<std::int32_t>(task.period))
+        {
+            const std::uint32_t missed = (finish - next) / task.period;
+            stats.catch_ups += missed;
+            next += missed * task.period;
+        }
+        releases_[id] = next;
+        return true;
+    }
+
+    const TaskStats & stats(std::size_t id) const { return stats_[id]; }
+
+    void clearStats()
+    {
+        for (auto & stats : stats_)
+            stats = TaskStats{};
+    }
+
+private:
+    const Task (& tasks_)[N];
+    const Clock clock_;
+    std::uint32_t releases_[N] = {};
+    TaskStats stats_[N] = {};
+
+    std::size_t nextDue(std::uint32_t time) const
+    {
+        for (std::size_t id = 0; id != N; ++id)
+        {
+            if (static_cast<std::int32_t>(time - releases_[id]) >= 0)
+                return id;
+        }
+        return N;
+    }
+};
+
+
+#endif  // TOOLS_SCHEDULER_HPP_
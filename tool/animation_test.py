@@ -1,60 +1,28 @@
 from abc import ABC, abstractmethod
-from math import ceil, floor
+from math import ceil, prod
 from struct import Struct
 from itertools import chain
 from functools import partial
 import argparse
 import tkinter as tk
 from tkinter import ttk
-import time
 from typing import Any, Tuple, Iterable
 import animations
 
 
-class PeriodicTimer:
-    __slots__ = '_start',
-
-    NOT_ELAPSED = 0
-    DONE = 1
-    MORE_PENDING = 2
-
-    @staticmethod
-    def _time() -> int:
-        return floor(time.perf_counter() * 1000.0) & 0xFFFFFFFF
-
-    def __init__(self):
-        self._start = self._time()
-
-    def reset(self, diff: int = 0) -> None:
-        self._start = self._time() + diff
-
-    def has_elapsed(self, period: int) -> int:
-        diff = (self._time() - self._start) & 0xFFFFFFFF
-        if diff < period:
-            return self.NOT_ELAPSED
-        self._start = (self._start + period) & 0xFFFFFFFF
-        return self.DONE if diff < (2 * period) else self.MORE_PENDING
-
-
-Color = animations.LedState
-
-
-def blend(first: Color, second: Color, num: int, den: int) -> Color:
-    POINT_POS = 16
-    secondary_blend = (num << POINT_POS) // den
-    primary_blend = (1 << POINT_POS) - secondary_blend
-    return Color(
-        (first.red * primary_blend + second.red * secondary_blend) >> POINT_POS,
-        (first.green * primary_blend + second.green * secondary_blend) >> POINT_POS,
-        (first.blue * primary_blend + second.blue * secondary_blend) >> POINT_POS,
-    )
-
-
 class Animation(ABC):
     @abstractmethod
     def render(self, lights: animations.LedStrip):
         pass
 
+    @abstractmethod
+    def start(self):
+        pass
+
+    @abstractmethod
+    def poll(self, lights: animations.LedStrip) -> int:
+        pass
+
     @abstractmethod
     def get_parameter(self, param_id: int) -> int | None:
         pass
@@ -85,6 +53,14 @@ class ColorGridModel(ABC):
     def render(self, lights: animations.LedStrip) -> int:
         pass
 
+    @abstractmethod
+    def start(self):
+        pass
+
+    @abstractmethod
+    def poll(self, lights: animations.LedStrip) -> int | None:
+        pass
+
     @abstractmethod
     def reset(self):
         pass
@@ -96,8 +72,7 @@ class ColorGridModel(ABC):
 
 class ColorGridView:
     _ROW_LENGTH = 20
-    _POLLING_INTERVAL = 3  # ms (must be shorter than actual animation interval)
-    _INTERVAL = 8  # ms
+    _POLLING_INTERVAL = 3  # ms (must be shorter than animations.AnimationPlayer.DEFAULT_PERIOD)
     _BAD_PARAM_VALUE = -9999
 
 
@@ -107,7 +82,6 @@ class ColorGridView:
         self._root.title("Color Grid Application")
         self._led_strip = animations.LedStrip()
         self._is_playing = False
-        self._periodic_timer = PeriodicTimer()
 
         style = ttk.Style()
 
@@ -227,7 +201,7 @@ class ColorGridView:
     def _on_play(self):
         if not self._is_playing:
             self._is_playing = True
-            self._periodic_timer.reset(-self._INTERVAL)  # Ensure the frame is immediately rendered
+            self._model.start()  # Ensure the frame is immediately rendered
             self._on_animate()
         else:
             self._is_playing = False
@@ -241,12 +215,10 @@ class ColorGridView:
     def _on_animate(self):
         if self._is_playing:
             self._root.after(self._POLLING_INTERVAL, self._on_animate)
-            while True:
-                timer_result = self._periodic_timer.has_elapsed(self._INTERVAL)
-                if PeriodicTimer.NOT_ELAPSED == timer_result:
-                    break
-                # Only render the frame onto the GUI when current frame is last one for the time
-                self._render_frame(do_update=(PeriodicTimer.DONE == timer_result))
+            # Frames are timed by the native player, only the last one of the poll is shown
+            count = self._model.poll(self._led_strip)
+            if count is not None:
+                self._update_view(count)
 
     def _reload(self):
         if not self._is_playing:
@@ -260,24 +232,24 @@ class ColorGridView:
             return
         self._param_var.set(value)
 
-    def _render_frame(self, do_update: bool = True):
-        count = self._model.render(self._led_strip)
-        if do_update:
-            self._update_lights()
-            self._frame_counter.set(count)
-            self._update_status()
+    def _render_frame(self):
+        self._update_view(self._model.render(self._led_strip))
+
+    def _update_view(self, count: int):
+        self._update_lights()
+        self._frame_counter.set(count)
+        self._update_status()
 
     def _update_status(self):
-        colors = " ".join(
-            f"#{color.red:02X}{color.green:02X}{color.blue:02X}" for color in (self._led_strip[n] for n in range(9))
-        )
+        data = memoryview(self._led_strip).tobytes()
+        colors = " ".join(f"#{data[3 * n:3 * (n + 1)].hex().upper()}" for n in range(9))
         anim_status = self._model.animation().status()
         self._set_status("\n".join((anim_status, colors)) if len(anim_status) > 0 else colors)
 
     def _update_lights(self):
+        data = memoryview(self._led_strip).tobytes()
         for light_id, circle in enumerate(self._light_circles):
-            color = self._led_strip[light_id]
-            self._canvas.itemconfig(circle, fill=f"#{color.red:02x}{color.green:02x}{color.blue:02x}")
+            self._canvas.itemconfig(circle, fill=f"#{data[3 * light_id:3 * (light_id + 1)].hex()}")
 
     def _set_status(self, text: str):
         self._status_txt.config(state=tk.NORMAL)
@@ -382,10 +354,17 @@ class NativeAnimation(Animation):
         self._storage = animations.AnimationStorage()
         self._storage.change(anim_id)
         self._anim = self._storage.get()
+        self._player = animations.AnimationPlayer(self._storage)
 
     def render(self, lights):
         self._anim.render(lights)
 
+    def start(self):
+        self._player.start()
+
+    def poll(self, lights) -> int:
+        return self._player.poll(lights)
+
     def get_parameter(self, param_id: int) -> int | None:
         return self._anim.get_parameter(param_id)
 
@@ -430,6 +409,16 @@ class MyModel(ColorGridModel):
         self._animation.render(lights)
         return frame_id
 
+    def start(self):
+        self._animation.start()
+
+    def poll(self, lights: animations.LedStrip) -> int | None:
+        frames = self._animation.poll(lights)
+        if 0 == frames:
+            return None
+        self._count += frames
+        return self._count - 1
+
     def reset(self):
         self._animation.reset()
         self._count = 0
@@ -438,15 +427,111 @@ class MyModel(ColorGridModel):
         return self._animation
 
 
+def check_render_frames(frame_count: int = 16) -> bool:
+    """Check the frames of render_frames against frames rendered one at a time
+
+    Animations drawing random numbers share the generator, only the shape of
+    their frames is checked.
+    """
+    random_slots = set(chain(
+        range(animations.AnimationSlotName.TWINKLE.value, animations.AnimationSlotName.TWINKLE_LAST.value + 1),
+        range(animations.AnimationSlotName.LIGHTS.value, animations.AnimationSlotName.LIGHTS_LAST.value + 1)))
+    strip = animations.LedStrip()
+    frame_size = len(strip) * 3
+    is_ok = True
+
+    for anim_id in range(animations.AnimationStorage.SLOT_COUNT):
+        batch_storage = animations.AnimationStorage()
+        batch_storage.change(anim_id)
+        frames = memoryview(bytearray(frame_count * frame_size)).cast('B', (frame_count, len(strip), 3))
+        rendered = batch_storage.get().render_frames(strip, frames)
+        data = frames.tobytes()
+        if rendered != frame_count or data[-frame_size:] != memoryview(strip).tobytes():
+            print(f"{NativeAnimation.name(anim_id)}: {rendered} frames, last one differs from the LED strip")
+            is_ok = False
+            continue
+        if anim_id in random_slots:
+            continue
+
+        storage = animations.AnimationStorage()
+        storage.change(anim_id)
+        for frame in range(frame_count):
+            storage.get().render(strip)
+            if data[frame * frame_size:(frame + 1) * frame_size] != memoryview(strip).tobytes():
+                print(f"{NativeAnimation.name(anim_id)}: frame {frame} differs")
+                is_ok = False
+                break
+
+    storage = animations.AnimationStorage()
+    storage.change(0)
+    animation = storage.get()
+    for shape in ((1, len(strip) + 1, 3), (1, len(strip), 4), (len(strip), 3)):
+        try:
+            animation.render_frames(strip, memoryview(bytearray(prod(shape))).cast('B', shape))
+            print(f"Buffer of shape {shape} was accepted")
+            is_ok = False
+        except RuntimeError:
+            pass
+
+    if is_ok:
+        print(f"render_frames matches {frame_count} frames of {animations.AnimationStorage.SLOT_COUNT} slots")
+    return is_ok
+
+
+def check_color_bindings() -> bool:
+    """Check the color helpers and the LED corrections against their definitions"""
+    strip = animations.LedStrip()
+    for led_id in range(len(strip)):
+        strip[led_id].red, strip[led_id].green, strip[led_id].blue = led_id, 2 * led_id, 255 - led_id
+    leds = memoryview(strip).tobytes()
+    checks = []
+
+    for correction, expected in (
+            (animations.RgbCorrection(), leds),
+            (animations.GrbCorrection(), bytes(chain.from_iterable(
+                (leds[n + 1], leds[n], leds[n + 2]) for n in range(0, len(leds), 3)))),
+            (animations.DimmingRgbCorrection(128), bytes(v >> 1 for v in leds))):
+        data = bytearray(len(leds))
+        checks.append((f"{type(correction).__name__} writes the LED data",
+            correction.correct(strip, data) == len(leds) and data == expected))
+    checks.append(("A correction writes whole LEDs into a short buffer",
+        animations.RgbCorrection().correct(strip, bytearray(10)) == 9))
+
+    red = animations.get_color(animations.ColorId.RED)
+    blue = animations.get_color(animations.ColorId.BLUE)
+    checks.append(("LedState keeps the hex color", animations.LedState(0x123456).color == 0x123456))
+    checks.append(("Blending none of the secondary color keeps the color",
+        animations.blend_colors(red, blue, 0, 4) == red))
+    checks.append(("Blending all of the secondary color gives it",
+        animations.blend_colors(red, blue, 4, 4) == blue))
+    checks.append(("The hue wraps around", animations.increment_hue(animations.MAX_HUE) == 0))
+    try:
+        animations.blend_colors(red, blue, 1, 0)
+        checks.append(("Blending with zero denominator is rejected", False))
+    except ValueError:
+        pass
+
+    for name, is_ok in checks:
+        if not is_ok:
+            print(f"Failed: {name}")
+    if not all(is_ok for _, is_ok in checks):
+        return False
+    print(f"{len(checks)} checks of the color helpers and corrections pass")
+    return True
+
+
 _ARGS = argparse.ArgumentParser(description="Animation tester")
 _ARGS.add_argument('-a', '--animation', help='Animation to select after start', type=int, required=False, default=0)
+_ARGS.add_argument('--check', help='Check the module bindings without opening the window', action='store_true')
 
 
 if __name__ == "__main__":
+    args = _ARGS.parse_args()
+    if args.check:
+        raise SystemExit(0 if all((check_render_frames(), check_color_bindings())) else 1)
     root = tk.Tk()
     style = ttk.Style()
     style.theme_use('alt')
     app = ColorGridView(root, MyModel())
-    args = _ARGS.parse_args()
     app.change_animation(args.animation)
     root.mainloop()
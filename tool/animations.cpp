@@ -1,5 +1,8 @@
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <string>
@@ -11,12 +14,132 @@
 
 #include "app/animation.hpp"
 #include "app/animation_storage.hpp"
+#include "app/led_correction.hpp"
+#include "app/tools/color.hpp"
 #include "led_strip.hpp"
 
 
 namespace py = pybind11;
 
 
+namespace
+{
+
+static_assert(sizeof(LedState) == 3, "LED states need to be packed RGB triplets");
+
+using RgbCorrection = CommonLedCorrection<StandardLedWriter<ComponentWriterRGB>>;
+using GrbCorrection = CommonLedCorrection<StandardLedWriter<ComponentWriterGRB>>;
+using DimmingRgbCorrection = CommonLedCorrection<DimmingLedWriter<ComponentWriterRGB>>;
+using DimmingGrbCorrection = CommonLedCorrection<DimmingLedWriter<ComponentWriterGRB>>;
+
+
+/**
+ * @brief Render the current animation of a storage in real time
+ *
+ * Steps the animation with a fixed period as `Lights` does, so the preview
+ * runs at the frame rate of the firmware.
+ */
+class AnimationPlayer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief Render period of the firmware, see `Lights::STEP_PERIOD` */
+    static const inline std::uint32_t DEFAULT_PERIOD = 8;
+    static const inline std::uint32_t DEFAULT_MAX_FRAMES = 16;
+
+    AnimationPlayer(AnimationStorage * storage, std::uint32_t period_ms, std::uint32_t max_frames):
+        storage_(storage),
+        period_(std::chrono::milliseconds(period_ms)),
+        max_frames_(max_frames),
+        next_(Clock::now())
+    { }
+
+    /**
+     * @brief Make the next frame due immediately
+     */
+    void start()
+    {
+        next_ = Clock::now();
+    }
+
+    /**
+     * @brief Render all the frames, which are due
+     *
+     * When more than the maximal number of frames is due, the rest is skipped.
+     *
+     * @return Number of rendered frames
+     */
+    std::size_t poll(AbstractLedStrip * strip)
+    {
+        const auto now = Clock::now();
+        std::size_t frames = 0;
+        for (; next_ <= now; next_ += period_)
+        {
+            if (max_frames_ == frames)
+            {
+                next_ = now + period_;
+                break;
+            }
+            (*storage_)->render(strip, {});
+            ++frames;
+        }
+        frame_count_ += frames;
+        return frames;
+    }
+
+    std::uint64_t frameCount() const { return frame_count_; }
+
+private:
+    AnimationStorage * storage_;
+    Clock::duration period_;
+    std::size_t max_frames_;
+    Clock::time_point next_;
+    std::uint64_t frame_count_ = 0;
+};
+
+/**
+ * @brief Render frames into a `(frames, leds, 3)` buffer of bytes
+ *
+ * @return Number of rendered frames
+ */
+std::size_t renderFrames(Animation * animation, AbstractLedStrip * strip, py::buffer b)
+{
+    const py::buffer_info info = b.request(true);
+    if (info.ndim != 3 || info.itemsize != 1 || info.format != py::format_descriptor<std::uint8_t>::format() ||
+            info.shape[1] != strip->led_count || info.shape[2] != 3)
+        throw std::runtime_error("Expected (frames, leds, 3) buffer of uint8");
+
+    const auto frames = static_cast<std::size_t>(info.shape[0]);
+    const bool is_contiguous = info.strides[2] == 1 && info.strides[1] == 3 &&
+            info.strides[0] == static_cast<py::ssize_t>(strip->led_count * 3);
+    auto * const data = static_cast<std::uint8_t *>(info.ptr);
+
+    py::gil_scoped_release release;
+    for (std::size_t frame = 0; frame != frames; ++frame)
+    {
+        animation->render(strip, {});
+        std::uint8_t * const frame_data = data + (static_cast<py::ssize_t>(frame) * info.strides[0]);
+        if (is_contiguous)
+        {
+            std::memcpy(frame_data, strip->leds, strip->led_count * 3);
+            continue;
+        }
+        for (LedSize led = 0; led != strip->led_count; ++led)
+        {
+            std::uint8_t * const led_data = frame_data + (led * info.strides[1]);
+            led_data[0] = strip->leds[led].red;
+            led_data[info.strides[2]] = strip->leds[led].green;
+            led_data[2 * info.strides[2]] = strip->leds[led].blue;
+        }
+    }
+    return frames;
+}
+
+}  // namespace
+
+
+
 PYBIND11_MODULE(animations, m)
 {
     py::enum_<Animation::DataType>(m, "DataType")
@@ -34,14 +157,62 @@ PYBIND11_MODULE(animations, m)
 
         .def_readwrite("red", &LedState::red)
         .def_readwrite("green", &LedState::green)
-        .def_readwrite("blue", &LedState::blue);
+        .def_readwrite("blue", &LedState::blue)
+
+        .def_property_readonly("color", &LedState::color)
+
+        .def("__eq__", +[](const LedState & self, const LedState & other) { return self == other; },
+            py::arg("other"))
+
+        .def("__repr__", +[](const LedState & self) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "LedState(0x%06X)", static_cast<unsigned>(self.color()));
+            return std::string(text); });
 
 
-    py::class_<AbstractLedStrip>(m, "LedStrip")
+    m.attr("MAX_HUE") = MAX_HUE;
+
+    py::enum_<ColorId>(m, "ColorId")
+        .value("BLACK", ColorId::BLACK)
+        .value("WHITE", ColorId::WHITE)
+        .value("WARM_WHITE", ColorId::WARM_WHITE)
+        .value("RED", ColorId::RED)
+        .value("GREEN", ColorId::GREEN)
+        .value("YELLOW", ColorId::YELLOW)
+        .value("BLUE", ColorId::BLUE)
+        .value("TEAL", ColorId::TEAL)
+        .value("PINK", ColorId::PINK);
+
+    m.def("get_color", +[](ColorId color_id) { return getColor(color_id); }, py::arg("color_id"));
+
+    m.def("blend_colors", +[](LedState color, const LedState & secondary, std::uint16_t num, std::uint16_t den) {
+        if (0 == den)
+            throw py::value_error("Denominator must not be zero");
+        blendColors(&color, secondary, num, den);
+        return color; },
+        py::arg("color"), py::arg("secondary"), py::arg("num"), py::arg("den"),
+        "Blend num/den of the secondary color into the color");
+
+    m.def("to_saturated_hue", +[](std::uint16_t hue) {
+        LedState color;
+        toSaturatedHue(hue, &color);
+        return color; }, py::arg("hue"));
+
+    m.def("increment_hue", &incrementHue, py::arg("hue"), py::arg("value") = 1);
+
+
+    py::class_<AbstractLedStrip>(m, "LedStrip", py::buffer_protocol())
         .def(py::init<>([]() {
             return (new LedStrip<100>())->abstractPtr(); }),
             py::return_value_policy::take_ownership)
 
+        // Zero-copy `(leds, 3)` view of the LED colors, e.g. `memoryview(strip)`
+        .def_buffer([](AbstractLedStrip & ls) {
+            return py::buffer_info(
+                ls.leds, sizeof(std::uint8_t), py::format_descriptor<std::uint8_t>::format(), 2,
+                {static_cast<py::ssize_t>(ls.led_count), py::ssize_t{3}},
+                {static_cast<py::ssize_t>(sizeof(LedState)), py::ssize_t{1}}); })
+
         .def_readonly("led_count", &AbstractLedStrip::led_count)
 
         .def("__len__", +[](AbstractLedStrip * ls) { return ls->led_count; })
@@ -53,6 +224,30 @@ PYBIND11_MODULE(animations, m)
             py::return_value_policy::reference_internal, py::arg("led_id"));
 
 
+    py::class_<LedCorrection>(m, "LedCorrection")
+        .def("correct", +[](const LedCorrection * self, const AbstractLedStrip & strip, py::buffer b) {
+            const py::buffer_info info = b.request(true);
+            if (info.ndim != 1 || info.itemsize != 1)
+                throw std::runtime_error("Expected 1D buffer of bytes (itemsize=1)");
+            py::gil_scoped_release release;
+            return self->correct(strip.leds, strip.led_count, static_cast<std::uint8_t *>(info.ptr),
+                static_cast<std::size_t>(info.size)); },
+            py::arg("led_strip"), py::arg("buffer"),
+            "Write the data sent to the LEDs into the buffer, return the number of written bytes");
+
+    py::class_<RgbCorrection, LedCorrection>(m, "RgbCorrection")
+        .def(py::init<>());
+
+    py::class_<GrbCorrection, LedCorrection>(m, "GrbCorrection")
+        .def(py::init<>());
+
+    py::class_<DimmingRgbCorrection, LedCorrection>(m, "DimmingRgbCorrection")
+        .def(py::init<std::uint32_t>(), py::arg("intensity"));
+
+    py::class_<DimmingGrbCorrection, LedCorrection>(m, "DimmingGrbCorrection")
+        .def(py::init<std::uint32_t>(), py::arg("intensity"));
+
+
     py::class_<Animation>(m, "Animation")
         .def("get_parameter", &Animation::getParameter, py::arg("param_id"))
 
@@ -74,7 +269,12 @@ PYBIND11_MODULE(animations, m)
             py::arg("buffer"), py::arg("type"))
 
         .def("render", +[](Animation * self, AbstractLedStrip & strip) {
-            self->render(&strip, {}); }, py::arg("led_strip"));
+            self->render(&strip, {}); }, py::arg("led_strip"))
+
+        .def("render_frames", +[](Animation * self, AbstractLedStrip & strip, py::buffer frames) {
+            return renderFrames(self, &strip, frames); },
+            py::arg("led_strip"), py::arg("frames"),
+            "Render as many frames as the first dimension of the (frames, leds, 3) uint8 buffer");
 
 
     py::class_<AnimationStorage>(m, "AnimationStorage")
@@ -94,6 +294,23 @@ PYBIND11_MODULE(animations, m)
         .def("get", py::overload_cast<>(&AnimationStorage::get),
             py::return_value_policy::reference_internal);
 
+
+    py::class_<AnimationPlayer>(m, "AnimationPlayer")
+        .def_readonly_static("DEFAULT_PERIOD", &AnimationPlayer::DEFAULT_PERIOD)
+
+        .def(py::init<AnimationStorage *, std::uint32_t, std::uint32_t>(),
+            py::arg("storage"), py::arg("period_ms") = AnimationPlayer::DEFAULT_PERIOD,
+            py::arg("max_frames") = AnimationPlayer::DEFAULT_MAX_FRAMES, py::keep_alive<1, 2>())
+
+        .def("start", &AnimationPlayer::start)
+
+        .def("poll", +[](AnimationPlayer * self, AbstractLedStrip & strip) {
+            py::gil_scoped_release release;
+            return self->poll(&strip); },
+            py::arg("led_strip"), "Render the frames due since the last poll, return their number")
+
+        .def_property_readonly("frame_count", &AnimationPlayer::frameCount);
+
     using AnimationSlotName = AnimationStorage::AnimationSlotName;
     py::enum_<AnimationStorage::AnimationSlotName>(m, "AnimationSlotName")
         .value("COLOR", AnimationSlotName::ANIM_SLOT_COLOR)
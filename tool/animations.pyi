@@ -1,18 +1,35 @@
 from __future__ import annotations
 import collections.abc
 import typing
-__all__: list[str] = ['Animation', 'AnimationSlotName', 'AnimationStorage', 'DataType', 'LedState', 'LedStrip']
+__all__: list[str] = ['Animation', 'AnimationPlayer', 'AnimationSlotName', 'AnimationStorage', 'ColorId', 'DataType', 'DimmingGrbCorrection', 'DimmingRgbCorrection', 'GrbCorrection', 'LedCorrection', 'LedState', 'LedStrip', 'MAX_HUE', 'RgbCorrection', 'blend_colors', 'get_color', 'increment_hue', 'to_saturated_hue']
 class Animation:
     def get_parameter(self, param_id: typing.SupportsInt) -> int | None:
         ...
     def render(self, led_strip: LedStrip) -> None:
         ...
+    def render_frames(self, led_strip: LedStrip, frames: collections.abc.Buffer) -> int:
+        """
+        Render as many frames as the first dimension of the (frames, leds, 3) uint8 buffer
+        """
     def restore(self, buffer: collections.abc.Buffer, type: DataType) -> int:
         ...
     def set_parameter(self, param_id: typing.SupportsInt, value: typing.SupportsInt) -> bool:
         ...
     def store(self, buffer: collections.abc.Buffer, type: DataType) -> int:
         ...
+class AnimationPlayer:
+    DEFAULT_PERIOD: typing.ClassVar[int] = 8
+    def __init__(self, storage: AnimationStorage, period_ms: typing.SupportsInt = 8, max_frames: typing.SupportsInt = 16) -> None:
+        ...
+    def poll(self, led_strip: LedStrip) -> int:
+        """
+        Render the frames due since the last poll, return their number
+        """
+    def start(self) -> None:
+        ...
+    @property
+    def frame_count(self) -> int:
+        ...
 class AnimationSlotName:
     """
     Members:
@@ -94,6 +111,64 @@ class AnimationStorage:
         ...
     def slot_id(self) -> int:
         ...
+class ColorId:
+    """
+    Members:
+    
+      BLACK
+    
+      WHITE
+    
+      WARM_WHITE
+    
+      RED
+    
+      GREEN
+    
+      YELLOW
+    
+      BLUE
+    
+      TEAL
+    
+      PINK
+    """
+    BLACK: typing.ClassVar[ColorId]  # value = <ColorId.BLACK: 0>
+    BLUE: typing.ClassVar[ColorId]  # value = <ColorId.BLUE: 6>
+    GREEN: typing.ClassVar[ColorId]  # value = <ColorId.GREEN: 4>
+    PINK: typing.ClassVar[ColorId]  # value = <ColorId.PINK: 8>
+    RED: typing.ClassVar[ColorId]  # value = <ColorId.RED: 3>
+    TEAL: typing.ClassVar[ColorId]  # value = <ColorId.TEAL: 7>
+    WARM_WHITE: typing.ClassVar[ColorId]  # value = <ColorId.WARM_WHITE: 2>
+    WHITE: typing.ClassVar[ColorId]  # value = <ColorId.WHITE: 1>
+    YELLOW: typing.ClassVar[ColorId]  # value = <ColorId.YELLOW: 5>
+    __members__: typing.ClassVar[dict[str, ColorId]]  # value = {'BLACK': <ColorId.BLACK: 0>, 'WHITE': <ColorId.WHITE: 1>, 'WARM_WHITE': <ColorId.WARM_WHITE: 2>, 'RED': <ColorId.RED: 3>, 'GREEN': <ColorId.GREEN: 4>, 'YELLOW': <ColorId.YELLOW: 5>, 'BLUE': <ColorId.BLUE: 6>, 'TEAL': <ColorId.TEAL: 7>, 'PINK': <ColorId.PINK: 8>}
+    def __eq__(self, other: typing.Any) -> bool:
+        ...
+    def __getstate__(self) -> int:
+        ...
+    def __hash__(self) -> int:
+        ...
+    def __index__(self) -> int:
+        ...
+    def __init__(self, value: typing.SupportsInt) -> None:
+        ...
+    def __int__(self) -> int:
+        ...
+    def __ne__(self, other: typing.Any) -> bool:
+        ...
+    def __repr__(self) -> str:
+        ...
+    def __setstate__(self, state: typing.SupportsInt) -> None:
+        ...
+    def __str__(self) -> str:
+        ...
+    @property
+    def name(self) -> str:
+        ...
+    @property
+    def value(self) -> int:
+        ...
 class DataType:
     """
     Members:
@@ -131,7 +206,23 @@ class DataType:
     @property
     def value(self) -> int:
         ...
+class DimmingGrbCorrection(LedCorrection):
+    def __init__(self, intensity: typing.SupportsInt) -> None:
+        ...
+class DimmingRgbCorrection(LedCorrection):
+    def __init__(self, intensity: typing.SupportsInt) -> None:
+        ...
+class GrbCorrection(LedCorrection):
+    def __init__(self) -> None:
+        ...
+class LedCorrection:
+    def correct(self, led_strip: LedStrip, buffer: collections.abc.Buffer) -> int:
+        """
+        Write the data sent to the LEDs into the buffer, return the number of written bytes
+        """
 class LedState:
+    def __eq__(self, other: LedState) -> bool:
+        ...
     @typing.overload
     def __init__(self) -> None:
         ...
@@ -141,6 +232,8 @@ class LedState:
     @typing.overload
     def __init__(self, hex_color: typing.SupportsInt) -> None:
         ...
+    def __repr__(self) -> str:
+        ...
     @property
     def blue(self) -> int:
         ...
@@ -148,6 +241,9 @@ class LedState:
     def blue(self, arg0: typing.SupportsInt) -> None:
         ...
     @property
+    def color(self) -> int:
+        ...
+    @property
     def green(self) -> int:
         ...
     @green.setter
@@ -160,6 +256,8 @@ class LedState:
     def red(self, arg0: typing.SupportsInt) -> None:
         ...
 class LedStrip:
+    def __buffer__(self, flags: int, /) -> memoryview:
+        ...
     def __getitem__(self, led_id: typing.SupportsInt) -> LedState:
         ...
     def __init__(self) -> None:
@@ -169,3 +267,17 @@ class LedStrip:
     @property
     def led_count(self) -> int:
         ...
+class RgbCorrection(LedCorrection):
+    def __init__(self) -> None:
+        ...
+def blend_colors(color: LedState, secondary: LedState, num: typing.SupportsInt, den: typing.SupportsInt) -> LedState:
+    """
+    Blend num/den of the secondary color into the color
+    """
+def get_color(color_id: ColorId) -> LedState:
+    ...
+def increment_hue(hue: typing.SupportsInt, value: typing.SupportsInt = 1) -> int:
+    ...
+def to_saturated_hue(hue: typing.SupportsInt) -> LedState:
+    ...
+MAX_HUE: int = 767
@@ -0,0 +1,89 @@
+#include "bench.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "led_strip.hpp"
+#include "app/animation_storage.hpp"
+#include "app/led_correction.hpp"
+
+
+namespace
+{
+
+const std::size_t DEFAULT_FRAMES = 10000;
+
+/** @brief Correction used by the firmware for the default LED order */
+using Correction = CommonLedCorrection<DimmingLedWriter<ComponentWriterRGB>>;
+const std::uint32_t INTENSITY = 0x60;
+
+/**
+ * @brief Measure all animation slots on a strip of given length
+ *
+ * @tparam LED_C Number of LEDs of the strip
+ */
+template <LedSize LED_C>
+void runStrip(std::size_t frames, bench::Results * results)
+{
+    static LedStrip<LED_C> strip;
+    static std::uint8_t data[LED_C * Correction::LedWriterType::LED_LENGTH];
+    const Correction correction(INTENSITY);
+
+    AnimationStorage storage;
+    storage.initialize();
+    for (std::size_t slot = 0; slot != AnimationStorage::SLOT_COUNT; ++slot)
+    {
+        storage.change(static_cast<AnimationStorage::AnimationSlotId>(slot));
+
+        // Let the animation reach its steady state before measuring
+        for (std::size_t n = 0; n != 64; ++n)
+            storage->render(strip.abstractPtr(), {});
+
+        const double render_ns = bench::measure(frames, [&](std::size_t n)
+            {
+                (void) n;
+                storage->render(strip.abstractPtr(), {});
+                bench::keep(strip);
+            });
+
+        const double correction_ns = bench::measure(frames, [&](std::size_t n)
+            {
+                (void) n;
+                bench::keep(correction.correct(strip.leds, LED_C, data, sizeof(data)));
+                bench::keep(data);
+            });
+
+        char serialized[AnimationStorage::Register::MAX_STATE_SIZE];
+        const std::size_t serialized_size = storage->store(serialized, sizeof(serialized),
+                Animation::DataType::BOTH);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "animation/slot_%02zu/leds_%u", slot, static_cast<unsigned>(LED_C));
+        results->push_back({name, frames, render_ns, {
+            {"state_bytes", static_cast<double>(storage.animationSize())},
+            {"serialized_bytes", static_cast<double>(serialized_size)},
+            {"correction_ns_per_frame", correction_ns},
+            {"render_ns_per_led", render_ns / LED_C},
+        }});
+    }
+}
+
+}  // namespace
+
+
+bench::Results bench::runAnimation(const Args & args)
+{
+    std::size_t frames = DEFAULT_FRAMES;
+    if (!args.empty())
+        frames = std::strtoul(args.front().c_str(), nullptr, 0);
+    if (0 == frames)
+        frames = DEFAULT_FRAMES;
+
+    Results results;
+    runStrip<30>(frames, &results);
+    runStrip<100>(frames, &results);
+    runStrip<300>(frames, &results);
+    return results;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file
+ */
+
+#ifndef BENCH_HPP_
+#define BENCH_HPP_
+
+#include <cstddef>
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+namespace bench
+{
+
+/**
+ * @brief Additional named value reported by a benchmark case
+ */
+struct Metric
+{
+    std::string name;
+    double value;
+};
+
+/**
+ * @brief Result of a single benchmark case
+ */
+struct Result
+{
+    std::string name;
+    std::size_t iterations;
+    double ns_per_iteration;
+    std::vector<Metric> metrics = {};
+};
+
+using Results = std::vector<Result>;
+
+/**
+ * @brief Arguments passed to a benchmark suite
+ */
+using Args = std::vector<std::string>;
+
+/**
+ * @brief Measure average duration of a callable
+ *
+ * @param iterations Number of times to call the callable
+ * @param fn Callable to measure
+ *
+ * @return Average duration of single call in nanoseconds
+ */
+template <typename F>
+double measure(std::size_t iterations, F && fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n != iterations; ++n)
+        fn(n);
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations);
+}
+
+/**
+ * @brief Prevent the compiler from optimizing out a value
+ */
+template <typename T>
+inline void keep(const T & value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+Results runAnimation(const Args & args);
+Results runInput(const Args & args);
+Results runIr(const Args & args);
+
+}  // namespace bench
+
+
+#endif  // BENCH_HPP_
@@ -0,0 +1,74 @@
+#include "bench.hpp"
+
+#include "app/input.hpp"
+#include "app/event_queue.hpp"
+
+
+namespace
+{
+
+/**
+ * @brief Input source reporting a fixed set of keys as pressed
+ */
+class ScriptedSource final:
+        public Input::Source
+{
+public:
+    ScriptedSource(const Input::PressedButtonList * keys):
+        keys_(keys)
+    { }
+
+    void getPressedKeys(std::uint32_t time, Input::PressedButtonList * buttons) final
+    {
+        (void) time;
+        const auto * pos = keys_->list();
+        const auto * const end = pos + keys_->count();
+        for (; pos != end; ++pos)
+            buttons->addKey(pos->key_id, pos->is_new);
+    }
+
+private:
+    const Input::PressedButtonList * const keys_;
+};
+
+static_assert(Input::KEY_COUNT <= Input::SOURCE_COUNT * Input::PressedButtonList::MAX_LENGTH,
+        "Sources can not hold all the keys");
+
+/**
+ * @brief Measure the update with the first keys held, spread over all the sources
+ */
+bench::Result runCase(const char * name, std::size_t key_count)
+{
+    static const std::size_t ITERATIONS = 1000000;
+
+    Input::PressedButtonList keys[Input::SOURCE_COUNT];
+    for (std::size_t n = 0; n != key_count; ++n)
+        keys[n / Input::PressedButtonList::MAX_LENGTH].addKey(static_cast<Input::KeyId>(n));
+
+    Input input;
+    for (std::size_t source = 0; source != Input::SOURCE_COUNT; ++source)
+        input.createSource<ScriptedSource>(source, &keys[source]);
+    EventQueue queue;
+
+    const double ns = bench::measure(ITERATIONS, [&](std::size_t n)
+        {
+            input.update(n * 8, static_cast<std::uint16_t>(n), &queue);
+            const auto [events, count] = queue.peek();
+            bench::keep(events);
+            queue.release(count);
+        });
+    return {name, ITERATIONS, ns};
+}
+
+}  // namespace
+
+
+bench::Results bench::runInput(const Args & args)
+{
+    (void) args;
+    return {
+        runCase("input/idle", 0),
+        runCase("input/one_key_held", 1),
+        runCase("input/all_keys_held", Input::KEY_COUNT),
+    };
+}
@@ -0,0 +1,525 @@
+#include "bench.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <random>
+
+#include "driver/ir_receiver.hpp"
+#include "driver/ir_receiver/decoder.hpp"
+#include "driver/ir_receiver/capture_buffer.hpp"
+
+
+namespace
+{
+
+using driver::ir::Code;
+using driver::ir::Decoder;
+using driver::ir::Frame;
+using driver::ir::Protocol;
+
+/**
+ * @brief Mark (carrier present, receiver output low) followed by a space, in microseconds
+ */
+struct Pulse
+{
+    std::uint32_t mark;
+    std::uint32_t space;
+};
+
+using Signal = std::vector<Pulse>;
+
+/**
+ * @brief Single key press: the signal and the codes it is expected to carry
+ */
+struct Press
+{
+    Signal signal;
+    Code code;
+    std::size_t frames = 0;
+    std::size_t repeat_codes = 0;
+    /** @brief Number of pulses of the first frame */
+    std::size_t frame_pulses = 0;
+};
+
+
+const std::uint32_t TICK_US = 100;
+const std::uint32_t COUNTER_OVERFLOW_US = 256 * TICK_US;
+
+
+/**
+ * @brief Model of the capture timer, the DMA and the interrupts of IrReceiver
+ */
+class Replay
+{
+public:
+    static const inline std::size_t BUFFER_LENGTH = driver::IrReceiver::BUFFER_LENGTH;
+
+    explicit Replay(Decoder * decoder):
+        decoder_(decoder)
+    { }
+
+    void feed(const Signal & signal)
+    {
+        for (const auto & pulse: signal)
+        {
+            // Falling edge starting this mark transfers symbol of the previous one
+            capture(last_period_, last_width_);
+
+            const std::uint32_t period = pulse.mark + pulse.space;
+            time_us_ += period;
+            last_width_ = std::min<std::uint32_t>(pulse.mark / TICK_US, 0xFF);
+            last_period_ = (period >= COUNTER_OVERFLOW_US) ? 0 : period / TICK_US;
+
+            if (period >= Decoder::IDLE_TIMEOUT * TICK_US)
+                interrupt(true);
+        }
+    }
+
+    std::size_t symbols() const { return symbols_; }
+    std::size_t interrupts() const { return interrupts_; }
+    double totalNs() const { return total_ns_; }
+    double worstNs() const { return worst_ns_; }
+    std::size_t worstSymbols() const { return worst_symbols_; }
+
+    double percentileNs(double percentile) const
+    {
+        if (samples_.empty())
+            return 0.0;
+        auto samples = samples_;
+        const auto pos = samples.begin() + static_cast<std::ptrdiff_t>(percentile * (samples.size() - 1) / 100.0);
+        std::nth_element(samples.begin(), pos, samples.end());
+        return *pos;
+    }
+
+private:
+    Decoder * const decoder_;
+    driver::ir::CaptureBuffer<BUFFER_LENGTH> buffer_;
+    std::size_t write_pos_ = 0;
+
+    // Counter is stopped at start-up, first capture reads as zero
+    std::uint8_t last_period_ = 0;
+    std::uint8_t last_width_ = 0;
+    /** @brief Time of the signal, timestamps the decoded frames */
+    std::uint32_t time_us_ = 0;
+
+    std::size_t symbols_ = 0;
+    std::size_t interrupts_ = 0;
+    double total_ns_ = 0;
+    double worst_ns_ = 0;
+    std::size_t worst_symbols_ = 0;
+    std::vector<double> samples_;
+
+    void capture(std::uint8_t period, std::uint8_t width)
+    {
+        auto * const data = static_cast<std::uint8_t *>(buffer_.buffer());
+        data[write_pos_] = period;
+        data[write_pos_ + 1] = width;
+        write_pos_ += 2;
+        ++symbols_;
+
+        // Half-transfer and transfer-complete interrupts
+        if (BUFFER_LENGTH / 2 == write_pos_)
+            interrupt(false);
+        else if (BUFFER_LENGTH == write_pos_)
+        {
+            write_pos_ = 0;
+            interrupt(false);
+        }
+    }
+
+    void interrupt(bool is_idle)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::size_t symbols = 0;
+        while (true)
+        {
+            const auto [data, length] = buffer_.peek(BUFFER_LENGTH - write_pos_);
+            if (0 == length)
+                break;
+            decoder_->process(data, length, static_cast<std::uint16_t>(time_us_));
+            buffer_.process(length);
+            symbols += length / 2;
+        }
+        if (is_idle)
+            decoder_->flush(last_width_, static_cast<std::uint16_t>(time_us_));
+
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        ++interrupts_;
+        total_ns_ += ns;
+        samples_.push_back(ns);
+        if (ns > worst_ns_)
+        {
+            worst_ns_ = ns;
+            worst_symbols_ = symbols;
+        }
+    }
+};
+
+
+/**
+ * @brief Convert bits into a pulse-distance or pulse-width coded frame
+ */
+void appendPulseBits(Signal * signal, std::uint32_t bits, std::size_t count, Pulse zero, Pulse one)
+{
+    for (std::size_t n = 0; n != count; ++n)
+        signal->push_back(((bits >> n) & 1) ? one : zero);
+}
+
+/**
+ * @brief Convert half-bits (true for mark) into a signal
+ */
+void appendHalves(Signal * signal, const std::vector<bool> & halves, std::uint32_t unit, std::uint32_t gap)
+{
+    std::size_t pos = 0;
+    while (pos != halves.size() && !halves[pos])
+        ++pos;
+    while (pos != halves.size())
+    {
+        Pulse pulse = {0, 0};
+        for (; pos != halves.size() && halves[pos]; ++pos)
+            pulse.mark += unit;
+        for (; pos != halves.size() && !halves[pos]; ++pos)
+            pulse.space += unit;
+        if (pos == halves.size())
+            pulse.space += gap;
+        signal->push_back(pulse);
+    }
+}
+
+void appendManchester(std::vector<bool> * halves, bool bit, bool mark_first_is_one, std::size_t width = 1)
+{
+    const bool first = (bit == mark_first_is_one);
+    halves->insert(halves->end(), width, first);
+    halves->insert(halves->end(), width, !first);
+}
+
+Press makeNec(std::uint8_t address, std::uint8_t command, std::size_t repeats)
+{
+    Press press;
+    press.code = Code(address, command, Protocol::NEC);
+    press.frames = 1;
+    press.repeat_codes = repeats;
+
+    const std::uint32_t bits = address | (std::uint32_t{static_cast<std::uint8_t>(~address)} << 8) |
+            (std::uint32_t{command} << 16) | (std::uint32_t{static_cast<std::uint8_t>(~command)} << 24);
+    press.signal.push_back({9000, 4500});
+    appendPulseBits(&press.signal, bits, 32, {562, 563}, {562, 1688});
+    press.signal.push_back({562, 40000});
+    press.frame_pulses = press.signal.size();
+    for (std::size_t n = 0; n != repeats; ++n)
+    {
+        press.signal.push_back({9000, 2250});
+        press.signal.push_back({562, 96000});
+    }
+    return press;
+}
+
+Press makeSirc(std::uint8_t address, std::uint8_t command, std::size_t frames)
+{
+    Press press;
+    press.code = Code(address & 0x1F, command & 0x7F, Protocol::SIRC);
+    press.frames = frames;
+
+    const std::uint32_t bits = (command & 0x7F) | ((address & 0x1F) << 7);
+    for (std::size_t n = 0; n != frames; ++n)
+    {
+        press.signal.push_back({2400, 600});
+        appendPulseBits(&press.signal, bits, 12, {600, 600}, {1200, 600});
+        press.signal.back().space += 25000;
+        if (0 == press.frame_pulses)
+            press.frame_pulses = press.signal.size();
+    }
+    return press;
+}
+
+Press makeRc5(std::uint8_t address, std::uint8_t command, bool toggle, std::size_t frames)
+{
+    Press press;
+    press.code = Code(address & 0x1F, command & 0x7F, Protocol::RC5);
+    press.frames = frames;
+
+    for (std::size_t n = 0; n != frames; ++n)
+    {
+        std::vector<bool> halves;
+        appendManchester(&halves, true, false);
+        appendManchester(&halves, 0 == (command & 0x40), false);
+        appendManchester(&halves, toggle, false);
+        for (int bit = 4; bit >= 0; --bit)
+            appendManchester(&halves, (address >> bit) & 1, false);
+        for (int bit = 5; bit >= 0; --bit)
+            appendManchester(&halves, (command >> bit) & 1, false);
+        appendHalves(&press.signal, halves, 889, 89000);
+        if (0 == press.frame_pulses)
+            press.frame_pulses = press.signal.size();
+    }
+    return press;
+}
+
+Press makeRc6(std::uint8_t address, std::uint8_t command, bool toggle, std::size_t frames)
+{
+    Press press;
+    press.code = Code(address, command, Protocol::RC6);
+    press.frames = frames;
+
+    for (std::size_t n = 0; n != frames; ++n)
+    {
+        std::vector<bool> halves(6, true);
+        halves.insert(halves.end(), 2, false);
+        appendManchester(&halves, true, true);
+        for (int bit = 0; bit != 3; ++bit)
+            appendManchester(&halves, false, true);
+        appendManchester(&halves, toggle, true, 2);
+        for (int bit = 7; bit >= 0; --bit)
+            appendManchester(&halves, (address >> bit) & 1, true);
+        for (int bit = 7; bit >= 0; --bit)
+            appendManchester(&halves, (command >> bit) & 1, true);
+        appendHalves(&press.signal, halves, 444, 83000);
+        if (0 == press.frame_pulses)
+            press.frame_pulses = press.signal.size();
+    }
+    return press;
+}
+
+
+/**
+ * @brief Distortions applied to the synthesized signals
+ */
+struct Distortion
+{
+    /** @brief Maximal deviation of each mark and space in microseconds */
+    std::uint32_t jitter = 0;
+    /** @brief Probability of a short spurious mark inside a space */
+    double glitch = 0.0;
+    /** @brief Cut every frame at a random pulse */
+    bool truncate = false;
+};
+
+void distort(Press * press, const Distortion & distortion, std::mt19937 * rng)
+{
+    if (distortion.truncate)
+    {
+        std::uniform_int_distribution<std::size_t> cut(1, press->frame_pulses - 1);
+        press->signal.resize(cut(*rng));
+        press->signal.back().space += 50000;
+        press->frames = 0;
+        press->repeat_codes = 0;
+    }
+
+    std::uniform_int_distribution<std::int32_t> jitter(-static_cast<std::int32_t>(distortion.jitter),
+            distortion.jitter);
+    std::bernoulli_distribution glitch(distortion.glitch);
+
+    Signal signal;
+    for (auto pulse: press->signal)
+    {
+        pulse.mark = std::max<std::int32_t>(TICK_US, pulse.mark + jitter(*rng));
+        pulse.space = std::max<std::int32_t>(TICK_US, pulse.space + jitter(*rng));
+        if (pulse.space > 400 && glitch(*rng))
+        {
+            const std::uint32_t before = pulse.space / 2;
+            signal.push_back({pulse.mark, before});
+            pulse = {150, pulse.space - before - 150};
+        }
+        signal.push_back(pulse);
+    }
+    press->signal = std::move(signal);
+}
+
+
+/**
+ * @brief Outcome of replaying a scenario
+ */
+struct Outcome
+{
+    std::size_t frames_sent = 0;
+    std::size_t frames_accepted = 0;
+    std::size_t false_accepts = 0;
+    std::size_t repeats_sent = 0;
+    std::size_t repeats_decoded = 0;
+    std::size_t per_protocol[4] = {};
+};
+
+void collect(Decoder * decoder, const Press * press, Outcome * outcome)
+{
+    Frame frame;
+    while (decoder->read(&frame))
+    {
+        if (!frame.code.isValid())
+        {
+            ++outcome->repeats_decoded;
+            continue;
+        }
+        ++outcome->per_protocol[static_cast<std::size_t>(frame.code.protocol())];
+        if (nullptr == press)
+            continue;
+        if (frame.code == press->code)
+            ++outcome->frames_accepted;
+        else
+            ++outcome->false_accepts;
+    }
+}
+
+bench::Result makeResult(const std::string & name, const Replay & replay, const Outcome & outcome)
+{
+    const auto rate = [](std::size_t part, std::size_t whole)
+        {
+            return 0 == whole ? 0.0 : (100.0 * static_cast<double>(part) / static_cast<double>(whole));
+        };
+
+    bench::Result result = {
+        name, replay.symbols(), replay.totalNs() / static_cast<double>(std::max<std::size_t>(1, replay.symbols())),
+    };
+    result.metrics = {
+        {"frames_sent", static_cast<double>(outcome.frames_sent)},
+        {"accept_rate_pct", rate(outcome.frames_accepted, outcome.frames_sent)},
+        {"reject_rate_pct", rate(outcome.frames_sent - std::min(outcome.frames_sent, outcome.frames_accepted),
+                outcome.frames_sent)},
+        {"false_accepts", static_cast<double>(outcome.false_accepts)},
+        {"repeat_codes_sent", static_cast<double>(outcome.repeats_sent)},
+        {"repeat_codes_decoded", static_cast<double>(outcome.repeats_decoded)},
+        {"interrupts", static_cast<double>(replay.interrupts())},
+        {"mean_ns_per_interrupt", replay.totalNs() / static_cast<double>(std::max<std::size_t>(1, replay.interrupts()))},
+        {"p99_ns_per_interrupt", replay.percentileNs(99.0)},
+        {"worst_ns_per_interrupt", replay.worstNs()},
+        {"worst_interrupt_symbols", static_cast<double>(replay.worstSymbols())},
+    };
+    return result;
+}
+
+using PressFactory = Press (*)(std::mt19937 * rng);
+
+bench::Result runScenario(const std::string & name, PressFactory factory, const Distortion & distortion)
+{
+    static const std::size_t PRESS_COUNT = 2000;
+
+    std::mt19937 rng(0x1234);
+    Decoder decoder;
+    Replay replay(&decoder);
+    Outcome outcome;
+
+    for (std::size_t n = 0; n != PRESS_COUNT; ++n)
+    {
+        Press press = factory(&rng);
+        distort(&press, distortion, &rng);
+        outcome.frames_sent += press.frames;
+        outcome.repeats_sent += press.repeat_codes;
+
+        replay.feed(press.signal);
+        collect(&decoder, &press, &outcome);
+    }
+
+    return makeResult(name, replay, outcome);
+}
+
+std::uint8_t randomByte(std::mt19937 * rng)
+{
+    return std::uniform_int_distribution<unsigned>(0, 0xFF)(*rng);
+}
+
+Press randomNec(std::mt19937 * rng) { return makeNec(randomByte(rng), randomByte(rng), 3); }
+Press randomSirc(std::mt19937 * rng) { return makeSirc(randomByte(rng), randomByte(rng), 3); }
+Press randomRc5(std::mt19937 * rng) { return makeRc5(randomByte(rng), randomByte(rng), randomByte(rng) & 1, 2); }
+Press randomRc6(std::mt19937 * rng) { return makeRc6(randomByte(rng), randomByte(rng), randomByte(rng) & 1, 2); }
+
+Press randomAny(std::mt19937 * rng)
+{
+    static const PressFactory FACTORIES[] = {&randomNec, &randomSirc, &randomRc5, &randomRc6};
+    return FACTORIES[randomByte(rng) & 3](rng);
+}
+
+
+/**
+ * @brief Load a trace in LIRC mode2 format ("pulse N" / "space N" lines in microseconds)
+ */
+bool loadMode2(const std::string & path, Signal * signal)
+{
+    std::FILE * const file = std::fopen(path.c_str(), "r");
+    if (nullptr == file)
+        return false;
+
+    char kind[16];
+    unsigned long duration;
+    Pulse pulse = {0, 0};
+    while (2 == std::fscanf(file, "%15s %lu", kind, &duration))
+    {
+        if (0 == std::strcmp(kind, "pulse"))
+        {
+            if (0 != pulse.mark)
+                signal->push_back(pulse);
+            pulse = {static_cast<std::uint32_t>(duration), 0};
+        }
+        else if (0 != pulse.mark)
+            pulse.space += duration;
+    }
+    if (0 != pulse.mark)
+    {
+        pulse.space += COUNTER_OVERFLOW_US;
+        signal->push_back(pulse);
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+bench::Result runTrace(const std::string & path)
+{
+    Signal signal;
+    if (!loadMode2(path, &signal))
+    {
+        std::fprintf(stderr, "Failed to read trace '%s'\n", path.c_str());
+        return {"ir/trace", 0, 0.0};
+    }
+
+    Decoder decoder;
+    Replay replay(&decoder);
+    Outcome outcome;
+    replay.feed(signal);
+    collect(&decoder, nullptr, &outcome);
+
+    auto result = makeResult("ir/trace", replay, outcome);
+    result.metrics = {
+        {"nec_frames", static_cast<double>(outcome.per_protocol[static_cast<std::size_t>(Protocol::NEC)])},
+        {"sirc_frames", static_cast<double>(outcome.per_protocol[static_cast<std::size_t>(Protocol::SIRC)])},
+        {"rc5_frames", static_cast<double>(outcome.per_protocol[static_cast<std::size_t>(Protocol::RC5)])},
+        {"rc6_frames", static_cast<double>(outcome.per_protocol[static_cast<std::size_t>(Protocol::RC6)])},
+        {"repeat_codes_decoded", static_cast<double>(outcome.repeats_decoded)},
+        {"worst_ns_per_interrupt", replay.worstNs()},
+    };
+    return result;
+}
+
+}  // namespace
+
+
+bench::Results bench::runIr(const Args & args)
+{
+    if (!args.empty())
+    {
+        Results results;
+        for (const auto & path: args)
+            results.push_back(runTrace(path));
+        return results;
+    }
+
+    const Distortion CLEAN = {};
+    const Distortion NOISY = {60, 0.0, false};
+    const Distortion GLITCHY = {50, 0.02, false};
+    const Distortion TRUNCATED = {0, 0.0, true};
+
+    return {
+        runScenario("ir/nec/clean", &randomNec, CLEAN),
+        runScenario("ir/nec/noisy", &randomNec, NOISY),
+        runScenario("ir/nec/truncated", &randomNec, TRUNCATED),
+        runScenario("ir/sirc/clean", &randomSirc, CLEAN),
+        runScenario("ir/sirc/noisy", &randomSirc, NOISY),
+        runScenario("ir/rc5/clean", &randomRc5, CLEAN),
+        runScenario("ir/rc5/noisy", &randomRc5, NOISY),
+        runScenario("ir/rc6/clean", &randomRc6, CLEAN),
+        runScenario("ir/rc6/noisy", &randomRc6, NOISY),
+        runScenario("ir/mixed/glitchy", &randomAny, GLITCHY),
+        runScenario("ir/mixed/truncated", &randomAny, TRUNCATED),
+    };
+}
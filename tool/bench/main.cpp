@@ -0,0 +1,133 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench.hpp"
+#include "driver/tools/trace.hpp"
+
+
+namespace
+{
+
+struct Suite
+{
+    const char * name;
+    bench::Results (* run)(const bench::Args & args);
+};
+
+const Suite SUITES[] = {
+    {"animation", &bench::runAnimation},
+    {"input", &bench::runInput},
+    {"ir", &bench::runIr},
+};
+
+void printResults(const bench::Results & results)
+{
+    for (const auto & result: results)
+    {
+        std::printf("%-32s %12zu iterations %12.1f ns/iteration\n", result.name.c_str(), result.iterations,
+                result.ns_per_iteration);
+        for (const auto & metric: result.metrics)
+            std::printf("    %-28s %12.2f\n", metric.name.c_str(), metric.value);
+    }
+}
+
+void printJsonString(const std::string & value)
+{
+    std::putchar('"');
+    for (const char c: value)
+    {
+        if ('"' == c || '\\' == c)
+            std::putchar('\\');
+        std::putchar(c);
+    }
+    std::putchar('"');
+}
+
+void printJson(const bench::Results & results, bool * is_first)
+{
+    for (const auto & result: results)
+    {
+        std::printf("%s\n  {\"name\": ", *is_first ? "" : ",");
+        *is_first = false;
+        printJsonString(result.name);
+        std::printf(", \"iterations\": %zu, \"ns_per_iteration\": %.3f, \"metrics\": {", result.iterations,
+                result.ns_per_iteration);
+        for (std::size_t n = 0; n != result.metrics.size(); ++n)
+        {
+            std::printf("%s", 0 == n ? "" : ", ");
+            printJsonString(result.metrics[n].name);
+            std::printf(": %.3f", result.metrics[n].value);
+        }
+        std::printf("}}");
+    }
+}
+
+/**
+ * @brief Save the trace ring for `tool/trace_decode.py`
+ */
+bool saveTrace(const char * path)
+{
+    std::FILE * const file = std::fopen(path, "wb");
+    if (nullptr == file)
+        return false;
+    const bool is_written = 1 == std::fwrite(driver::Trace::data(), driver::Trace::size(), 1, file);
+    return 0 == std::fclose(file) && is_written;
+}
+
+}  // namespace
+
+
+int main(int argc, char * argv[])
+{
+    // Machine-readable output
+    const bool is_json = argc > 1 && 0 == std::strcmp(argv[1], "--json");
+    if (is_json)
+    {
+        --argc;
+        ++argv;
+    }
+    const bench::Args args(argv + (argc > 1 ? 2 : 1), argv + argc);
+
+    bool found = false;
+    bool is_first = true;
+    if (is_json)
+        std::printf("[");
+    for (const auto & suite: SUITES)
+    {
+        if (argc > 1 && 0 != std::strcmp(argv[1], suite.name))
+            continue;
+        const auto results = suite.run(args);
+        if (is_json)
+            printJson(results, &is_first);
+        else
+            printResults(results);
+        found = true;
+    }
+    if (is_json)
+        std::printf("\n]\n");
+
+    if (!found)
+    {
+        std::fprintf(stderr, "Usage: %s [--json] [suite [args...]]\nSuites:", argv[0]);
+        for (const auto & suite: SUITES)
+            std::fprintf(stderr, " %s", suite.name);
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+
+    if (const char * const trace_path = std::getenv("BENCH_TRACE"))
+    {
+        if (!driver::Trace::ENABLED)
+        {
+            std::fprintf(stderr, "The trace is not built in, rebuild with TRACE=yes\n");
+            return 1;
+        }
+        if (!saveTrace(trace_path))
+        {
+            std::fprintf(stderr, "Cannot save the trace to %s\n", trace_path);
+            return 1;
+        }
+    }
+    return 0;
+}
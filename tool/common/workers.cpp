@@ -0,0 +1,52 @@
+#include "workers.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+/** @brief State of the random generator of the calling worker, see @ref rand() */
+thread_local std::uint64_t random_state = 1;
+
+}  // namespace
+
+
+std::size_t workers::count(std::size_t jobs, std::size_t task_count)
+{
+    return std::max<std::size_t>(1, std::min<std::size_t>(
+            0 == jobs ? std::thread::hardware_concurrency() : jobs, task_count));
+}
+
+void workers::run(std::size_t worker_count, std::size_t task_count, const std::function<void(TaskQueue *)> & worker)
+{
+    TaskQueue queue(task_count);
+    std::vector<std::thread> threads;
+    for (std::size_t n = 0; n != worker_count; ++n)
+        threads.emplace_back(worker, &queue);
+    for (auto & thread: threads)
+        thread.join();
+}
+
+
+/**
+ * @brief Random generator used by the animations, private to each worker
+ *
+ * Replaces the one of the C library, whose state is shared by all the threads,
+ * so the output would depend on the scheduling. The sequence is the one of the
+ * newlib used by the firmware.
+ */
+int rand() noexcept
+{
+    random_state = (random_state * 6364136223846793005ULL) + 1;
+    return static_cast<int>((random_state >> 32) & RAND_MAX);
+}
+
+void srand(unsigned seed) noexcept
+{
+    random_state = seed;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file
+ */
+
+#ifndef WORKERS_HPP_
+#define WORKERS_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+
+/**
+ * @brief Parallel processing of the animation slots shared by the host tools
+ *
+ * The animations keep their whole state in their storage and draw the random
+ * numbers from a generator private to the calling thread, see the `rand()` of
+ * `workers.cpp`, so every worker renders the same frames as the firmware
+ * regardless of the scheduling.
+ */
+namespace workers
+{
+
+/**
+ * @brief Queue of the task indices shared by the workers
+ */
+class TaskQueue
+{
+public:
+    explicit TaskQueue(std::size_t count): count_(count) {}
+
+    /**
+     * @brief Take the next task
+     *
+     * @param[out] task Index of the task
+     *
+     * @return A task was taken, false when the queue ran out
+     */
+    bool next(std::size_t * task)
+    {
+        *task = next_.fetch_add(1);
+        return *task < count_;
+    }
+
+private:
+    const std::size_t count_;
+    std::atomic<std::size_t> next_{0};
+};
+
+/**
+ * @brief Get the number of workers to run
+ *
+ * @param jobs Requested number of workers, zero for all cores
+ * @param task_count Number of tasks
+ *
+ * @return Number of workers, at least one and no more than the tasks
+ */
+std::size_t count(std::size_t jobs, std::size_t task_count);
+
+/**
+ * @brief Run the workers and wait for all of them to finish
+ *
+ * @param worker_count Number of worker threads
+ * @param task_count Number of tasks
+ * @param worker Body of each worker, takes the tasks from the queue until it
+ *               runs out
+ */
+void run(std::size_t worker_count, std::size_t task_count, const std::function<void(TaskQueue *)> & worker);
+
+}  // namespace workers
+
+
+#endif  // WORKERS_HPP_
@@ -0,0 +1,136 @@
+#include "export.hpp"
+
+#include <cstring>
+
+#include <zlib.h>
+
+
+namespace exporter
+{
+namespace
+{
+
+void putWord(std::uint8_t * buffer, std::uint32_t value)
+{
+    buffer[0] = static_cast<std::uint8_t>(value >> 24);
+    buffer[1] = static_cast<std::uint8_t>(value >> 16);
+    buffer[2] = static_cast<std::uint8_t>(value >> 8);
+    buffer[3] = static_cast<std::uint8_t>(value);
+}
+
+void putHalfWord(std::uint8_t * buffer, std::uint16_t value)
+{
+    buffer[0] = static_cast<std::uint8_t>(value >> 8);
+    buffer[1] = static_cast<std::uint8_t>(value);
+}
+
+
+class ApngWriter final:
+    public ImageWriter
+{
+public:
+    ApngWriter(std::FILE * file, std::size_t width, std::size_t height, std::size_t frame_count):
+        file_(file),
+        width_(width),
+        height_(height),
+        // Every row starts with the filter type, none is used
+        rows_(height * (1 + (width * 3))),
+        compressed_(4 + compressBound(rows_.size()))
+    {
+        std::fwrite("\x89PNG\r\n\x1A\n", 1, 8, file_);
+
+        std::uint8_t header[13] = {};
+        putWord(header + 0, static_cast<std::uint32_t>(width_));
+        putWord(header + 4, static_cast<std::uint32_t>(height_));
+        header[8] = 8;  // Bit depth
+        header[9] = 2;  // Truecolor
+        writeChunk("IHDR", header, sizeof(header));
+
+        std::uint8_t control[8] = {};
+        putWord(control + 0, static_cast<std::uint32_t>(frame_count));
+        putWord(control + 4, 0);  // Loop forever
+        writeChunk("acTL", control, sizeof(control));
+    }
+
+    bool write(const std::uint8_t * pixels, std::uint32_t delay_ms) override
+    {
+        const std::size_t stride = width_ * 3;
+        for (std::size_t row = 0; row != height_; ++row)
+        {
+            std::uint8_t * const pos = rows_.data() + (row * (stride + 1));
+            pos[0] = 0;
+            std::memcpy(pos + 1, pixels + (row * stride), stride);
+        }
+
+        std::uint8_t control[26] = {};
+        putWord(control + 0, sequence_++);
+        putWord(control + 4, static_cast<std::uint32_t>(width_));
+        putWord(control + 8, static_cast<std::uint32_t>(height_));
+        putHalfWord(control + 20, static_cast<std::uint16_t>(delay_ms));
+        putHalfWord(control + 22, 1000);
+        writeChunk("fcTL", control, sizeof(control));
+
+        // The first frame is the default image, the others go to the frame
+        // data chunks prefixed by the sequence number
+        const bool is_first = 1 == sequence_;
+        uLongf size = compressed_.size() - 4;
+        if (Z_OK != compress2(compressed_.data() + 4, &size, rows_.data(), rows_.size(), Z_BEST_SPEED))
+            return false;
+
+        if (is_first)
+        {
+            writeChunk("IDAT", compressed_.data() + 4, size);
+        }
+        else
+        {
+            putWord(compressed_.data(), sequence_++);
+            writeChunk("fdAT", compressed_.data(), size + 4);
+        }
+        return 0 == std::ferror(file_);
+    }
+
+    bool finish() override
+    {
+        writeChunk("IEND", nullptr, 0);
+        const bool is_written = 0 == std::ferror(file_);
+        return 0 == std::fclose(file_) && is_written;
+    }
+
+private:
+    std::FILE * file_;
+    std::size_t width_;
+    std::size_t height_;
+    std::vector<std::uint8_t> rows_;
+    std::vector<std::uint8_t> compressed_;
+    std::uint32_t sequence_ = 0;
+
+    void writeChunk(const char * type, const std::uint8_t * data, std::size_t size)
+    {
+        std::uint8_t word[4];
+        putWord(word, static_cast<std::uint32_t>(size));
+        std::fwrite(word, 1, sizeof(word), file_);
+        std::fwrite(type, 1, 4, file_);
+        if (0 != size)
+            std::fwrite(data, 1, size, file_);
+
+        uLong crc = crc32(0, reinterpret_cast<const Bytef *>(type), 4);
+        if (0 != size)
+            crc = crc32(crc, data, static_cast<uInt>(size));
+        putWord(word, static_cast<std::uint32_t>(crc));
+        std::fwrite(word, 1, sizeof(word), file_);
+    }
+};
+
+}  // namespace
+
+
+std::unique_ptr<ImageWriter> createApngWriter(const char * path, std::size_t width, std::size_t height,
+        std::size_t frame_count)
+{
+    std::FILE * const file = std::fopen(path, "wb");
+    if (nullptr == file)
+        return nullptr;
+    return std::make_unique<ApngWriter>(file, width, height, frame_count);
+}
+
+}  // namespace exporter
@@ -0,0 +1,59 @@
+#include "export.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace exporter
+{
+namespace
+{
+
+const std::uint8_t BACKGROUND = 0x20;
+
+}  // namespace
+
+
+Canvas::Canvas(std::size_t led_count, std::size_t columns, std::size_t cell_size):
+    led_count_(led_count),
+    columns_(std::max<std::size_t>(1, columns)),
+    cell_size_(std::max<std::size_t>(2, cell_size)),
+    width_(columns_ * cell_size_),
+    height_(((led_count_ + columns_ - 1) / columns_) * cell_size_),
+    dot_(cell_size_ * cell_size_),
+    pixels_(width_ * height_ * 3, BACKGROUND)
+{
+    // Dots leave one pixel wide gap between the neighbors
+    const std::size_t radius2 = ((cell_size_ - 2) * (cell_size_ - 2));
+    for (std::size_t y = 0; y != cell_size_; ++y)
+    {
+        for (std::size_t x = 0; x != cell_size_; ++x)
+        {
+            const std::size_t dx = (2 * x) + 1 > cell_size_ ? (2 * x) + 1 - cell_size_ : cell_size_ - (2 * x) - 1;
+            const std::size_t dy = (2 * y) + 1 > cell_size_ ? (2 * y) + 1 - cell_size_ : cell_size_ - (2 * y) - 1;
+            dot_[(y * cell_size_) + x] = (dx * dx) + (dy * dy) <= radius2;
+        }
+    }
+}
+
+void Canvas::draw(const std::uint8_t * colors)
+{
+    const std::size_t stride = width_ * 3;
+    for (std::size_t led = 0; led != led_count_; ++led)
+    {
+        const std::uint8_t * const color = colors + (led * 3);
+        std::uint8_t * const cell = pixels_.data() + ((led / columns_) * cell_size_ * stride) +
+                ((led % columns_) * cell_size_ * 3);
+        for (std::size_t y = 0; y != cell_size_; ++y)
+        {
+            std::uint8_t * pixel = cell + (y * stride);
+            for (std::size_t x = 0; x != cell_size_; ++x, pixel += 3)
+            {
+                if (dot_[(y * cell_size_) + x])
+                    std::memcpy(pixel, color, 3);
+            }
+        }
+    }
+}
+
+}  // namespace exporter
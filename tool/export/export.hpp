@@ -0,0 +1,107 @@
+/**
+ * @file
+ */
+
+#ifndef EXPORT_HPP_
+#define EXPORT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "led_strip.hpp"
+
+
+namespace exporter
+{
+
+/**
+ * @brief Picture of the LED strip, the LEDs are drawn as dots in a grid
+ */
+class Canvas
+{
+public:
+    /**
+     * @param led_count Number of LEDs of the strip
+     * @param columns Number of LEDs in a row
+     * @param cell_size Size of the square occupied by a single LED in pixels
+     */
+    Canvas(std::size_t led_count, std::size_t columns, std::size_t cell_size);
+
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+
+    /** @brief Packed RGB pixels, row after row */
+    const std::uint8_t * pixels() const { return pixels_.data(); }
+
+    /**
+     * @brief Draw the LEDs
+     *
+     * @param colors Corrected colors of the LEDs as RGB triplets
+     */
+    void draw(const std::uint8_t * colors);
+
+private:
+    std::size_t led_count_;
+    std::size_t columns_;
+    std::size_t cell_size_;
+    std::size_t width_;
+    std::size_t height_;
+    /** @brief Pixels of a cell covered by the dot */
+    std::vector<bool> dot_;
+    std::vector<std::uint8_t> pixels_;
+};
+
+
+/**
+ * @brief Animated image file being written frame by frame
+ */
+class ImageWriter
+{
+public:
+    /**
+     * @brief Append a frame
+     *
+     * @param pixels Packed RGB pixels of the frame
+     * @param delay_ms Time the frame is shown
+     *
+     * @return Frame was written
+     */
+    virtual bool write(const std::uint8_t * pixels, std::uint32_t delay_ms) = 0;
+
+    /**
+     * @brief Complete and close the file
+     *
+     * @return The whole file was written
+     */
+    virtual bool finish() = 0;
+
+    virtual ~ImageWriter() = default;
+};
+
+/**
+ * @brief Create writer of a looping GIF
+ *
+ * Every frame has its own color table with the exact colors of the frame, as
+ * long as it has at most 256 colors.
+ *
+ * @return The writer or `nullptr` if the file cannot be created
+ */
+std::unique_ptr<ImageWriter> createGifWriter(const char * path, std::size_t width, std::size_t height);
+
+/**
+ * @brief Create writer of a looping animated PNG
+ *
+ * @param frame_count Number of frames to be written, stored in the header
+ *
+ * @return The writer or `nullptr` if the file cannot be created
+ */
+std::unique_ptr<ImageWriter> createApngWriter(const char * path, std::size_t width, std::size_t height,
+        std::size_t frame_count);
+
+}  // namespace exporter
+
+
+#endif  // EXPORT_HPP_
@@ -0,0 +1,306 @@
+#include "export.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace exporter
+{
+namespace
+{
+
+const std::size_t MAX_COLORS = 256;
+const std::uint32_t MAX_CODE = 4095;
+
+void writeWord(std::FILE * file, std::size_t value)
+{
+    std::fputc(static_cast<int>(value & 0xFF), file);
+    std::fputc(static_cast<int>((value >> 8) & 0xFF), file);
+}
+
+
+/**
+ * @brief LZW compression of the image data, packed into the GIF sub-blocks
+ */
+class LzwEncoder
+{
+public:
+    explicit LzwEncoder(std::FILE * file):
+        file_(file)
+    { }
+
+    void encode(const std::uint8_t * indices, std::size_t count, std::uint32_t min_code_size)
+    {
+        min_code_size_ = min_code_size;
+        clear_code_ = 1u << min_code_size;
+        std::fputc(static_cast<int>(min_code_size_), file_);
+        reset();
+        writeCode(clear_code_);
+
+        std::uint32_t current = indices[0];
+        for (std::size_t n = 1; n != count; ++n)
+        {
+            const std::uint32_t index = indices[n];
+            const std::uint32_t found = find(current, index);
+            if (NO_CODE != found)
+            {
+                current = found;
+                continue;
+            }
+
+            writeCode(current);
+            insert(current, index, ++max_code_);
+            // Dictionary entry count has broken a size barrier
+            if (max_code_ >= (1u << code_size_))
+                ++code_size_;
+            if (MAX_CODE == max_code_)
+            {
+                writeCode(clear_code_);
+                reset();
+            }
+            current = index;
+        }
+
+        writeCode(current);
+        writeCode(clear_code_);
+        writeCode(clear_code_ + 1);
+        flush();
+        std::fputc(0, file_);
+    }
+
+private:
+    static const inline std::uint32_t TABLE_SIZE = 8192;
+    static const inline std::uint32_t NO_CODE = ~std::uint32_t{0};
+
+    std::FILE * file_;
+    std::uint32_t min_code_size_ = 0;
+    std::uint32_t clear_code_ = 0;
+    std::uint32_t code_size_ = 0;
+    std::uint32_t max_code_ = 0;
+
+    /** @brief Open addressing table of the `(prefix code, index)` pairs */
+    std::uint32_t keys_[TABLE_SIZE];
+    std::uint16_t codes_[TABLE_SIZE];
+
+    std::uint32_t bits_ = 0;
+    std::uint32_t bit_count_ = 0;
+    std::uint8_t block_[255];
+    std::size_t block_size_ = 0;
+
+    void reset()
+    {
+        code_size_ = min_code_size_ + 1;
+        max_code_ = clear_code_ + 1;
+        std::fill(std::begin(keys_), std::end(keys_), NO_CODE);
+    }
+
+    static std::uint32_t slot(std::uint32_t key)
+    {
+        return (key * 2654435761u) >> (32 - 13);
+    }
+
+    std::uint32_t find(std::uint32_t prefix, std::uint32_t index) const
+    {
+        const std::uint32_t key = (prefix << 8) | index;
+        for (std::uint32_t pos = slot(key); ; pos = (pos + 1) & (TABLE_SIZE - 1))
+        {
+            if (key == keys_[pos])
+                return codes_[pos];
+            if (NO_CODE == keys_[pos])
+                return NO_CODE;
+        }
+    }
+
+    void insert(std::uint32_t prefix, std::uint32_t index, std::uint32_t code)
+    {
+        const std::uint32_t key = (prefix << 8) | index;
+        std::uint32_t pos = slot(key);
+        while (NO_CODE != keys_[pos])
+            pos = (pos + 1) & (TABLE_SIZE - 1);
+        keys_[pos] = key;
+        codes_[pos] = static_cast<std::uint16_t>(code);
+    }
+
+    void writeCode(std::uint32_t code)
+    {
+        bits_ |= code << bit_count_;
+        bit_count_ += code_size_;
+        while (bit_count_ >= 8)
+        {
+            writeByte(static_cast<std::uint8_t>(bits_));
+            bits_ >>= 8;
+            bit_count_ -= 8;
+        }
+    }
+
+    void writeByte(std::uint8_t value)
+    {
+        block_[block_size_++] = value;
+        if (sizeof(block_) == block_size_)
+            writeBlock();
+    }
+
+    void writeBlock()
+    {
+        std::fputc(static_cast<int>(block_size_), file_);
+        std::fwrite(block_, 1, block_size_, file_);
+        block_size_ = 0;
+    }
+
+    void flush()
+    {
+        if (0 != bit_count_)
+            writeByte(static_cast<std::uint8_t>(bits_));
+        bits_ = 0;
+        bit_count_ = 0;
+        if (0 != block_size_)
+            writeBlock();
+    }
+};
+
+
+class GifWriter final:
+    public ImageWriter
+{
+public:
+    GifWriter(std::FILE * file, std::size_t width, std::size_t height):
+        file_(file),
+        width_(width),
+        height_(height),
+        indices_(width * height),
+        encoder_(std::make_unique<LzwEncoder>(file))
+    {
+        std::fwrite("GIF89a", 1, 6, file_);
+        writeWord(file_, width_);
+        writeWord(file_, height_);
+        // No global color table
+        std::fputc(0, file_);
+        std::fputc(0, file_);
+        std::fputc(0, file_);
+
+        // Loop forever
+        std::fwrite("\x21\xFF\x0BNETSCAPE2.0\x03\x01", 1, 16, file_);
+        writeWord(file_, 0);
+        std::fputc(0, file_);
+    }
+
+    bool write(const std::uint8_t * pixels, std::uint32_t delay_ms) override
+    {
+        const std::size_t color_count = buildPalette(pixels);
+        std::uint32_t table_bits = 1;
+        while ((std::size_t{1} << table_bits) < color_count)
+            ++table_bits;
+
+        // Delays are in hundredths of a second, keep the rounding error from
+        // accumulating
+        elapsed_ms_ += delay_ms;
+        const std::uint32_t shown_cs = static_cast<std::uint32_t>((elapsed_ms_ + 5) / 10);
+        const std::uint32_t delay_cs = shown_cs - shown_cs_;
+        shown_cs_ = shown_cs;
+
+        std::fwrite("\x21\xF9\x04\x04", 1, 4, file_);
+        writeWord(file_, delay_cs);
+        std::fputc(0, file_);
+        std::fputc(0, file_);
+
+        std::fputc(0x2C, file_);
+        writeWord(file_, 0);
+        writeWord(file_, 0);
+        writeWord(file_, width_);
+        writeWord(file_, height_);
+        std::fputc(static_cast<int>(0x80 | (table_bits - 1)), file_);
+        for (std::size_t n = 0; n != (std::size_t{1} << table_bits); ++n)
+        {
+            const std::uint32_t color = n < color_count ? palette_[n] : 0;
+            std::fputc(static_cast<int>((color >> 16) & 0xFF), file_);
+            std::fputc(static_cast<int>((color >> 8) & 0xFF), file_);
+            std::fputc(static_cast<int>(color & 0xFF), file_);
+        }
+
+        encoder_->encode(indices_.data(), indices_.size(), std::max<std::uint32_t>(2, table_bits));
+        return 0 == std::ferror(file_);
+    }
+
+    bool finish() override
+    {
+        std::fputc(0x3B, file_);
+        const bool is_written = 0 == std::ferror(file_);
+        return 0 == std::fclose(file_) && is_written;
+    }
+
+private:
+    std::FILE * file_;
+    std::size_t width_;
+    std::size_t height_;
+    std::vector<std::uint8_t> indices_;
+    std::unique_ptr<LzwEncoder> encoder_;
+    std::uint32_t palette_[MAX_COLORS];
+
+    std::uint64_t elapsed_ms_ = 0;
+    std::uint32_t shown_cs_ = 0;
+
+    static std::uint32_t toColor(const std::uint8_t * pixel)
+    {
+        return (std::uint32_t{pixel[0]} << 16) | (std::uint32_t{pixel[1]} << 8) | pixel[2];
+    }
+
+    /**
+     * @brief Index the pixels of the frame
+     *
+     * Frames with too many colors fall back to the 3-3-2 bit palette.
+     *
+     * @return Number of the colors in the palette
+     */
+    std::size_t buildPalette(const std::uint8_t * pixels)
+    {
+        std::size_t color_count = 0;
+        std::uint32_t last_color = ~std::uint32_t{0};
+        std::uint8_t last_index = 0;
+        for (std::size_t n = 0; n != indices_.size(); ++n)
+        {
+            const std::uint32_t color = toColor(pixels + (n * 3));
+            if (color != last_color)
+            {
+                const auto end = palette_ + color_count;
+                const auto pos = std::find(palette_, end, color);
+                if (end == pos)
+                {
+                    if (MAX_COLORS == color_count)
+                        return buildFixedPalette(pixels);
+                    palette_[color_count++] = color;
+                }
+                last_color = color;
+                last_index = static_cast<std::uint8_t>(pos - palette_);
+            }
+            indices_[n] = last_index;
+        }
+        return color_count;
+    }
+
+    std::size_t buildFixedPalette(const std::uint8_t * pixels)
+    {
+        for (std::size_t n = 0; n != MAX_COLORS; ++n)
+        {
+            palette_[n] = (((n >> 5) * 255 / 7) << 16) | ((((n >> 2) & 7) * 255 / 7) << 8) | ((n & 3) * 255 / 3);
+        }
+        for (std::size_t n = 0; n != indices_.size(); ++n)
+        {
+            const std::uint8_t * const pixel = pixels + (n * 3);
+            indices_[n] = static_cast<std::uint8_t>((pixel[0] & 0xE0) | ((pixel[1] >> 3) & 0x1C) | (pixel[2] >> 6));
+        }
+        return MAX_COLORS;
+    }
+};
+
+}  // namespace
+
+
+std::unique_ptr<ImageWriter> createGifWriter(const char * path, std::size_t width, std::size_t height)
+{
+    std::FILE * const file = std::fopen(path, "wb");
+    if (nullptr == file)
+        return nullptr;
+    return std::make_unique<GifWriter>(file, width, height);
+}
+
+}  // namespace exporter
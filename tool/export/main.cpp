@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "export.hpp"
+#include "led_strip.hpp"
+#include "app/animation_storage.hpp"
+#include "app/led_correction.hpp"
+#include "workers.hpp"
+
+
+namespace
+{
+
+/** @brief Number of LEDs and the render period of the firmware, see `Lights` */
+const LedSize LED_COUNT = 100;
+const std::uint32_t STEP_PERIOD = 8;
+
+/** @brief Correction used by the firmware for the default LED order */
+using Correction = CommonLedCorrection<DimmingLedWriter<ComponentWriterRGB>>;
+
+struct Options
+{
+    bool is_apng = false;
+    std::uint32_t duration_ms = 5000;
+    std::uint32_t steps_per_frame = 5;
+    std::uint32_t intensity = 0x60;
+    std::size_t columns = 10;
+    std::size_t cell_size = 24;
+    std::size_t jobs = 0;
+    std::string output = ".";
+};
+
+/**
+ * @brief Render and encode a single slot
+ *
+ * @param storage Animation storage owned by the calling worker
+ */
+bool exportSlot(const Options & options, AnimationStorage * storage, std::size_t slot)
+{
+    static const char * const EXTENSIONS[] = {"gif", "png"};
+    char path[4096];
+    std::snprintf(path, sizeof(path), "%s/slot_%02zu.%s", options.output.c_str(), slot,
+            EXTENSIONS[options.is_apng ? 1 : 0]);
+
+    // Every slot starts from its default state and the seed the firmware
+    // boots with, regardless of the previous slots of the worker
+    storage->change(static_cast<AnimationStorage::AnimationSlotId>(slot));
+    storage->initializeCurrentSlot();
+    std::srand(1);
+
+    LedStrip<LED_COUNT> strip;
+    std::uint8_t colors[LED_COUNT * Correction::LedWriterType::LED_LENGTH];
+    const Correction correction(options.intensity);
+    exporter::Canvas canvas(LED_COUNT, options.columns, options.cell_size);
+
+    const std::uint32_t frame_period = STEP_PERIOD * options.steps_per_frame;
+    const std::size_t frame_count = std::max<std::size_t>(1, options.duration_ms / frame_period);
+    const auto writer = options.is_apng ?
+            exporter::createApngWriter(path, canvas.width(), canvas.height(), frame_count) :
+            exporter::createGifWriter(path, canvas.width(), canvas.height());
+    if (nullptr == writer)
+    {
+        std::fprintf(stderr, "Cannot create %s\n", path);
+        return false;
+    }
+
+    for (std::size_t frame = 0; frame != frame_count; ++frame)
+    {
+        for (std::uint32_t step = 0; step != options.steps_per_frame; ++step)
+            (*storage)->render(strip.abstractPtr(), {});
+        correction.correct(strip.leds, LED_COUNT, colors, sizeof(colors));
+        canvas.draw(colors);
+        if (!writer->write(canvas.pixels(), frame_period))
+        {
+            std::fprintf(stderr, "Cannot write %s\n", path);
+            writer->finish();
+            return false;
+        }
+    }
+    if (!writer->finish())
+    {
+        std::fprintf(stderr, "Cannot write %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Export the slots taken from the shared queue until it runs out
+ */
+void runWorker(const Options & options, const std::vector<std::size_t> & slots, workers::TaskQueue * queue,
+        std::atomic<bool> * is_ok)
+{
+    // Animations keep their whole state in the storage, so the workers do not
+    // share anything
+    AnimationStorage storage;
+    std::size_t n;
+    while (queue->next(&n))
+    {
+        if (!exportSlot(options, &storage, slots[n]))
+            is_ok->store(false);
+    }
+}
+
+void printUsage(const char * name)
+{
+    std::fprintf(stderr,
+            "Usage: %s [options] [slot...]\n"
+            "Render animation slots of the firmware into animated images, all slots by default.\n"
+            "  -a       Write animated PNG instead of GIF\n"
+            "  -d MS    Duration of the animation, default 5000\n"
+            "  -s N     Render steps (%u ms each) per image frame, default 5\n"
+            "  -i N     Intensity of the LED correction, default 96 as the firmware\n"
+            "  -c N     LEDs in a row of the picture, default 10\n"
+            "  -p N     Size of a LED in pixels, default 24\n"
+            "  -j N     Number of worker threads, default all cores\n"
+            "  -o DIR   Output directory, default current directory\n",
+            name, static_cast<unsigned>(STEP_PERIOD));
+}
+
+}  // namespace
+
+
+int main(int argc, char * argv[])
+{
+    Options options;
+    int opt;
+    while (-1 != (opt = ::getopt(argc, argv, "ad:s:i:c:p:j:o:h")))
+    {
+        switch (opt)
+        {
+        case 'a': options.is_apng = true; break;
+        case 'd': options.duration_ms = std::strtoul(optarg, nullptr, 0); break;
+        case 's': options.steps_per_frame = std::strtoul(optarg, nullptr, 0); break;
+        case 'i': options.intensity = std::strtoul(optarg, nullptr, 0); break;
+        case 'c': options.columns = std::strtoul(optarg, nullptr, 0); break;
+        case 'p': options.cell_size = std::strtoul(optarg, nullptr, 0); break;
+        case 'j': options.jobs = std::strtoul(optarg, nullptr, 0); break;
+        case 'o': options.output = optarg; break;
+        default:
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (0 == options.steps_per_frame)
+        options.steps_per_frame = 1;
+
+    std::vector<std::size_t> slots;
+    for (int n = optind; n < argc; ++n)
+    {
+        const std::size_t slot = std::strtoul(argv[n], nullptr, 0);
+        if (slot >= AnimationStorage::SLOT_COUNT)
+        {
+            std::fprintf(stderr, "Invalid slot %s, there are %zu slots\n", argv[n], AnimationStorage::SLOT_COUNT);
+            return 1;
+        }
+        slots.push_back(slot);
+    }
+    if (slots.empty())
+    {
+        for (std::size_t slot = 0; slot != AnimationStorage::SLOT_COUNT; ++slot)
+            slots.push_back(slot);
+    }
+
+    const std::size_t jobs = workers::count(options.jobs, slots.size());
+
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<bool> is_ok{true};
+    workers::run(jobs, slots.size(), [&](workers::TaskQueue * queue)
+        {
+            runWorker(options, slots, queue, &is_ok);
+        });
+    const auto end = std::chrono::steady_clock::now();
+
+    std::printf("Exported %zu slots using %zu threads in %.3f s\n", slots.size(), jobs,
+            std::chrono::duration<double>(end - start).count());
+    return is_ok.load() ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file
+ */
+
+#ifndef GOLDEN_HPP_
+#define GOLDEN_HPP_
+
+
+/**
+ * @brief Checks of the firmware parts whose output is derived from the
+ *        animation frames, run along the comparison of the golden hashes
+ *
+ * Every check prints a line with its result and the details of the first
+ * mismatch.
+ */
+namespace golden
+{
+
+/**
+ * @brief Compare the data sent to indexed strips with the corrected colors of
+ *        the expanded strips
+ *
+ * @return All the strips match
+ */
+bool checkIndexedStrips();
+
+/**
+ * @brief Compare the data of a strip chained from differently corrected
+ *        segments with the colors corrected one LED at a time
+ *
+ * @return All the segments match
+ */
+bool checkSegmentedCorrection();
+
+/**
+ * @brief Check the mapping of the matrix and ring coordinates to the LEDs
+ *
+ * @return All the topologies match
+ */
+bool checkTopologies();
+
+}  // namespace golden
+
+
+#endif  // GOLDEN_HPP_
@@ -0,0 +1,217 @@
+#include "golden.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "led_strip.hpp"
+#include "indexed_led_strip.hpp"
+#include "tools/polymorphic_storage.hpp"
+#include "app/led_correction.hpp"
+#include "driver/led_controller/led_data_buffer.hpp"
+
+
+namespace
+{
+
+using driver::led::BitCircularBuffer;
+using driver::led::LedDataBuffer;
+
+using Data = std::vector<std::uint8_t>;
+
+/**
+ * @brief Fill the bit buffer the way the DMA interrupts do and decode the
+ *        bytes sent to the LEDs
+ *
+ * @param start Function starting the transfer of the data buffer
+ */
+template <typename F>
+Data transfer(F && start)
+{
+    static BitCircularBuffer bits;
+    static LedDataBuffer data;
+    start(&data);
+
+    Data sent;
+    for (std::size_t half = 0; data.readInto(half, &bits); half ^= 1)
+    {
+        const auto * pattern = static_cast<const std::uint8_t *>(bits.data()) +
+                (half * BitCircularBuffer::HALF_CAPACITY * 8);
+        for (std::size_t n = 0; n != BitCircularBuffer::HALF_CAPACITY; ++n, pattern += 8)
+        {
+            // Blank bits synchronize the DMA and pad the last half
+            if (0 == pattern[0])
+                continue;
+            std::uint8_t value = 0;
+            for (std::size_t bit = 0; bit != 8; ++bit)
+                value = (value << 1) | (driver::led::ONE_BIT_LENGTH == pattern[bit] ? 1 : 0);
+            sent.push_back(value);
+        }
+    }
+    return sent;
+}
+
+LedState makeColor(std::size_t n)
+{
+    const std::uint32_t hash = static_cast<std::uint32_t>(n + 1) * 2654435761u;
+    return LedState(hash >> 8);
+}
+
+bool compare(const char * name, const Data & expected, const Data & actual)
+{
+    if (expected == actual)
+        return true;
+
+    std::size_t pos = 0;
+    while (pos != expected.size() && pos != actual.size() && expected[pos] == actual[pos])
+        ++pos;
+    std::printf("%s: %zu bytes instead of %zu, first difference at byte %zu\n", name, actual.size(),
+            expected.size(), pos);
+    return false;
+}
+
+/**
+ * @brief Check an indexed strip against its colors expanded in advance
+ *
+ * @param palette_length Palette length set in the strip, may be out of range
+ */
+template <LedSize LED_C, def::Uint8 INDEX_BITS>
+bool checkIndexed(const char * name, def::Uint8 palette_length, const LedCorrection & correction)
+{
+    using Strip = IndexedLedStrip<LED_C, INDEX_BITS>;
+    static Strip strip;
+    for (std::size_t n = 0; n != Strip::MAX_PALETTE_LENGTH; ++n)
+        strip.palette[n] = makeColor(n);
+    strip.palette_length = palette_length;
+    const def::Uint8 index_count = 4 == INDEX_BITS ? 16 : 23;
+    for (LedSize led = 0; led != LED_C; ++led)
+        strip.setIndex(led, static_cast<def::Uint8>((led * 7) % index_count));
+
+    // LEDs with indices past the palette in use are sent as its first color
+    const std::size_t used_length = std::min<std::size_t>(palette_length, Strip::MAX_PALETTE_LENGTH);
+    static LedStrip<LED_C> expanded;
+    for (LedSize led = 0; led != LED_C; ++led)
+    {
+        const def::Uint8 index = strip.index(led);
+        expanded[led] = strip.palette[index < used_length ? index : 0];
+    }
+    Data expected(LED_C * 3);
+    expected.resize(correction.correct(expanded.leds, LED_C, expected.data(), expected.size()));
+
+    return compare(name, expected,
+            transfer([&](LedDataBuffer * data) { data->start(strip.abstractPtr(), &correction); }));
+}
+
+/**
+ * @brief Reference of the gamma correction, see @ref GammaLedWriter
+ */
+std::uint8_t gamma(std::uint8_t value, std::uint32_t intensity)
+{
+    const auto corrected = static_cast<std::uint32_t>((std::pow(value / 255.0, 2.2) * 255.0) + 0.5);
+    return static_cast<std::uint8_t>((corrected * intensity) >> 8);
+}
+
+/**
+ * @brief Expected bytes of a LED, the components in given order
+ */
+void appendLed(Data * data, bool is_grb, std::uint8_t r, std::uint8_t g, std::uint8_t b)
+{
+    data->push_back(is_grb ? g : r);
+    data->push_back(is_grb ? r : g);
+    data->push_back(b);
+}
+
+}  // namespace
+
+
+bool golden::checkIndexedStrips()
+{
+    const CommonLedCorrection<StandardLedWriter<ComponentWriterRGB>> plain;
+    const CommonLedCorrection<DimmingLedWriter<ComponentWriterGRB>> dimmed(0x60);
+    const CommonLedCorrection<GammaLedWriter<ComponentWriterRGB>> gamma(0xC0);
+
+    // Strip of the firmware sent directly, the reference of the encoding
+    static LedStrip<100> strip;
+    for (LedSize led = 0; led != 100; ++led)
+        strip[led] = makeColor(led);
+    Data expected(300);
+    expected.resize(dimmed.correct(strip.leds, 100, expected.data(), expected.size()));
+    bool is_ok = compare("direct strip", expected,
+            transfer([&](LedDataBuffer * data) { data->start(strip.leds, 100, &dimmed); }));
+
+    is_ok = checkIndexed<200, 4>("nibble indices, more LEDs than the data buffer fits", 16, dimmed) && is_ok;
+    is_ok = checkIndexed<90, 8>("byte indices past the palette", 5, plain) && is_ok;
+    is_ok = checkIndexed<31, 4>("palette length out of range", 200, gamma) && is_ok;
+
+    if (is_ok)
+        std::printf("indexed strips match the corrected colors\n");
+    return is_ok;
+}
+
+bool golden::checkSegmentedCorrection()
+{
+    // Dimmed GRB LEDs, followed by plain RGB LEDs and gamma corrected GRB LEDs
+    using First = DimmingLedWriter<ComponentWriterGRB>;
+    using Second = StandardLedWriter<ComponentWriterRGB>;
+    using Third = GammaLedWriter<ComponentWriterGRB>;
+    using Correction = SegmentedLedCorrection<First, Second, Third>;
+    const std::size_t FIRST_LENGTH = 10;
+    const std::size_t SECOND_LENGTH = 15;
+    const std::uint32_t DIMMED = 0x80;
+    const std::uint32_t GAMMA = 0xC0;
+
+    // Created the way LedController::configure() does
+    PolymorphicStorage<LedCorrection, 64> correction(TypeTag<Correction>{},
+            LedSegment<First>{FIRST_LENGTH, First(DIMMED)},
+            LedSegment<Second>{SECOND_LENGTH, Second()},
+            LedSegment<Third>{1, Third(GAMMA)});
+
+    // The last segment takes all the remaining LEDs
+    static LedStrip<100> strip;
+    Data expected;
+    for (LedSize led = 0; led != 100; ++led)
+    {
+        const LedState color = makeColor(led);
+        strip[led] = color;
+        if (led < FIRST_LENGTH)
+        {
+            appendLed(&expected, true, (color.red * DIMMED) >> 8, (color.green * DIMMED) >> 8,
+                    (color.blue * DIMMED) >> 8);
+        }
+        else if (led < FIRST_LENGTH + SECOND_LENGTH)
+            appendLed(&expected, false, color.red, color.green, color.blue);
+        else
+            appendLed(&expected, true, gamma(color.red, GAMMA), gamma(color.green, GAMMA), gamma(color.blue, GAMMA));
+    }
+    Data actual(300);
+    actual.resize(correction->correct(strip.leds, 100, actual.data(), actual.size()));
+    bool is_ok = compare("segmented strip", expected, actual);
+
+    // Shorter buffer ends within the second segment
+    expected.resize(20 * 3);
+    actual.assign(20 * 3, 0);
+    actual.resize(correction->correct(strip.leds, 100, actual.data(), actual.size()));
+    is_ok = compare("segmented strip, short buffer", expected, actual) && is_ok;
+
+    // Palette of the indexed strips is written as the LEDs of the first segment
+    static IndexedLedStrip<60, 4> indexed;
+    indexed.palette_length = 3;
+    for (std::size_t n = 0; n != indexed.palette_length; ++n)
+        indexed.palette[n] = makeColor(n);
+    for (LedSize led = 0; led != 60; ++led)
+        indexed.setIndex(led, led % 3);
+    expected.clear();
+    for (LedSize led = 0; led != 60; ++led)
+    {
+        const LedState color = indexed.palette[led % 3];
+        appendLed(&expected, true, (color.red * DIMMED) >> 8, (color.green * DIMMED) >> 8,
+                (color.blue * DIMMED) >> 8);
+    }
+    is_ok = compare("segmented indexed strip", expected,
+            transfer([&](LedDataBuffer * data) { data->start(indexed.abstractPtr(), correction.get()); })) && is_ok;
+
+    if (is_ok)
+        std::printf("segmented correction writes every segment in its order\n");
+    return is_ok;
+}
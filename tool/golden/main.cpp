@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+
+#include "led_strip.hpp"
+#include "app/animation_storage.hpp"
+#include "workers.hpp"
+#include "golden.hpp"
+
+
+namespace
+{
+
+/** @brief Number of LEDs of the firmware, see `Lights` */
+const LedSize LED_COUNT = 100;
+const std::uint32_t DEFAULT_FRAMES = 1024;
+/** @brief Number of frames covered by a single hash of each LED */
+const std::uint32_t LED_BLOCK = 16;
+
+const char MAGIC[4] = {'W', 'S', 'G', 'F'};
+const std::uint32_t VERSION = 1;
+
+/**
+ * @brief Hashes of all the frames of a slot
+ *
+ * Each frame has a hash of all its LEDs, pinpointing the first diverging
+ * frame. Each LED has a short hash for every block of frames, locating the
+ * diverging LED within the block.
+ */
+struct SlotHashes
+{
+    std::vector<std::uint32_t> frames;
+    /** @brief LED hashes of the blocks, block after block */
+    std::vector<std::uint8_t> leds;
+};
+
+std::uint32_t hashBytes(std::uint32_t hash, const void * data, std::size_t size)
+{
+    const auto * const bytes = static_cast<const std::uint8_t *>(data);
+    for (std::size_t n = 0; n != size; ++n)
+        hash = (hash ^ bytes[n]) * 16777619u;
+    return hash;
+}
+
+std::size_t blockCount(std::uint32_t frames)
+{
+    return (frames + LED_BLOCK - 1) / LED_BLOCK;
+}
+
+/**
+ * @brief Render the slot and hash its frames
+ *
+ * @param storage Animation storage owned by the calling worker
+ */
+void hashSlot(AnimationStorage * storage, std::size_t slot, std::uint32_t frames, SlotHashes * hashes)
+{
+    // Every slot starts from its default state and the seed the firmware
+    // boots with, regardless of the previous slots of the worker
+    storage->change(static_cast<AnimationStorage::AnimationSlotId>(slot));
+    storage->initializeCurrentSlot();
+    std::srand(1);
+
+    LedStrip<LED_COUNT> strip;
+    std::uint32_t led_hashes[LED_COUNT];
+    hashes->frames.resize(frames);
+    hashes->leds.resize(blockCount(frames) * LED_COUNT);
+
+    for (std::uint32_t frame = 0; frame != frames; ++frame)
+    {
+        (*storage)->render(strip.abstractPtr(), {});
+        hashes->frames[frame] = hashBytes(2166136261u, strip.leds, sizeof(strip.leds));
+
+        if (0 == (frame % LED_BLOCK))
+        {
+            for (LedSize led = 0; led != LED_COUNT; ++led)
+                led_hashes[led] = hashBytes(2166136261u, &led, sizeof(led));
+        }
+        for (LedSize led = 0; led != LED_COUNT; ++led)
+            led_hashes[led] = hashBytes(led_hashes[led], &(strip.leds[led]), sizeof(LedState));
+        if ((LED_BLOCK - 1) == (frame % LED_BLOCK) || (frames - 1) == frame)
+        {
+            std::uint8_t * const block = hashes->leds.data() + ((frame / LED_BLOCK) * LED_COUNT);
+            for (LedSize led = 0; led != LED_COUNT; ++led)
+                block[led] = static_cast<std::uint8_t>(led_hashes[led] ^ (led_hashes[led] >> 8) ^
+                        (led_hashes[led] >> 16) ^ (led_hashes[led] >> 24));
+        }
+    }
+}
+
+/**
+ * @brief Hash the slots taken from the shared queue until it runs out
+ */
+void runWorker(std::uint32_t frames, std::vector<SlotHashes> * results, workers::TaskQueue * queue)
+{
+    AnimationStorage storage;
+    std::size_t slot;
+    while (queue->next(&slot))
+        hashSlot(&storage, slot, frames, &((*results)[slot]));
+}
+
+/**
+ * @brief Golden file: header followed by the frame and LED hashes of each slot
+ *
+ * All the values are little-endian.
+ */
+struct Header
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t slot_count;
+    std::uint32_t frames;
+    std::uint32_t led_count;
+    std::uint32_t led_block;
+};
+
+bool save(const char * path, std::uint32_t frames, const std::vector<SlotHashes> & results)
+{
+    std::FILE * const file = std::fopen(path, "wb");
+    if (nullptr == file)
+        return false;
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.slot_count = static_cast<std::uint32_t>(results.size());
+    header.frames = frames;
+    header.led_count = LED_COUNT;
+    header.led_block = LED_BLOCK;
+    bool is_written = 1 == std::fwrite(&header, sizeof(header), 1, file);
+    for (const auto & result: results)
+    {
+        is_written = is_written &&
+            result.frames.size() == std::fwrite(result.frames.data(), sizeof(std::uint32_t), result.frames.size(),
+                    file) &&
+            result.leds.size() == std::fwrite(result.leds.data(), 1, result.leds.size(), file);
+    }
+    return 0 == std::fclose(file) && is_written;
+}
+
+bool load(const char * path, std::uint32_t * frames, std::vector<SlotHashes> * results)
+{
+    std::FILE * const file = std::fopen(path, "rb");
+    if (nullptr == file)
+        return false;
+
+    Header header;
+    bool is_read = 1 == std::fread(&header, sizeof(header), 1, file) &&
+            0 == std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) && VERSION == header.version &&
+            LED_COUNT == header.led_count && LED_BLOCK == header.led_block;
+    if (is_read)
+    {
+        *frames = header.frames;
+        results->resize(header.slot_count);
+        for (auto & result: *results)
+        {
+            result.frames.resize(header.frames);
+            result.leds.resize(blockCount(header.frames) * LED_COUNT);
+            is_read = is_read &&
+                result.frames.size() == std::fread(result.frames.data(), sizeof(std::uint32_t), result.frames.size(),
+                        file) &&
+                result.leds.size() == std::fread(result.leds.data(), 1, result.leds.size(), file);
+        }
+    }
+    std::fclose(file);
+    return is_read;
+}
+
+/**
+ * @brief Compare the hashes of a slot
+ *
+ * @return Slot matches the golden hashes
+ */
+bool compare(std::size_t slot, const SlotHashes & golden, const SlotHashes & actual)
+{
+    const auto mismatch = std::mismatch(golden.frames.begin(), golden.frames.end(), actual.frames.begin());
+    if (golden.frames.end() == mismatch.first)
+        return true;
+
+    const auto frame = static_cast<std::uint32_t>(mismatch.first - golden.frames.begin());
+    const std::size_t block = frame / LED_BLOCK;
+    const std::uint32_t block_end = std::min<std::uint32_t>((block + 1) * LED_BLOCK,
+            static_cast<std::uint32_t>(golden.frames.size())) - 1;
+    const std::uint8_t * const golden_leds = golden.leds.data() + (block * LED_COUNT);
+    const std::uint8_t * const actual_leds = actual.leds.data() + (block * LED_COUNT);
+    const auto led = std::mismatch(golden_leds, golden_leds + LED_COUNT, actual_leds).first - golden_leds;
+
+    if (LED_COUNT == led)
+    {
+        std::printf("slot %02zu: frame %u differs\n", slot, static_cast<unsigned>(frame));
+    }
+    else
+    {
+        std::printf("slot %02zu: frame %u differs, first LED %u (of the LEDs differing in frames %u-%u)\n", slot,
+                static_cast<unsigned>(frame), static_cast<unsigned>(led), static_cast<unsigned>(frame),
+                static_cast<unsigned>(block_end));
+    }
+    return false;
+}
+
+void printUsage(const char * name)
+{
+    std::fprintf(stderr,
+            "Usage: %s [options] GOLDEN_FILE\n"
+            "Compare hashes of the frames of all the animation slots against the golden file,\n"
+            "and check the LED data derived from the frames.\n"
+            "  -u       Update the golden file instead\n"
+            "  -f N     Number of frames per slot when updating, default %u\n"
+            "  -j N     Number of worker threads, default all cores\n",
+            name, static_cast<unsigned>(DEFAULT_FRAMES));
+}
+
+}  // namespace
+
+
+int main(int argc, char * argv[])
+{
+    bool is_update = false;
+    std::uint32_t frames = DEFAULT_FRAMES;
+    std::size_t jobs = 0;
+    int opt;
+    while (-1 != (opt = ::getopt(argc, argv, "uf:j:h")))
+    {
+        switch (opt)
+        {
+        case 'u': is_update = true; break;
+        case 'f': frames = std::strtoul(optarg, nullptr, 0); break;
+        case 'j': jobs = std::strtoul(optarg, nullptr, 0); break;
+        default:
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind + 1 != argc || 0 == frames)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+    const char * const path = argv[optind];
+
+    std::vector<SlotHashes> golden;
+    if (!is_update && !load(path, &frames, &golden))
+    {
+        std::fprintf(stderr, "Cannot read the golden file %s\n", path);
+        return 1;
+    }
+
+    std::vector<SlotHashes> results(AnimationStorage::SLOT_COUNT);
+    workers::run(workers::count(jobs, results.size()), results.size(), [&](workers::TaskQueue * queue)
+        {
+            runWorker(frames, &results, queue);
+        });
+
+    if (is_update)
+    {
+        if (!save(path, frames, results))
+        {
+            std::fprintf(stderr, "Cannot write the golden file %s\n", path);
+            return 1;
+        }
+        std::printf("Stored %zu slots of %u frames\n", results.size(), static_cast<unsigned>(frames));
+        return 0;
+    }
+
+    bool is_led_data_ok = golden::checkIndexedStrips();
+    is_led_data_ok = golden::checkSegmentedCorrection() && is_led_data_ok;
+    is_led_data_ok = golden::checkTopologies() && is_led_data_ok;
+
+    std::size_t failed = 0;
+    for (std::size_t slot = 0; slot != results.size(); ++slot)
+    {
+        if (slot >= golden.size())
+        {
+            std::printf("slot %02zu: missing in the golden file\n", slot);
+            ++failed;
+        }
+        else if (!compare(slot, golden[slot], results[slot]))
+        {
+            ++failed;
+        }
+    }
+    std::printf("%zu of %zu slots match %u golden frames\n", results.size() - failed, results.size(),
+            static_cast<unsigned>(frames));
+    return 0 == failed && is_led_data_ok ? 0 : 1;
+}
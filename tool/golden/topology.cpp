@@ -0,0 +1,126 @@
+#include "golden.hpp"
+
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+#include "led_strip.hpp"
+#include "app/topology.hpp"
+
+
+namespace
+{
+
+/**
+ * @brief Check that a matrix covers all its LEDs once and starts its second
+ *        row or column at the expected LED
+ *
+ * @param second Expected LED at `(0, 1)` for the row layouts, at `(1, 0)` for
+ *               the column layouts
+ */
+template <typename T>
+bool checkMatrix(const char * name, std::size_t second, bool is_columns)
+{
+    static LedStrip<T::LED_COUNT> strip;
+    for (LedSize led = 0; led != T::LED_COUNT; ++led)
+        strip[led] = LedState(0);
+    T::paint(strip.abstractPtr(), [](std::size_t x, std::size_t y)
+        {
+            return LedState(static_cast<std::uint32_t>((y * T::WIDTH) + x + 1));
+        });
+
+    std::vector<unsigned> hits(T::LED_COUNT);
+    for (std::size_t y = 0; y != T::HEIGHT; ++y)
+    {
+        for (std::size_t x = 0; x != T::WIDTH; ++x)
+        {
+            const LedSize led = T::index(x, y);
+            if (led >= T::LED_COUNT || T::row(y)[x] != led ||
+                    strip[led].color() != (y * T::WIDTH) + x + 1)
+            {
+                std::printf("%s: LED %u of (%zu, %zu) is wrong\n", name, static_cast<unsigned>(led), x, y);
+                return false;
+            }
+            ++hits[led];
+        }
+    }
+    for (std::size_t led = 0; led != hits.size(); ++led)
+    {
+        if (1 != hits[led])
+        {
+            std::printf("%s: LED %zu is mapped %u times\n", name, led, hits[led]);
+            return false;
+        }
+    }
+
+    const LedSize actual = is_columns ? T::index(1, 0) : T::index(0, 1);
+    if (actual != second)
+    {
+        std::printf("%s: second line starts at LED %u instead of %zu\n", name, static_cast<unsigned>(actual), second);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Check that every ring stays within its LEDs, starts at its first LED
+ *        and reaches all of them in the order of the angle
+ */
+template <typename T, std::size_t ANGLE_STEPS>
+bool checkRings(const char * name, std::initializer_list<std::size_t> lengths)
+{
+    std::size_t offset = 0;
+    std::size_t ring = 0;
+    for (const std::size_t length: lengths)
+    {
+        std::vector<bool> is_hit(length);
+        std::size_t previous = 0;
+        for (std::size_t angle = 0; angle != ANGLE_STEPS; ++angle)
+        {
+            const std::size_t led = T::index(ring, angle);
+            const bool is_in_order = 0 == angle ? offset == led : (led == previous || led == previous + 1 ||
+                    (ANGLE_STEPS / 2 < angle && offset == led));
+            if (led < offset || led >= offset + length || T::ring(ring)[angle] != led || !is_in_order)
+            {
+                std::printf("%s: LED %zu of ring %zu at angle %zu is wrong\n", name, led, ring, angle);
+                return false;
+            }
+            is_hit[led - offset] = true;
+            previous = led;
+        }
+        for (std::size_t led = 0; led != length; ++led)
+        {
+            if (!is_hit[led])
+            {
+                std::printf("%s: LED %zu of ring %zu is never reached\n", name, offset + led, ring);
+                return false;
+            }
+        }
+        offset += length;
+        ++ring;
+    }
+    if (T::LED_COUNT != offset || T::RING_COUNT != ring)
+    {
+        std::printf("%s: %zu LEDs in %zu rings expected\n", name, offset, ring);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+
+bool golden::checkTopologies()
+{
+    bool is_ok = checkMatrix<MatrixTopology<10, 10, MatrixLayout::ROWS>>("matrix 10x10 rows", 10, false);
+    is_ok = checkMatrix<MatrixTopology<10, 10>>("matrix 10x10 serpentine", 19, false) && is_ok;
+    is_ok = checkMatrix<MatrixTopology<8, 5, MatrixLayout::COLUMNS>>("matrix 8x5 columns", 5, true) && is_ok;
+    is_ok = checkMatrix<MatrixTopology<7, 3, MatrixLayout::COLUMNS_SERPENTINE>>("matrix 7x3 serpentine columns", 5,
+            true) && is_ok;
+    is_ok = checkRings<RingTopology<60, 60, 24, 12, 1>, 60>("rings 60+24+12+1", {60, 24, 12, 1}) && is_ok;
+    is_ok = checkRings<RingTopology<16, 8, 16>, 16>("rings 8+16", {8, 16}) && is_ok;
+
+    if (is_ok)
+        std::printf("topologies map every LED once\n");
+    return is_ok;
+}
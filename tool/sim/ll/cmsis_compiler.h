@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @brief Host stand-in of the CMSIS compiler intrinsics
+ *
+ * The interrupt mask and the sleep are routed to the simulated core, which
+ * dispatches the pending interrupts once they are unmasked.
+ */
+
+#ifndef CMSIS_COMPILER_H_
+#define CMSIS_COMPILER_H_
+
+#include <atomic>
+#include <cstdint>
+
+
+namespace sim
+{
+
+std::uint32_t getPrimask();
+void setPrimask(std::uint32_t primask);
+void waitForInterrupt();
+
+}  // namespace sim
+
+
+inline void __DMB()
+{
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+inline void __DSB()
+{
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+inline void __ISB()
+{
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+inline std::uint32_t __get_PRIMASK()
+{
+    return sim::getPrimask();
+}
+
+inline void __set_PRIMASK(std::uint32_t primask)
+{
+    sim::setPrimask(primask);
+}
+
+inline void __disable_irq()
+{
+    sim::setPrimask(1);
+}
+
+inline void __enable_irq()
+{
+    sim::setPrimask(0);
+}
+
+inline void __WFI()
+{
+    sim::waitForInterrupt();
+}
+
+
+#endif  // CMSIS_COMPILER_H_
@@ -0,0 +1,215 @@
+/**
+ * @file
+ * @brief Host stand-in of the STM32G0 device header
+ *
+ * Declares only the peripherals and registers used by the firmware drivers.
+ * Register layouts are simplified, the bits are interpreted by the peripheral
+ * model in `tool/sim/machine.cpp`. Fields holding addresses are wide enough
+ * for host pointers.
+ */
+
+#ifndef STM32G0XX_H_
+#define STM32G0XX_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cmsis_compiler.h"
+
+
+typedef enum
+{
+    SUCCESS = 0U,
+    ERROR = !SUCCESS,
+} ErrorStatus;
+
+typedef enum
+{
+    SysTick_IRQn = -1,
+    DMA1_Channel1_IRQn = 9,
+    DMA1_Channel2_3_IRQn = 10,
+    DMA1_Ch4_7_DMAMUX1_OVR_IRQn = 11,
+    TIM1_BRK_UP_TRG_COM_IRQn = 13,
+    TIM3_IRQn = 16,
+    TIM6_DAC_LPTIM1_IRQn = 17,
+    TIM16_IRQn = 21,
+    I2C1_IRQn = 23,
+    I2C2_IRQn = 24,
+} IRQn_Type;
+
+
+struct TIM_TypeDef
+{
+    volatile std::uint32_t CR1;
+    volatile std::uint32_t DIER;
+    volatile std::uint32_t SR;
+    volatile std::uint32_t CCER;
+    volatile std::uint32_t CNT;
+    volatile std::uint32_t PSC;
+    volatile std::uint32_t ARR;
+    volatile std::uint32_t RCR;
+    volatile std::uint32_t CCR1;
+    volatile std::uint32_t CCR2;
+    volatile std::uint32_t CCR3;
+    volatile std::uint32_t CCR4;
+    volatile std::uint32_t DCR;
+    volatile std::uint32_t DMAR;
+};
+
+#define TIM_CR1_CEN (1U << 0)
+#define TIM_CR1_OPM (1U << 3)
+#define TIM_CR1_ARPE (1U << 7)
+#define TIM_DIER_UIE (1U << 0)
+#define TIM_DIER_CC3IE (1U << 3)
+#define TIM_DIER_UDE (1U << 8)
+#define TIM_DIER_CC1DE (1U << 9)
+#define TIM_SR_CC3IF (1U << 3)
+#define TIM_DCR_DBA_Pos 0U
+#define TIM_DCR_DBA_Msk (0x1FU << TIM_DCR_DBA_Pos)
+#define TIM_DCR_DBL_Pos 8U
+#define TIM_DCR_DBL_Msk (0x1FU << TIM_DCR_DBL_Pos)
+
+
+struct DMA_Channel_TypeDef
+{
+    volatile std::uint32_t CCR;
+    volatile std::uint32_t CNDTR;
+    volatile std::uintptr_t CPAR;
+    volatile std::uintptr_t CMAR;
+};
+
+struct DMA_TypeDef
+{
+    volatile std::uint32_t ISR;
+    DMA_Channel_TypeDef CHANNEL[7];
+};
+
+#define DMA_CCR_EN (1U << 0)
+#define DMA_CCR_TCIE (1U << 1)
+#define DMA_CCR_HTIE (1U << 2)
+#define DMA_CCR_TEIE (1U << 3)
+#define DMA_CCR_DIR (1U << 4)
+#define DMA_CCR_CIRC (1U << 5)
+#define DMA_CCR_PINC (1U << 6)
+#define DMA_CCR_MINC (1U << 7)
+#define DMA_CCR_PSIZE_Pos 8U
+#define DMA_CCR_PSIZE (3U << DMA_CCR_PSIZE_Pos)
+#define DMA_CCR_MSIZE_Pos 10U
+#define DMA_CCR_MSIZE (3U << DMA_CCR_MSIZE_Pos)
+#define DMA_CCR_PL_Pos 12U
+#define DMA_CCR_PL (3U << DMA_CCR_PL_Pos)
+
+#define DMA_ISR_GIF(ch) (1U << (4 * (ch)))
+#define DMA_ISR_TCIF(ch) (2U << (4 * (ch)))
+#define DMA_ISR_HTIF(ch) (4U << (4 * (ch)))
+#define DMA_ISR_TEIF(ch) (8U << (4 * (ch)))
+
+
+struct DMAMUX_Channel_TypeDef
+{
+    volatile std::uint32_t CCR;
+};
+
+#define DMAMUX_CxCR_DMAREQ_ID_Msk 0x7FU
+
+
+struct I2C_TypeDef
+{
+    volatile std::uint32_t CR1;
+    volatile std::uint32_t CR2;
+    volatile std::uint32_t TIMINGR;
+    volatile std::uint32_t ISR;
+    volatile std::uint32_t RXDR;
+    volatile std::uint32_t TXDR;
+};
+
+#define I2C_CR1_PE (1U << 0)
+#define I2C_CR1_NACKIE (1U << 4)
+#define I2C_CR1_TCIE (1U << 6)
+#define I2C_CR1_ERRIE (1U << 7)
+#define I2C_CR1_TXDMAEN (1U << 14)
+#define I2C_CR1_RXDMAEN (1U << 15)
+#define I2C_CR2_SADD_Msk 0x3FFU
+#define I2C_CR2_RD_WRN (1U << 10)
+#define I2C_CR2_START (1U << 13)
+#define I2C_CR2_STOP (1U << 14)
+#define I2C_CR2_NBYTES_Pos 16U
+#define I2C_CR2_NBYTES_Msk (0xFFU << I2C_CR2_NBYTES_Pos)
+#define I2C_CR2_RELOAD (1U << 24)
+#define I2C_CR2_AUTOEND (1U << 25)
+#define I2C_ISR_NACKF (1U << 4)
+#define I2C_ISR_TC (1U << 6)
+#define I2C_ISR_TCR (1U << 7)
+#define I2C_ISR_BERR (1U << 8)
+#define I2C_ISR_ARLO (1U << 9)
+#define I2C_ISR_BUSY (1U << 15)
+
+
+struct GPIO_TypeDef
+{
+    volatile std::uint32_t MODER;
+    volatile std::uint32_t IDR;
+    volatile std::uint32_t ODR;
+};
+
+
+extern TIM_TypeDef sim_tim1, sim_tim3, sim_tim6, sim_tim16;
+extern DMA_TypeDef sim_dma1;
+extern DMAMUX_Channel_TypeDef sim_dmamux1[7];
+extern I2C_TypeDef sim_i2c1, sim_i2c2;
+extern GPIO_TypeDef sim_gpioa, sim_gpiob, sim_gpioc;
+
+#define TIM1 (&sim_tim1)
+#define TIM3 (&sim_tim3)
+#define TIM6 (&sim_tim6)
+#define TIM16 (&sim_tim16)
+#define DMA1 (&sim_dma1)
+#define DMAMUX1 (sim_dmamux1)
+#define I2C1 (&sim_i2c1)
+#define I2C2 (&sim_i2c2)
+#define GPIOA (&sim_gpioa)
+#define GPIOB (&sim_gpiob)
+#define GPIOC (&sim_gpioc)
+
+extern std::uint32_t SystemCoreClock;
+
+
+/**
+ * @brief Hooks of the peripheral model, called by the stand-in LL functions
+ */
+namespace sim
+{
+
+void enableIrq(IRQn_Type irq);
+std::uint32_t configureSysTick(std::uint32_t ticks);
+
+std::uint32_t timerCounter(const TIM_TypeDef * tim);
+void timerEnabled(TIM_TypeDef * tim);
+void timerUpdateEvent(TIM_TypeDef * tim);
+
+void dmaChannelEnabled(DMA_TypeDef * dma, std::uint32_t channel);
+
+void i2cTransfer(I2C_TypeDef * i2c);
+void i2cStop(I2C_TypeDef * i2c);
+
+}  // namespace sim
+
+
+inline void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    sim::enableIrq(irq);
+}
+
+inline void NVIC_SetPriority(IRQn_Type irq, std::uint32_t priority)
+{
+    (void) irq;
+    (void) priority;
+}
+
+inline std::uint32_t SysTick_Config(std::uint32_t ticks)
+{
+    return sim::configureSysTick(ticks);
+}
+
+
+#endif  // STM32G0XX_H_
@@ -0,0 +1,37 @@
+/**
+ * @file
+ * @brief Host stand-in of the bus LL driver, peripheral clocks are always on
+ */
+
+#ifndef STM32G0XX_LL_BUS_H_
+#define STM32G0XX_LL_BUS_H_
+
+#include "stm32g0xx.h"
+
+
+#define LL_IOP_GRP1_PERIPH_GPIOA (1U << 0)
+#define LL_IOP_GRP1_PERIPH_GPIOB (1U << 1)
+#define LL_IOP_GRP1_PERIPH_GPIOC (1U << 2)
+
+#define LL_AHB1_GRP1_PERIPH_DMA1 (1U << 0)
+
+#define LL_APB1_GRP1_PERIPH_TIM3 (1U << 1)
+#define LL_APB1_GRP1_PERIPH_TIM6 (1U << 4)
+#define LL_APB1_GRP1_PERIPH_WWDG (1U << 11)
+#define LL_APB1_GRP1_PERIPH_USART2 (1U << 17)
+#define LL_APB1_GRP1_PERIPH_USART3 (1U << 18)
+#define LL_APB1_GRP1_PERIPH_I2C1 (1U << 21)
+#define LL_APB1_GRP1_PERIPH_I2C2 (1U << 22)
+
+#define LL_APB2_GRP1_PERIPH_SYSCFG (1U << 0)
+#define LL_APB2_GRP1_PERIPH_TIM1 (1U << 11)
+#define LL_APB2_GRP1_PERIPH_TIM16 (1U << 17)
+
+
+inline void LL_IOP_GRP1_EnableClock(std::uint32_t periphs) { (void) periphs; }
+inline void LL_AHB1_GRP1_EnableClock(std::uint32_t periphs) { (void) periphs; }
+inline void LL_APB1_GRP1_EnableClock(std::uint32_t periphs) { (void) periphs; }
+inline void LL_APB2_GRP1_EnableClock(std::uint32_t periphs) { (void) periphs; }
+
+
+#endif  // STM32G0XX_LL_BUS_H_
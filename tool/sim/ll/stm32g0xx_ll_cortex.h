@@ -0,0 +1,12 @@
+/**
+ * @file
+ * @brief Host stand-in of the Cortex LL driver
+ */
+
+#ifndef STM32G0XX_LL_CORTEX_H_
+#define STM32G0XX_LL_CORTEX_H_
+
+#include "stm32g0xx.h"
+
+
+#endif  // STM32G0XX_LL_CORTEX_H_
@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @brief Host stand-in of the DMA LL driver
+ *
+ * Transfers are performed by the peripheral model whenever the peripheral
+ * selected by the DMAMUX requests them.
+ */
+
+#ifndef STM32G0XX_LL_DMA_H_
+#define STM32G0XX_LL_DMA_H_
+
+#include "stm32g0xx.h"
+#include "stm32g0xx_ll_dmamux.h"
+
+
+#define LL_DMA_CHANNEL_1 0U
+#define LL_DMA_CHANNEL_2 1U
+#define LL_DMA_CHANNEL_3 2U
+#define LL_DMA_CHANNEL_4 3U
+#define LL_DMA_CHANNEL_5 4U
+#define LL_DMA_CHANNEL_6 5U
+#define LL_DMA_CHANNEL_7 6U
+
+#define LL_DMA_DIRECTION_PERIPH_TO_MEMORY 0U
+#define LL_DMA_DIRECTION_MEMORY_TO_PERIPH DMA_CCR_DIR
+
+#define LL_DMA_MODE_NORMAL 0U
+#define LL_DMA_MODE_CIRCULAR DMA_CCR_CIRC
+
+#define LL_DMA_PERIPH_NOINCREMENT 0U
+#define LL_DMA_PERIPH_INCREMENT DMA_CCR_PINC
+#define LL_DMA_MEMORY_NOINCREMENT 0U
+#define LL_DMA_MEMORY_INCREMENT DMA_CCR_MINC
+
+#define LL_DMA_PDATAALIGN_BYTE (0U << DMA_CCR_PSIZE_Pos)
+#define LL_DMA_PDATAALIGN_HALFWORD (1U << DMA_CCR_PSIZE_Pos)
+#define LL_DMA_PDATAALIGN_WORD (2U << DMA_CCR_PSIZE_Pos)
+#define LL_DMA_MDATAALIGN_BYTE (0U << DMA_CCR_MSIZE_Pos)
+#define LL_DMA_MDATAALIGN_HALFWORD (1U << DMA_CCR_MSIZE_Pos)
+#define LL_DMA_MDATAALIGN_WORD (2U << DMA_CCR_MSIZE_Pos)
+
+#define LL_DMA_PRIORITY_LOW (0U << DMA_CCR_PL_Pos)
+#define LL_DMA_PRIORITY_MEDIUM (1U << DMA_CCR_PL_Pos)
+#define LL_DMA_PRIORITY_HIGH (2U << DMA_CCR_PL_Pos)
+#define LL_DMA_PRIORITY_VERYHIGH (3U << DMA_CCR_PL_Pos)
+
+/** @brief Bits of the channel configuration set by @ref LL_DMA_ConfigTransfer() */
+#define SIM_DMA_CONFIG_MASK (DMA_CCR_DIR | DMA_CCR_CIRC | DMA_CCR_PINC | DMA_CCR_MINC | DMA_CCR_PSIZE | \
+        DMA_CCR_MSIZE | DMA_CCR_PL)
+
+
+inline void LL_DMA_EnableChannel(DMA_TypeDef * dma, std::uint32_t channel)
+{
+    dma->CHANNEL[channel].CCR |= DMA_CCR_EN;
+    sim::dmaChannelEnabled(dma, channel);
+}
+
+inline void LL_DMA_DisableChannel(DMA_TypeDef * dma, std::uint32_t channel)
+{
+    dma->CHANNEL[channel].CCR &= ~DMA_CCR_EN;
+}
+
+inline std::uint32_t LL_DMA_IsEnabledChannel(const DMA_TypeDef * dma, std::uint32_t channel)
+{
+    return (dma->CHANNEL[channel].CCR & DMA_CCR_EN) ? 1 : 0;
+}
+
+inline void LL_DMA_ConfigTransfer(DMA_TypeDef * dma, std::uint32_t channel, std::uint32_t configuration)
+{
+    auto & ccr = dma->CHANNEL[channel].CCR;
+    ccr = (ccr & ~SIM_DMA_CONFIG_MASK) | (configuration & SIM_DMA_CONFIG_MASK);
+}
+
+inline void LL_DMA_SetDataTransferDirection(DMA_TypeDef * dma, std::uint32_t channel, std::uint32_t direction)
+{
+    auto & ccr = dma->CHANNEL[channel].CCR;
+    ccr = (ccr & ~DMA_CCR_DIR) | direction;
+}
+
+inline void LL_DMA_SetPeriphAddress(DMA_TypeDef * dma, std::uint32_t channel, std::uintptr_t address)
+{
+    dma->CHANNEL[channel].CPAR = address;
+}
+
+inline void LL_DMA_SetMemoryAddress(DMA_TypeDef * dma, std::uint32_t channel, std::uintptr_t address)
+{
+    dma->CHANNEL[channel].CMAR = address;
+}
+
+inline void LL_DMA_SetDataLength(DMA_TypeDef * dma, std::uint32_t channel, std::uint32_t length)
+{
+    dma->CHANNEL[channel].CNDTR = length & 0xFFFF;
+}
+
+inline std::uint32_t LL_DMA_GetDataLength(const DMA_TypeDef * dma, std::uint32_t channel)
+{
+    return dma->CHANNEL[channel].CNDTR;
+}
+
+inline void LL_DMA_EnableIT_TC(DMA_TypeDef * dma, std::uint32_t channel) { dma->CHANNEL[channel].CCR |= DMA_CCR_TCIE; }
+inline void LL_DMA_EnableIT_HT(DMA_TypeDef * dma, std::uint32_t channel) { dma->CHANNEL[channel].CCR |= DMA_CCR_HTIE; }
+inline void LL_DMA_EnableIT_TE(DMA_TypeDef * dma, std::uint32_t channel) { dma->CHANNEL[channel].CCR |= DMA_CCR_TEIE; }
+inline void LL_DMA_DisableIT_TC(DMA_TypeDef * dma, std::uint32_t channel) { dma->CHANNEL[channel].CCR &= ~DMA_CCR_TCIE; }
+inline void LL_DMA_DisableIT_HT(DMA_TypeDef * dma, std::uint32_t channel) { dma->CHANNEL[channel].CCR &= ~DMA_CCR_HTIE; }
+inline void LL_DMA_DisableIT_TE(DMA_TypeDef * dma, std::uint32_t channel) { dma->CHANNEL[channel].CCR &= ~DMA_CCR_TEIE; }
+
+
+#define SIM_DMA_FLAG_FUNCTIONS(flag, channel)  \
+    inline std::uint32_t LL_DMA_IsActiveFlag_ ## flag ## channel(const DMA_TypeDef * dma)  \
+    {  \
+        return (dma->ISR & DMA_ISR_ ## flag ## IF((channel) - 1)) ? 1 : 0;  \
+    }  \
+    inline void LL_DMA_ClearFlag_ ## flag ## channel(DMA_TypeDef * dma)  \
+    {  \
+        dma->ISR &= ~(DMA_ISR_ ## flag ## IF((channel) - 1) | DMA_ISR_GIF((channel) - 1));  \
+    }
+
+#define SIM_DMA_CHANNEL_FLAG_FUNCTIONS(channel)  \
+    SIM_DMA_FLAG_FUNCTIONS(TC, channel)  \
+    SIM_DMA_FLAG_FUNCTIONS(HT, channel)  \
+    SIM_DMA_FLAG_FUNCTIONS(TE, channel)
+
+SIM_DMA_CHANNEL_FLAG_FUNCTIONS(1)
+SIM_DMA_CHANNEL_FLAG_FUNCTIONS(2)
+SIM_DMA_CHANNEL_FLAG_FUNCTIONS(3)
+SIM_DMA_CHANNEL_FLAG_FUNCTIONS(4)
+SIM_DMA_CHANNEL_FLAG_FUNCTIONS(5)
+SIM_DMA_CHANNEL_FLAG_FUNCTIONS(6)
+SIM_DMA_CHANNEL_FLAG_FUNCTIONS(7)
+
+#undef SIM_DMA_CHANNEL_FLAG_FUNCTIONS
+#undef SIM_DMA_FLAG_FUNCTIONS
+
+
+#endif  // STM32G0XX_LL_DMA_H_
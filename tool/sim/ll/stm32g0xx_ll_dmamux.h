@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Host stand-in of the DMAMUX LL driver
+ */
+
+#ifndef STM32G0XX_LL_DMAMUX_H_
+#define STM32G0XX_LL_DMAMUX_H_
+
+#include "stm32g0xx.h"
+
+
+#define LL_DMAMUX_CHANNEL_0 0U
+#define LL_DMAMUX_CHANNEL_1 1U
+#define LL_DMAMUX_CHANNEL_2 2U
+#define LL_DMAMUX_CHANNEL_3 3U
+#define LL_DMAMUX_CHANNEL_4 4U
+#define LL_DMAMUX_CHANNEL_5 5U
+#define LL_DMAMUX_CHANNEL_6 6U
+
+#define LL_DMAMUX_REQ_MEM2MEM 0U
+#define LL_DMAMUX_REQ_I2C1_RX 10U
+#define LL_DMAMUX_REQ_I2C1_TX 11U
+#define LL_DMAMUX_REQ_I2C2_RX 12U
+#define LL_DMAMUX_REQ_I2C2_TX 13U
+#define LL_DMAMUX_REQ_TIM1_UP 25U
+#define LL_DMAMUX_REQ_TIM3_CH1 32U
+#define LL_DMAMUX_REQ_TIM3_UP 36U
+#define LL_DMAMUX_REQ_TIM16_UP 46U
+
+
+inline void LL_DMAMUX_SetRequestID(DMAMUX_Channel_TypeDef * dmamux, std::uint32_t channel, std::uint32_t request)
+{
+    dmamux[channel].CCR = (dmamux[channel].CCR & ~DMAMUX_CxCR_DMAREQ_ID_Msk) | request;
+}
+
+inline void LL_DMAMUX_DisableEventGeneration(DMAMUX_Channel_TypeDef * dmamux, std::uint32_t channel)
+{
+    (void) dmamux;
+    (void) channel;
+}
+
+inline void LL_DMAMUX_DisableSync(DMAMUX_Channel_TypeDef * dmamux, std::uint32_t channel)
+{
+    (void) dmamux;
+    (void) channel;
+}
+
+inline void LL_DMAMUX_DisableRequestGen(DMAMUX_Channel_TypeDef * dmamux, std::uint32_t channel)
+{
+    (void) dmamux;
+    (void) channel;
+}
+
+
+#endif  // STM32G0XX_LL_DMAMUX_H_
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Host stand-in of the GPIO LL driver
+ *
+ * Input levels are driven by the peripheral model (e.g. scripted key presses).
+ */
+
+#ifndef STM32G0XX_LL_GPIO_H_
+#define STM32G0XX_LL_GPIO_H_
+
+#include "stm32g0xx.h"
+
+
+#define LL_GPIO_PIN_0 (1U << 0)
+#define LL_GPIO_PIN_1 (1U << 1)
+#define LL_GPIO_PIN_2 (1U << 2)
+#define LL_GPIO_PIN_3 (1U << 3)
+#define LL_GPIO_PIN_4 (1U << 4)
+#define LL_GPIO_PIN_5 (1U << 5)
+#define LL_GPIO_PIN_6 (1U << 6)
+#define LL_GPIO_PIN_7 (1U << 7)
+#define LL_GPIO_PIN_8 (1U << 8)
+#define LL_GPIO_PIN_9 (1U << 9)
+#define LL_GPIO_PIN_10 (1U << 10)
+#define LL_GPIO_PIN_11 (1U << 11)
+#define LL_GPIO_PIN_12 (1U << 12)
+#define LL_GPIO_PIN_13 (1U << 13)
+#define LL_GPIO_PIN_14 (1U << 14)
+#define LL_GPIO_PIN_15 (1U << 15)
+
+#define LL_GPIO_MODE_INPUT 0U
+#define LL_GPIO_MODE_OUTPUT 1U
+#define LL_GPIO_MODE_ALTERNATE 2U
+#define LL_GPIO_MODE_ANALOG 3U
+
+#define LL_GPIO_OUTPUT_PUSHPULL 0U
+#define LL_GPIO_OUTPUT_OPENDRAIN 1U
+
+#define LL_GPIO_SPEED_FREQ_VERY_LOW 0U
+#define LL_GPIO_SPEED_FREQ_LOW 1U
+#define LL_GPIO_SPEED_FREQ_MEDIUM 2U
+#define LL_GPIO_SPEED_FREQ_HIGH 3U
+
+#define LL_GPIO_PULL_NO 0U
+#define LL_GPIO_PULL_UP 1U
+#define LL_GPIO_PULL_DOWN 2U
+
+#define LL_GPIO_AF_0 0U
+#define LL_GPIO_AF_1 1U
+#define LL_GPIO_AF_2 2U
+#define LL_GPIO_AF_3 3U
+#define LL_GPIO_AF_4 4U
+#define LL_GPIO_AF_5 5U
+#define LL_GPIO_AF_6 6U
+#define LL_GPIO_AF_7 7U
+
+
+struct LL_GPIO_InitTypeDef
+{
+    std::uint32_t Pin;
+    std::uint32_t Mode;
+    std::uint32_t Speed;
+    std::uint32_t OutputType;
+    std::uint32_t Pull;
+    std::uint32_t Alternate;
+};
+
+
+inline void LL_GPIO_StructInit(LL_GPIO_InitTypeDef * init)
+{
+    *init = {0xFFFF, LL_GPIO_MODE_ANALOG, LL_GPIO_SPEED_FREQ_LOW, LL_GPIO_OUTPUT_PUSHPULL, LL_GPIO_PULL_NO,
+            LL_GPIO_AF_0};
+}
+
+inline ErrorStatus LL_GPIO_Init(GPIO_TypeDef * gpio, const LL_GPIO_InitTypeDef * init)
+{
+    // Two mode bits per pin
+    for (std::uint32_t pin = 0; pin != 16; ++pin)
+    {
+        if (init->Pin & (1U << pin))
+            gpio->MODER = (gpio->MODER & ~(3U << (2 * pin))) | (init->Mode << (2 * pin));
+    }
+    return SUCCESS;
+}
+
+inline std::uint32_t LL_GPIO_IsInputPinSet(const GPIO_TypeDef * gpio, std::uint32_t pin_mask)
+{
+    return (gpio->IDR & pin_mask) == pin_mask;
+}
+
+inline void LL_GPIO_SetOutputPin(GPIO_TypeDef * gpio, std::uint32_t pin_mask)
+{
+    gpio->ODR |= pin_mask;
+}
+
+inline void LL_GPIO_ResetOutputPin(GPIO_TypeDef * gpio, std::uint32_t pin_mask)
+{
+    gpio->ODR &= ~pin_mask;
+}
+
+
+#endif  // STM32G0XX_LL_GPIO_H_
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief Host stand-in of the I2C LL driver
+ *
+ * The transfers are carried out by the peripheral model, which answers on
+ * behalf of the simulated slave devices.
+ */
+
+#ifndef STM32G0XX_LL_I2C_H_
+#define STM32G0XX_LL_I2C_H_
+
+#include "stm32g0xx.h"
+
+
+#define LL_I2C_MODE_I2C 0U
+#define LL_I2C_ANALOGFILTER_ENABLE 0U
+#define LL_I2C_NACK (1U << 15)
+#define LL_I2C_OWNADDRESS1_7BIT 0U
+#define LL_I2C_ADDRESSING_MODE_7BIT 0U
+#define LL_I2C_ADDRSLAVE_7BIT 0U
+#define LL_I2C_SMBUS_ALL_TIMEOUT 0x80008000U
+
+#define LL_I2C_MODE_RELOAD I2C_CR2_RELOAD
+#define LL_I2C_MODE_AUTOEND I2C_CR2_AUTOEND
+#define LL_I2C_MODE_SOFTEND 0U
+
+#define LL_I2C_GENERATE_NOSTARTSTOP 0U
+#define LL_I2C_GENERATE_STOP I2C_CR2_STOP
+#define LL_I2C_GENERATE_START_READ (I2C_CR2_START | I2C_CR2_RD_WRN)
+#define LL_I2C_GENERATE_START_WRITE I2C_CR2_START
+#define LL_I2C_GENERATE_RESTART_7BIT_READ (I2C_CR2_START | I2C_CR2_RD_WRN)
+#define LL_I2C_GENERATE_RESTART_7BIT_WRITE I2C_CR2_START
+
+#define LL_I2C_DMA_REG_DATA_TRANSMIT 0U
+#define LL_I2C_DMA_REG_DATA_RECEIVE 1U
+
+#define __LL_I2C_CONVERT_TIMINGS(presc, scldel, sdadel, sclh, scll)  \
+    (((presc) << 28) | ((scldel) << 20) | ((sdadel) << 16) | ((sclh) << 8) | (scll))
+
+
+struct LL_I2C_InitTypeDef
+{
+    std::uint32_t PeripheralMode;
+    std::uint32_t Timing;
+    std::uint32_t AnalogFilter;
+    std::uint32_t DigitalFilter;
+    std::uint32_t OwnAddress1;
+    std::uint32_t TypeAcknowledge;
+    std::uint32_t OwnAddrSize;
+};
+
+
+inline void LL_I2C_StructInit(LL_I2C_InitTypeDef * init)
+{
+    *init = {LL_I2C_MODE_I2C, 0, LL_I2C_ANALOGFILTER_ENABLE, 0, 0, LL_I2C_NACK, LL_I2C_OWNADDRESS1_7BIT};
+}
+
+inline ErrorStatus LL_I2C_Init(I2C_TypeDef * i2c, const LL_I2C_InitTypeDef * init)
+{
+    i2c->TIMINGR = init->Timing;
+    i2c->CR1 |= I2C_CR1_PE;
+    return SUCCESS;
+}
+
+inline void LL_I2C_SetMasterAddressingMode(I2C_TypeDef * i2c, std::uint32_t mode) { (void) i2c; (void) mode; }
+inline void LL_I2C_DisableOwnAddress2(I2C_TypeDef * i2c) { (void) i2c; }
+inline void LL_I2C_DisableSMBusTimeout(I2C_TypeDef * i2c, std::uint32_t timeout) { (void) i2c; (void) timeout; }
+
+inline void LL_I2C_DisableAutoEndMode(I2C_TypeDef * i2c) { i2c->CR2 &= ~I2C_CR2_AUTOEND; }
+inline void LL_I2C_DisableReloadMode(I2C_TypeDef * i2c) { i2c->CR2 &= ~I2C_CR2_RELOAD; }
+
+inline void LL_I2C_SetTransferSize(I2C_TypeDef * i2c, std::uint32_t size)
+{
+    i2c->CR2 = (i2c->CR2 & ~I2C_CR2_NBYTES_Msk) | (size << I2C_CR2_NBYTES_Pos);
+}
+
+inline void LL_I2C_EnableIT_NACK(I2C_TypeDef * i2c) { i2c->CR1 |= I2C_CR1_NACKIE; }
+inline void LL_I2C_EnableIT_TC(I2C_TypeDef * i2c) { i2c->CR1 |= I2C_CR1_TCIE; }
+inline void LL_I2C_EnableIT_ERR(I2C_TypeDef * i2c) { i2c->CR1 |= I2C_CR1_ERRIE; }
+
+inline void LL_I2C_EnableDMAReq_RX(I2C_TypeDef * i2c) { i2c->CR1 |= I2C_CR1_RXDMAEN; }
+inline void LL_I2C_DisableDMAReq_RX(I2C_TypeDef * i2c) { i2c->CR1 &= ~I2C_CR1_RXDMAEN; }
+inline void LL_I2C_EnableDMAReq_TX(I2C_TypeDef * i2c) { i2c->CR1 |= I2C_CR1_TXDMAEN; }
+inline void LL_I2C_DisableDMAReq_TX(I2C_TypeDef * i2c) { i2c->CR1 &= ~I2C_CR1_TXDMAEN; }
+
+inline std::uintptr_t LL_I2C_DMA_GetRegAddr(I2C_TypeDef * i2c, std::uint32_t direction)
+{
+    if (LL_I2C_DMA_REG_DATA_TRANSMIT == direction)
+        return reinterpret_cast<std::uintptr_t>(&(i2c->TXDR));
+    return reinterpret_cast<std::uintptr_t>(&(i2c->RXDR));
+}
+
+inline void LL_I2C_HandleTransfer(I2C_TypeDef * i2c, std::uint32_t slave_address, std::uint32_t slave_address_size,
+        std::uint32_t transfer_size, std::uint32_t end_mode, std::uint32_t request)
+{
+    i2c->CR2 = (slave_address & I2C_CR2_SADD_Msk) | slave_address_size |
+            ((transfer_size << I2C_CR2_NBYTES_Pos) & I2C_CR2_NBYTES_Msk) | end_mode | request;
+    sim::i2cTransfer(i2c);
+}
+
+inline void LL_I2C_GenerateStopCondition(I2C_TypeDef * i2c)
+{
+    i2c->CR2 |= I2C_CR2_STOP;
+    sim::i2cStop(i2c);
+}
+
+inline std::uint32_t LL_I2C_IsActiveFlag_TC(const I2C_TypeDef * i2c) { return (i2c->ISR & I2C_ISR_TC) ? 1 : 0; }
+inline std::uint32_t LL_I2C_IsActiveFlag_TCR(const I2C_TypeDef * i2c) { return (i2c->ISR & I2C_ISR_TCR) ? 1 : 0; }
+inline std::uint32_t LL_I2C_IsActiveFlag_NACK(const I2C_TypeDef * i2c) { return (i2c->ISR & I2C_ISR_NACKF) ? 1 : 0; }
+inline std::uint32_t LL_I2C_IsActiveFlag_ARLO(const I2C_TypeDef * i2c) { return (i2c->ISR & I2C_ISR_ARLO) ? 1 : 0; }
+inline std::uint32_t LL_I2C_IsActiveFlag_BERR(const I2C_TypeDef * i2c) { return (i2c->ISR & I2C_ISR_BERR) ? 1 : 0; }
+
+inline void LL_I2C_ClearFlag_NACK(I2C_TypeDef * i2c) { i2c->ISR &= ~I2C_ISR_NACKF; }
+inline void LL_I2C_ClearFlag_ARLO(I2C_TypeDef * i2c) { i2c->ISR &= ~I2C_ISR_ARLO; }
+inline void LL_I2C_ClearFlag_BERR(I2C_TypeDef * i2c) { i2c->ISR &= ~I2C_ISR_BERR; }
+
+
+#endif  // STM32G0XX_LL_I2C_H_
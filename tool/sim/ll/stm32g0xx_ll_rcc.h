@@ -0,0 +1,65 @@
+/**
+ * @file
+ * @brief Host stand-in of the RCC LL driver, oscillators are ready immediately
+ */
+
+#ifndef STM32G0XX_LL_RCC_H_
+#define STM32G0XX_LL_RCC_H_
+
+#include "stm32g0xx.h"
+
+
+#define LL_RCC_PLLSOURCE_HSI 2U
+#define LL_RCC_PLLM_DIV_1 0U
+#define LL_RCC_PLLR_DIV_2 (1U << 29)
+#define LL_RCC_SYSCLK_DIV_1 0U
+#define LL_RCC_APB1_DIV_1 0U
+#define LL_RCC_SYS_CLKSOURCE_PLL 2U
+#define LL_RCC_SYS_CLKSOURCE_STATUS_PLL (2U << 3)
+#define LL_RCC_I2C1_CLKSOURCE_PCLK1 0U
+
+
+namespace sim
+{
+
+/** @brief Selected source of the system clock */
+inline std::uint32_t sys_clk_source = 0;
+
+}  // namespace sim
+
+
+inline void LL_RCC_HSI_Enable() { }
+inline std::uint32_t LL_RCC_HSI_IsReady() { return 1; }
+inline void LL_RCC_LSI_Enable() { }
+inline std::uint32_t LL_RCC_LSI_IsReady() { return 1; }
+
+inline void LL_RCC_PLL_ConfigDomain_SYS(std::uint32_t source, std::uint32_t pllm, std::uint32_t plln,
+        std::uint32_t pllr)
+{
+    (void) source;
+    (void) pllm;
+    (void) plln;
+    (void) pllr;
+}
+
+inline void LL_RCC_PLL_Enable() { }
+inline void LL_RCC_PLL_EnableDomain_SYS() { }
+inline std::uint32_t LL_RCC_PLL_IsReady() { return 1; }
+
+inline void LL_RCC_SetAHBPrescaler(std::uint32_t prescaler) { (void) prescaler; }
+inline void LL_RCC_SetAPB1Prescaler(std::uint32_t prescaler) { (void) prescaler; }
+
+inline void LL_RCC_SetSysClkSource(std::uint32_t source)
+{
+    sim::sys_clk_source = source;
+}
+
+inline std::uint32_t LL_RCC_GetSysClkSource()
+{
+    return sim::sys_clk_source << 3;
+}
+
+inline void LL_RCC_SetI2CClockSource(std::uint32_t source) { (void) source; }
+
+
+#endif  // STM32G0XX_LL_RCC_H_
@@ -0,0 +1,41 @@
+/**
+ * @file
+ * @brief Host stand-in of the system LL driver
+ */
+
+#ifndef STM32G0XX_LL_SYSTEM_H_
+#define STM32G0XX_LL_SYSTEM_H_
+
+#include "stm32g0xx.h"
+
+
+#define LL_FLASH_LATENCY_2 2U
+#define LL_SYSCFG_I2C_FASTMODEPLUS_PB8 (1U << 18)
+#define LL_SYSCFG_I2C_FASTMODEPLUS_PB9 (1U << 19)
+#define LL_DBGMCU_APB1_GRP1_TIM6_STOP (1U << 4)
+
+
+namespace sim
+{
+
+/** @brief Flash wait states */
+inline std::uint32_t flash_latency = 0;
+
+}  // namespace sim
+
+
+inline void LL_FLASH_SetLatency(std::uint32_t latency)
+{
+    sim::flash_latency = latency;
+}
+
+inline std::uint32_t LL_FLASH_GetLatency()
+{
+    return sim::flash_latency;
+}
+
+inline void LL_SYSCFG_DisableFastModePlus(std::uint32_t config) { (void) config; }
+inline void LL_DBGMCU_APB1_GRP1_FreezePeriph(std::uint32_t periphs) { (void) periphs; }
+
+
+#endif  // STM32G0XX_LL_SYSTEM_H_
@@ -0,0 +1,242 @@
+/**
+ * @file
+ * @brief Host stand-in of the timer LL driver
+ *
+ * Only the registers observed by the peripheral model are kept: the counter
+ * clock (prescaler, auto-reload and repetition counter), compare registers,
+ * DMA requests and the DMA burst configuration. Output and input-capture
+ * configuration is accepted and ignored.
+ */
+
+#ifndef STM32G0XX_LL_TIM_H_
+#define STM32G0XX_LL_TIM_H_
+
+#include "stm32g0xx.h"
+
+
+#define LL_TIM_COUNTERMODE_UP 0U
+#define LL_TIM_COUNTERDIRECTION_UP 0U
+#define LL_TIM_CLOCKDIVISION_DIV1 0U
+#define LL_TIM_CLOCKDIVISION_DIV4 (2U << 8)
+#define LL_TIM_CLOCKSOURCE_INTERNAL 0U
+#define LL_TIM_TRGO_RESET 0U
+#define LL_TIM_TRGO2_RESET 0U
+#define LL_TIM_ONEPULSEMODE_SINGLE TIM_CR1_OPM
+#define LL_TIM_ONEPULSEMODE_REPETITIVE 0U
+#define LL_TIM_SLAVEMODE_RESET 4U
+#define LL_TIM_SLAVEMODE_COMBINED_RESETTRIGGER 0x10000U
+#define LL_TIM_TS_TI1FP1 (5U << 4)
+#define LL_TIM_TIM3_TI1_RMP_GPIO 0U
+#define LL_TIM_TIM3_TI2_RMP_GPIO 0U
+#define LL_TIM_TIM3_TI3_RMP_GPIO 0U
+
+#define LL_TIM_CHANNEL_CH1 (1U << 0)
+#define LL_TIM_CHANNEL_CH2 (1U << 4)
+#define LL_TIM_CHANNEL_CH3 (1U << 8)
+#define LL_TIM_CHANNEL_CH4 (1U << 12)
+
+#define LL_TIM_OCMODE_FROZEN 0U
+#define LL_TIM_OCMODE_TOGGLE 3U
+#define LL_TIM_OCMODE_FORCED_INACTIVE 4U
+#define LL_TIM_OCMODE_PWM1 6U
+#define LL_TIM_OCSTATE_DISABLE 0U
+#define LL_TIM_OCPOLARITY_HIGH 0U
+#define LL_TIM_OCIDLESTATE_LOW 0U
+
+#define LL_TIM_IC_POLARITY_RISING 0U
+#define LL_TIM_IC_POLARITY_FALLING 2U
+#define LL_TIM_ACTIVEINPUT_DIRECTTI 1U
+#define LL_TIM_ACTIVEINPUT_INDIRECTTI 2U
+#define LL_TIM_ICPSC_DIV1 0U
+#define LL_TIM_IC_FILTER_FDIV32_N8 (15U << 4)
+
+#define LL_TIM_OSSR_DISABLE 0U
+#define LL_TIM_OSSI_DISABLE 0U
+#define LL_TIM_LOCKLEVEL_OFF 0U
+#define LL_TIM_BREAK_DISABLE 0U
+#define LL_TIM_BREAK_POLARITY_HIGH 0U
+#define LL_TIM_BREAK_FILTER_FDIV1 0U
+#define LL_TIM_BREAK2_DISABLE 0U
+#define LL_TIM_BREAK2_POLARITY_HIGH 0U
+#define LL_TIM_BREAK2_FILTER_FDIV1 0U
+#define LL_TIM_AUTOMATICOUTPUT_DISABLE 0U
+
+/** @brief Offsets of the registers in 32-bit words, as in the DMA burst base address */
+#define LL_TIM_DMABURST_BASEADDR_PSC (10U << TIM_DCR_DBA_Pos)
+#define LL_TIM_DMABURST_BASEADDR_CCR1 (13U << TIM_DCR_DBA_Pos)
+#define LL_TIM_DMABURST_LENGTH_1TRANSFER (0U << TIM_DCR_DBL_Pos)
+#define LL_TIM_DMABURST_LENGTH_2TRANSFERS (1U << TIM_DCR_DBL_Pos)
+#define LL_TIM_DMABURST_LENGTH_4TRANSFERS (3U << TIM_DCR_DBL_Pos)
+
+
+struct LL_TIM_InitTypeDef
+{
+    std::uint16_t Prescaler;
+    std::uint32_t CounterMode;
+    std::uint32_t Autoreload;
+    std::uint32_t ClockDivision;
+    std::uint32_t RepetitionCounter;
+};
+
+struct LL_TIM_OC_InitTypeDef
+{
+    std::uint32_t OCMode;
+    std::uint32_t OCState;
+    std::uint32_t OCNState;
+    std::uint32_t CompareValue;
+    std::uint32_t OCPolarity;
+    std::uint32_t OCNPolarity;
+    std::uint32_t OCIdleState;
+    std::uint32_t OCNIdleState;
+};
+
+struct LL_TIM_IC_InitTypeDef
+{
+    std::uint32_t ICPolarity;
+    std::uint32_t ICActiveInput;
+    std::uint32_t ICPrescaler;
+    std::uint32_t ICFilter;
+};
+
+struct LL_TIM_BDTR_InitTypeDef
+{
+    std::uint32_t OSSRState;
+    std::uint32_t OSSIState;
+    std::uint32_t LockLevel;
+    std::uint8_t DeadTime;
+    std::uint16_t BreakState;
+    std::uint32_t BreakPolarity;
+    std::uint32_t BreakFilter;
+    std::uint32_t Break2State;
+    std::uint32_t Break2Polarity;
+    std::uint32_t Break2Filter;
+    std::uint32_t AutomaticOutput;
+};
+
+
+inline void LL_TIM_GenerateEvent_UPDATE(TIM_TypeDef * tim)
+{
+    sim::timerUpdateEvent(tim);
+}
+
+inline void LL_TIM_StructInit(LL_TIM_InitTypeDef * init)
+{
+    *init = {0, LL_TIM_COUNTERMODE_UP, 0xFFFFFFFFU, LL_TIM_CLOCKDIVISION_DIV1, 0};
+}
+
+inline ErrorStatus LL_TIM_Init(TIM_TypeDef * tim, const LL_TIM_InitTypeDef * init)
+{
+    tim->ARR = init->Autoreload;
+    tim->PSC = init->Prescaler;
+    tim->RCR = init->RepetitionCounter;
+    // Load the prescaler, as the vendor driver does
+    LL_TIM_GenerateEvent_UPDATE(tim);
+    return SUCCESS;
+}
+
+inline void LL_TIM_OC_StructInit(LL_TIM_OC_InitTypeDef * init)
+{
+    *init = {LL_TIM_OCMODE_FROZEN, LL_TIM_OCSTATE_DISABLE, LL_TIM_OCSTATE_DISABLE, 0, LL_TIM_OCPOLARITY_HIGH,
+            LL_TIM_OCPOLARITY_HIGH, LL_TIM_OCIDLESTATE_LOW, LL_TIM_OCIDLESTATE_LOW};
+}
+
+inline ErrorStatus LL_TIM_OC_Init(TIM_TypeDef * tim, std::uint32_t channel, const LL_TIM_OC_InitTypeDef * init)
+{
+    (void) tim;
+    (void) channel;
+    (void) init;
+    return SUCCESS;
+}
+
+inline void LL_TIM_IC_StructInit(LL_TIM_IC_InitTypeDef * init)
+{
+    *init = {LL_TIM_IC_POLARITY_RISING, LL_TIM_ACTIVEINPUT_DIRECTTI, LL_TIM_ICPSC_DIV1, 0};
+}
+
+inline ErrorStatus LL_TIM_IC_Init(TIM_TypeDef * tim, std::uint32_t channel, const LL_TIM_IC_InitTypeDef * init)
+{
+    (void) tim;
+    (void) channel;
+    (void) init;
+    return SUCCESS;
+}
+
+inline void LL_TIM_BDTR_StructInit(LL_TIM_BDTR_InitTypeDef * init)
+{
+    *init = {};
+}
+
+inline ErrorStatus LL_TIM_BDTR_Init(TIM_TypeDef * tim, const LL_TIM_BDTR_InitTypeDef * init)
+{
+    (void) tim;
+    (void) init;
+    return SUCCESS;
+}
+
+inline void LL_TIM_EnableCounter(TIM_TypeDef * tim)
+{
+    tim->CR1 |= TIM_CR1_CEN;
+    sim::timerEnabled(tim);
+}
+
+inline std::uint32_t LL_TIM_GetCounter(const TIM_TypeDef * tim)
+{
+    return sim::timerCounter(tim);
+}
+
+inline void LL_TIM_EnableARRPreload(TIM_TypeDef * tim) { tim->CR1 |= TIM_CR1_ARPE; }
+inline void LL_TIM_DisableARRPreload(TIM_TypeDef * tim) { tim->CR1 &= ~TIM_CR1_ARPE; }
+
+inline void LL_TIM_SetOnePulseMode(TIM_TypeDef * tim, std::uint32_t mode)
+{
+    tim->CR1 = (tim->CR1 & ~TIM_CR1_OPM) | mode;
+}
+
+inline void LL_TIM_SetPrescaler(TIM_TypeDef * tim, std::uint32_t prescaler) { tim->PSC = prescaler; }
+inline void LL_TIM_SetAutoReload(TIM_TypeDef * tim, std::uint32_t auto_reload) { tim->ARR = auto_reload; }
+inline std::uint32_t LL_TIM_GetAutoReload(const TIM_TypeDef * tim) { return tim->ARR; }
+inline void LL_TIM_SetRepetitionCounter(TIM_TypeDef * tim, std::uint32_t repetition) { tim->RCR = repetition; }
+
+inline void LL_TIM_OC_SetCompareCH1(TIM_TypeDef * tim, std::uint32_t value) { tim->CCR1 = value; }
+inline void LL_TIM_OC_SetCompareCH2(TIM_TypeDef * tim, std::uint32_t value) { tim->CCR2 = value; }
+inline void LL_TIM_OC_SetCompareCH3(TIM_TypeDef * tim, std::uint32_t value) { tim->CCR3 = value; }
+inline void LL_TIM_OC_SetCompareCH4(TIM_TypeDef * tim, std::uint32_t value) { tim->CCR4 = value; }
+inline std::uint32_t LL_TIM_IC_GetCaptureCH2(const TIM_TypeDef * tim) { return tim->CCR2; }
+
+inline void LL_TIM_CC_EnableChannel(TIM_TypeDef * tim, std::uint32_t channels) { tim->CCER |= channels; }
+
+inline void LL_TIM_OC_SetMode(TIM_TypeDef * tim, std::uint32_t channel, std::uint32_t mode)
+{
+    (void) tim;
+    (void) channel;
+    (void) mode;
+}
+
+inline void LL_TIM_OC_EnablePreload(TIM_TypeDef * tim, std::uint32_t channel) { (void) tim; (void) channel; }
+inline void LL_TIM_OC_DisableFast(TIM_TypeDef * tim, std::uint32_t channel) { (void) tim; (void) channel; }
+inline void LL_TIM_EnableAllOutputs(TIM_TypeDef * tim) { (void) tim; }
+
+inline void LL_TIM_SetClockSource(TIM_TypeDef * tim, std::uint32_t source) { (void) tim; (void) source; }
+inline void LL_TIM_SetTriggerOutput(TIM_TypeDef * tim, std::uint32_t trigger) { (void) tim; (void) trigger; }
+inline void LL_TIM_SetTriggerOutput2(TIM_TypeDef * tim, std::uint32_t trigger) { (void) tim; (void) trigger; }
+inline void LL_TIM_DisableMasterSlaveMode(TIM_TypeDef * tim) { (void) tim; }
+inline void LL_TIM_SetRemap(TIM_TypeDef * tim, std::uint32_t remap) { (void) tim; (void) remap; }
+inline void LL_TIM_SetTriggerInput(TIM_TypeDef * tim, std::uint32_t trigger) { (void) tim; (void) trigger; }
+inline void LL_TIM_SetSlaveMode(TIM_TypeDef * tim, std::uint32_t mode) { (void) tim; (void) mode; }
+
+inline void LL_TIM_ConfigDMABurst(TIM_TypeDef * tim, std::uint32_t base_address, std::uint32_t length)
+{
+    tim->DCR = base_address | length;
+}
+
+inline void LL_TIM_EnableDMAReq_UPDATE(TIM_TypeDef * tim) { tim->DIER |= TIM_DIER_UDE; }
+inline void LL_TIM_DisableDMAReq_UPDATE(TIM_TypeDef * tim) { tim->DIER &= ~TIM_DIER_UDE; }
+inline void LL_TIM_EnableDMAReq_CC1(TIM_TypeDef * tim) { tim->DIER |= TIM_DIER_CC1DE; }
+inline void LL_TIM_DisableIT_UPDATE(TIM_TypeDef * tim) { tim->DIER &= ~TIM_DIER_UIE; }
+inline void LL_TIM_EnableIT_CC3(TIM_TypeDef * tim) { tim->DIER |= TIM_DIER_CC3IE; }
+
+inline std::uint32_t LL_TIM_IsActiveFlag_CC3(const TIM_TypeDef * tim) { return (tim->SR & TIM_SR_CC3IF) ? 1 : 0; }
+inline void LL_TIM_ClearFlag_CC3(TIM_TypeDef * tim) { tim->SR &= ~TIM_SR_CC3IF; }
+
+
+#endif  // STM32G0XX_LL_TIM_H_
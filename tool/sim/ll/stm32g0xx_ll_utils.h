@@ -0,0 +1,18 @@
+/**
+ * @file
+ * @brief Host stand-in of the utilities LL driver
+ */
+
+#ifndef STM32G0XX_LL_UTILS_H_
+#define STM32G0XX_LL_UTILS_H_
+
+#include "stm32g0xx.h"
+
+
+inline void LL_SetSystemCoreClock(std::uint32_t hclk_frequency)
+{
+    SystemCoreClock = hclk_frequency;
+}
+
+
+#endif  // STM32G0XX_LL_UTILS_H_
@@ -0,0 +1,354 @@
+#include "machine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "driver/tools/profiler.hpp"
+#include "driver/tools/trace.hpp"
+#include "app/lights.hpp"
+
+
+std::uint32_t SystemCoreClock = 16000000;
+
+// Handlers of the firmware, the ones it does not define stay unused
+extern "C" void SysTick_Handler() __attribute__((weak));
+extern "C" void DMA1_Channel1_IRQHandler() __attribute__((weak));
+extern "C" void DMA1_Channel2_3_IRQHandler() __attribute__((weak));
+extern "C" void DMA1_Ch4_7_DMAMUX1_OVR_IRQHandler() __attribute__((weak));
+extern "C" void TIM1_BRK_UP_TRG_COM_IRQHandler() __attribute__((weak));
+extern "C" void TIM3_IRQHandler() __attribute__((weak));
+extern "C" void TIM6_DAC_LPTIM1_IRQHandler() __attribute__((weak));
+extern "C" void TIM16_IRQHandler() __attribute__((weak));
+extern "C" void I2C1_IRQHandler() __attribute__((weak));
+extern "C" void I2C2_IRQHandler() __attribute__((weak));
+
+// Application object of the firmware, see app/main.cpp
+extern Lights lights;
+
+
+namespace sim
+{
+namespace
+{
+
+const Cycles DEFAULT_DURATION_MS = 10000;
+
+struct Interrupt
+{
+    IRQn_Type irq;
+    void (* handler)();
+    bool enabled;
+    bool pending;
+    std::uint32_t count;
+};
+
+/**
+ * @brief Interrupts in the order of their priority
+ *
+ * All the interrupts of the firmware have the default priority, so the lower
+ * number wins. SysTick is configured to the lowest priority by the CMSIS.
+ */
+Interrupt interrupts[] = {
+    {DMA1_Channel1_IRQn, DMA1_Channel1_IRQHandler, false, false, 0},
+    {DMA1_Channel2_3_IRQn, DMA1_Channel2_3_IRQHandler, false, false, 0},
+    {DMA1_Ch4_7_DMAMUX1_OVR_IRQn, DMA1_Ch4_7_DMAMUX1_OVR_IRQHandler, false, false, 0},
+    {TIM1_BRK_UP_TRG_COM_IRQn, TIM1_BRK_UP_TRG_COM_IRQHandler, false, false, 0},
+    {TIM3_IRQn, TIM3_IRQHandler, false, false, 0},
+    {TIM6_DAC_LPTIM1_IRQn, TIM6_DAC_LPTIM1_IRQHandler, false, false, 0},
+    {TIM16_IRQn, TIM16_IRQHandler, false, false, 0},
+    {I2C1_IRQn, I2C1_IRQHandler, false, false, 0},
+    {I2C2_IRQn, I2C2_IRQHandler, false, false, 0},
+    {SysTick_IRQn, SysTick_Handler, false, false, 0},
+};
+
+
+/**
+ * @brief Report the input latency histograms of the firmware, see LatencyTrace
+ */
+void reportLatency(std::FILE * report)
+{
+    static const char * const STAGE_NAMES[LatencyTrace::STAGE_COUNT] = {
+        "capture-to-dispatch", "dispatch-to-frame", "frame-to-output",
+    };
+
+    for (std::size_t stage = 0; stage != LatencyTrace::STAGE_COUNT; ++stage)
+    {
+        const auto & histogram = lights.latencyTrace().histogram(static_cast<LatencyTrace::Stage>(stage));
+        std::fprintf(report, "latency %s: %u events", STAGE_NAMES[stage], static_cast<unsigned>(histogram.count()));
+        if (0 != histogram.count())
+        {
+            std::fprintf(report, ", %u..%u us, buckets:", static_cast<unsigned>(histogram.min()),
+                    static_cast<unsigned>(histogram.max()));
+            for (std::size_t n = 0; n != driver::LatencyHistogram::BUCKET_COUNT; ++n)
+            {
+                if (0 != histogram.bucket(n))
+                {
+                    std::fprintf(report, " %u+=%u", static_cast<unsigned>(driver::LatencyHistogram::bucketStart(n)),
+                            static_cast<unsigned>(histogram.bucket(n)));
+                }
+            }
+        }
+        std::fprintf(report, "\n");
+    }
+}
+
+/**
+ * @brief Report the durations of the frame profiler zones, see driver::Profiler
+ *
+ * The zones run natively on the host, their durations are host times.
+ */
+void reportProfile(std::FILE * report)
+{
+#ifdef PROFILER
+    static const char * const ZONE_NAMES[driver::Profiler::ZONE_COUNT] = {
+        "input-update", "event-handling", "music", "render", "modifier", "correction", "dma-start",
+    };
+
+    for (std::size_t zone = 0; zone != driver::Profiler::ZONE_COUNT; ++zone)
+    {
+        const auto & stats = driver::Profiler::stats(static_cast<driver::Profiler::Zone>(zone));
+        std::fprintf(report, "profile %s: %u runs", ZONE_NAMES[zone], static_cast<unsigned>(stats.histogram.count()));
+        if (0 != stats.histogram.count())
+        {
+            std::fprintf(report, ", %u..%u us, mean %u us", static_cast<unsigned>(stats.histogram.min()),
+                    static_cast<unsigned>(stats.histogram.max()), static_cast<unsigned>(stats.meanUs()));
+        }
+        std::fprintf(report, "\n");
+    }
+#else
+    (void) report;
+#endif  // PROFILER
+}
+
+/**
+ * @brief Report the output latency of LED frames and their skew against the music, see AvSync
+ */
+void reportAvSync(std::FILE * report)
+{
+    const auto & av_sync = lights.avSync();
+    const auto & skew = av_sync.skew();
+    std::fprintf(report, "av sync: output latency %u us, skew of %u notes",
+            static_cast<unsigned>(av_sync.outputLatencyUs()), static_cast<unsigned>(skew.count));
+    if (0 != skew.count)
+    {
+        std::fprintf(report, ", %d..%d us, mean %lld us, last %d us", static_cast<int>(skew.min),
+                static_cast<int>(skew.max), static_cast<long long>(skew.sum / skew.count), static_cast<int>(skew.last));
+    }
+    std::fprintf(report, "\n");
+}
+
+/**
+ * @brief Report the reads of the song store, which had to wait for the EEPROM
+ */
+void reportMusic(std::FILE * report)
+{
+    std::fprintf(report, "song store: %u misses\n", static_cast<unsigned>(lights.music().store().missCount()));
+}
+
+
+class Core
+{
+public:
+    Core():
+        wall_start_(std::chrono::steady_clock::now())
+    {
+        if (const char * const duration = std::getenv("SIM_TIME"))
+            end_ = std::strtoull(duration, nullptr, 0) * (CORE_CLOCK / 1000);
+    }
+
+    Cycles now() const { return now_; }
+    std::uint32_t primask() const { return primask_; }
+
+    void setPrimask(std::uint32_t primask)
+    {
+        primask_ = primask;
+        if (0 == primask_)
+            dispatch();
+    }
+
+    void enable(IRQn_Type irq)
+    {
+        if (Interrupt * const interrupt = find(irq))
+            interrupt->enabled = true;
+    }
+
+    void raise(IRQn_Type irq)
+    {
+        if (Interrupt * const interrupt = find(irq))
+            interrupt->pending = true;
+    }
+
+    std::uint32_t configureSysTick(std::uint32_t ticks)
+    {
+        if (0 == ticks || ticks > 0x01000000)
+            return 1;
+        systick_period_ = ticks;
+        systick_next_ = now_ + ticks;
+        enable(SysTick_IRQn);
+        return 0;
+    }
+
+    void waitForInterrupt()
+    {
+        ++sleeps_;
+        while (!hasPending())
+            advance();
+
+        if (0 == primask_)
+            dispatch();
+    }
+
+private:
+    Cycles now_ = 0;
+    Cycles end_ = DEFAULT_DURATION_MS * (CORE_CLOCK / 1000);
+    std::uint32_t primask_ = 0;
+    bool in_handler_ = false;
+
+    Cycles systick_period_ = 0;
+    Cycles systick_next_ = NEVER;
+
+    std::uint64_t sleeps_ = 0;
+    std::chrono::steady_clock::time_point wall_start_;
+
+    static Interrupt * find(IRQn_Type irq)
+    {
+        for (auto & interrupt : interrupts)
+        {
+            if (interrupt.irq == irq)
+                return &interrupt;
+        }
+        return nullptr;
+    }
+
+    static bool hasPending()
+    {
+        for (const auto & interrupt : interrupts)
+        {
+            if (interrupt.enabled && interrupt.pending)
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Move the time to the next event and process it
+     */
+    void advance()
+    {
+        const Cycles next = std::min(systick_next_, peripherals::nextEvent());
+        if (next >= end_)
+            finish();
+
+        now_ = next;
+        if (systick_next_ == now_)
+        {
+            raise(SysTick_IRQn);
+            systick_next_ += systick_period_;
+        }
+        peripherals::process();
+    }
+
+    void dispatch()
+    {
+        // Interrupts do not nest, they are all of the same priority
+        if (in_handler_)
+            return;
+
+        in_handler_ = true;
+        bool dispatched = true;
+        while (dispatched)
+        {
+            dispatched = false;
+            for (auto & interrupt : interrupts)
+            {
+                if (!interrupt.enabled || !interrupt.pending)
+                    continue;
+                interrupt.pending = false;
+                ++interrupt.count;
+                if (nullptr != interrupt.handler)
+                    interrupt.handler();
+                dispatched = true;
+                break;
+            }
+        }
+        in_handler_ = false;
+    }
+
+    [[noreturn]] void finish()
+    {
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start_).count();
+        const double simulated = static_cast<double>(end_) / CORE_CLOCK;
+
+        std::FILE * const report = stdout;
+        std::fprintf(report, "simulated %.3f s in %.3f s of host time (%.1fx)\n", simulated, wall,
+                wall > 0 ? simulated / wall : 0.0);
+        std::fprintf(report, "sleeps: %llu\n", static_cast<unsigned long long>(sleeps_));
+        std::fprintf(report, "interrupts:");
+        for (const auto & interrupt : interrupts)
+        {
+            if (0 != interrupt.count)
+                std::fprintf(report, " %d=%u", static_cast<int>(interrupt.irq), interrupt.count);
+        }
+        std::fprintf(report, "\n");
+        peripherals::finish(report);
+        reportLatency(report);
+        reportAvSync(report);
+        reportProfile(report);
+        reportMusic(report);
+
+        if (const char * const path = std::getenv("SIM_TRACE"))
+        {
+            if (std::FILE * const file = std::fopen(path, "wb"))
+            {
+                std::fwrite(driver::Trace::data(), 1, driver::Trace::size(), file);
+                std::fclose(file);
+            }
+        }
+
+        std::fflush(report);
+        std::exit(0);
+    }
+};
+
+Core core;
+
+}  // namespace
+
+
+Cycles now()
+{
+    return core.now();
+}
+
+void raiseIrq(IRQn_Type irq)
+{
+    core.raise(irq);
+}
+
+std::uint32_t getPrimask()
+{
+    return core.primask();
+}
+
+void setPrimask(std::uint32_t primask)
+{
+    core.setPrimask(primask);
+}
+
+void waitForInterrupt()
+{
+    core.waitForInterrupt();
+}
+
+void enableIrq(IRQn_Type irq)
+{
+    core.enable(irq);
+}
+
+std::uint32_t configureSysTick(std::uint32_t ticks)
+{
+    return core.configureSysTick(ticks);
+}
+
+}  // namespace sim
@@ -0,0 +1,71 @@
+/**
+ * @file
+ */
+
+#ifndef TOOL_SIM_MACHINE_HPP_
+#define TOOL_SIM_MACHINE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "stm32g0xx.h"
+
+
+namespace sim
+{
+
+/** @brief Simulated time in cycles of the core clock */
+using Cycles = std::uint64_t;
+
+static const inline std::uint32_t CORE_CLOCK = 64000000;
+static const inline Cycles CYCLES_PER_US = CORE_CLOCK / 1000000;
+static const inline Cycles NEVER = ~Cycles{0};
+
+/**
+ * @brief Get the current simulated time
+ *
+ * The time advances only while the core sleeps in @ref waitForInterrupt(), so
+ * the firmware code itself takes no simulated time.
+ */
+Cycles now();
+
+/**
+ * @brief Make an interrupt pending
+ *
+ * The interrupt is dispatched once it is enabled and the interrupts are not
+ * masked, at the latest when the core goes to sleep.
+ */
+void raiseIrq(IRQn_Type irq);
+
+
+/**
+ * @brief Model of the peripherals of the board
+ *
+ * Every model reports the time of its next event and processes the events due
+ * at the current time.
+ */
+namespace peripherals
+{
+
+/**
+ * @brief Get the time of the earliest event of the peripherals
+ */
+Cycles nextEvent();
+
+/**
+ * @brief Process the events due at the current time
+ */
+void process();
+
+/**
+ * @brief Print statistics of the peripherals and store their outputs
+ */
+void finish(std::FILE * report);
+
+}  // namespace peripherals
+
+}  // namespace sim
+
+
+#endif  // TOOL_SIM_MACHINE_HPP_
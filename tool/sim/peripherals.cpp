@@ -0,0 +1,911 @@
+#include "machine.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "stm32g0xx_ll_dma.h"
+#include "stm32g0xx_ll_gpio.h"
+#include "stm32g0xx_ll_i2c.h"
+#include "stm32g0xx_ll_tim.h"
+#include "stm32g0xx_ll_dmamux.h"
+#include "support/cpu_pins.h"
+
+
+TIM_TypeDef sim_tim1 = {};
+TIM_TypeDef sim_tim3 = {};
+TIM_TypeDef sim_tim6 = {};
+TIM_TypeDef sim_tim16 = {};
+DMA_TypeDef sim_dma1 = {};
+DMAMUX_Channel_TypeDef sim_dmamux1[7] = {};
+I2C_TypeDef sim_i2c1 = {};
+I2C_TypeDef sim_i2c2 = {};
+// The keypad has external pull-ups, released keys read high
+GPIO_TypeDef sim_gpioa = {0, 0xFFFF, 0};
+GPIO_TypeDef sim_gpiob = {0, 0xFFFF, 0};
+GPIO_TypeDef sim_gpioc = {0, 0xFFFF, 0};
+
+
+namespace sim
+{
+namespace
+{
+
+const std::size_t DMA_CHANNEL_COUNT = 7;
+
+std::uint32_t readPeripheral(std::uintptr_t address, std::size_t size);
+void writePeripheral(std::uintptr_t address, std::uint32_t value, std::size_t size);
+
+std::uint32_t readMemory(std::uintptr_t address, std::size_t size)
+{
+    std::uint32_t value = 0;
+    std::memcpy(&value, reinterpret_cast<const void *>(address), size);
+    return value;
+}
+
+void writeMemory(std::uintptr_t address, std::uint32_t value, std::size_t size)
+{
+    std::memcpy(reinterpret_cast<void *>(address), &value, size);
+}
+
+template <typename T>
+bool isWithin(std::uintptr_t address, const T * object)
+{
+    const auto begin = reinterpret_cast<std::uintptr_t>(object);
+    return address >= begin && address < begin + sizeof(T);
+}
+
+IRQn_Type toDmaIrq(std::uint32_t channel)
+{
+    switch (channel)
+    {
+    case LL_DMA_CHANNEL_1: return DMA1_Channel1_IRQn;
+    case LL_DMA_CHANNEL_2:
+    case LL_DMA_CHANNEL_3: return DMA1_Channel2_3_IRQn;
+    default: return DMA1_Ch4_7_DMAMUX1_OVR_IRQn;
+    }
+}
+
+
+/**
+ * @brief DMA controller transferring one item per request of a peripheral
+ */
+class Dma
+{
+public:
+    void enabled(std::uint32_t channel)
+    {
+        reload_[channel] = sim_dma1.CHANNEL[channel].CNDTR;
+    }
+
+    /**
+     * @brief Check whether an enabled channel with remaining data serves the request
+     */
+    bool isServing(std::uint32_t request) const
+    {
+        return DMA_CHANNEL_COUNT != findChannel(request);
+    }
+
+    /**
+     * @brief Transfer a single item for the request
+     *
+     * @return The request was served by a channel
+     */
+    bool request(std::uint32_t request)
+    {
+        const std::size_t channel = findChannel(request);
+        if (DMA_CHANNEL_COUNT == channel)
+            return false;
+
+        auto & regs = sim_dma1.CHANNEL[channel];
+        const std::uint32_t reload = reload_[channel];
+        const std::size_t index = reload - regs.CNDTR;
+        const std::size_t memory_size = std::size_t{1} << ((regs.CCR & DMA_CCR_MSIZE) >> DMA_CCR_MSIZE_Pos);
+        const std::size_t periph_size = std::size_t{1} << ((regs.CCR & DMA_CCR_PSIZE) >> DMA_CCR_PSIZE_Pos);
+        const std::uintptr_t memory = regs.CMAR + ((regs.CCR & DMA_CCR_MINC) ? index * memory_size : 0);
+        const std::uintptr_t periph = regs.CPAR + ((regs.CCR & DMA_CCR_PINC) ? index * periph_size : 0);
+
+        if (regs.CCR & DMA_CCR_DIR)
+            writePeripheral(periph, readMemory(memory, memory_size), periph_size);
+        else
+            writeMemory(memory, readPeripheral(periph, periph_size), memory_size);
+        ++transfers_[channel];
+
+        std::uint32_t flags = 0;
+        bool interrupt = false;
+        regs.CNDTR = regs.CNDTR - 1;
+        if (reload / 2 == regs.CNDTR)
+        {
+            flags |= DMA_ISR_HTIF(channel);
+            interrupt |= 0 != (regs.CCR & DMA_CCR_HTIE);
+        }
+        if (0 == regs.CNDTR)
+        {
+            flags |= DMA_ISR_TCIF(channel);
+            interrupt |= 0 != (regs.CCR & DMA_CCR_TCIE);
+            if (regs.CCR & DMA_CCR_CIRC)
+                regs.CNDTR = reload;
+        }
+        if (0 != flags)
+        {
+            sim_dma1.ISR |= flags | DMA_ISR_GIF(channel);
+            if (interrupt)
+                raiseIrq(toDmaIrq(channel));
+        }
+        return true;
+    }
+
+    void report(std::FILE * report) const
+    {
+        std::fprintf(report, "dma transfers:");
+        for (std::size_t channel = 0; channel != DMA_CHANNEL_COUNT; ++channel)
+        {
+            if (0 != transfers_[channel])
+                std::fprintf(report, " ch%zu=%llu", channel + 1, static_cast<unsigned long long>(transfers_[channel]));
+        }
+        std::fprintf(report, "\n");
+    }
+
+private:
+    std::uint32_t reload_[DMA_CHANNEL_COUNT] = {};
+    std::uint64_t transfers_[DMA_CHANNEL_COUNT] = {};
+
+    static std::size_t findChannel(std::uint32_t request)
+    {
+        for (std::size_t channel = 0; channel != DMA_CHANNEL_COUNT; ++channel)
+        {
+            const auto & regs = sim_dma1.CHANNEL[channel];
+            if ((sim_dmamux1[channel].CCR & DMAMUX_CxCR_DMAREQ_ID_Msk) == request &&
+                    (regs.CCR & DMA_CCR_EN) && 0 != regs.CNDTR)
+                return channel;
+        }
+        return DMA_CHANNEL_COUNT;
+    }
+};
+
+Dma dma;
+
+
+/**
+ * @brief Data line of the WS2812B strip, driven by the PWM channel of a timer
+ *
+ * Compare values of the PWM bits are decoded back into the bytes sent to the
+ * LEDs. A blank bit following the data ends the frame.
+ */
+class LedOutput
+{
+public:
+    explicit LedOutput(const TIM_TypeDef * tim):
+        tim_(tim)
+    { }
+
+    void open(const char * path)
+    {
+        if (nullptr != path)
+            file_ = std::fopen(path, "wb");
+    }
+
+    void write(std::uint32_t compare)
+    {
+        if (0 == compare)
+        {
+            if (!frame_.empty())
+                finishFrame();
+            return;
+        }
+
+        // Longer pulses (T1H) encode ones
+        byte_ = static_cast<std::uint8_t>((byte_ << 1) | ((compare * 2) > (tim_->ARR + 1) ? 1 : 0));
+        if (8 == ++bits_)
+        {
+            frame_.push_back(byte_);
+            bits_ = 0;
+        }
+    }
+
+    void report(std::FILE * report)
+    {
+        if (nullptr != file_)
+            std::fclose(file_);
+
+        std::fprintf(report, "led frames: %llu, %zu bytes, interval %.3f..%.3f ms, hash %016llx\n",
+                static_cast<unsigned long long>(frames_), last_size_,
+                static_cast<double>(min_interval_ == NEVER ? 0 : min_interval_) / (CORE_CLOCK / 1000),
+                static_cast<double>(max_interval_) / (CORE_CLOCK / 1000),
+                static_cast<unsigned long long>(hash_));
+    }
+
+private:
+    const TIM_TypeDef * tim_;
+    std::vector<std::uint8_t> frame_;
+    std::uint8_t byte_ = 0;
+    std::size_t bits_ = 0;
+
+    std::FILE * file_ = nullptr;
+    std::uint64_t frames_ = 0;
+    std::size_t last_size_ = 0;
+    /** @brief FNV-1a hash of all the frames */
+    std::uint64_t hash_ = 0xCBF29CE484222325;
+    Cycles last_frame_ = NEVER;
+    Cycles min_interval_ = NEVER;
+    Cycles max_interval_ = 0;
+
+    void finishFrame()
+    {
+        const Cycles time = now();
+        if (NEVER != last_frame_)
+        {
+            min_interval_ = std::min(min_interval_, time - last_frame_);
+            max_interval_ = std::max(max_interval_, time - last_frame_);
+        }
+        last_frame_ = time;
+
+        for (const std::uint8_t byte : frame_)
+            hash_ = (hash_ ^ byte) * 0x100000001B3;
+        ++frames_;
+        last_size_ = frame_.size();
+
+        // Records of the frame file: time in microseconds and length, both
+        // little-endian 32-bit, followed by the data
+        if (nullptr != file_)
+        {
+            const std::uint32_t header[2] = {
+                static_cast<std::uint32_t>(time / CYCLES_PER_US), static_cast<std::uint32_t>(frame_.size())
+            };
+            std::fwrite(header, sizeof(header), 1, file_);
+            std::fwrite(frame_.data(), 1, frame_.size(), file_);
+        }
+
+        frame_.clear();
+        bits_ = 0;
+    }
+};
+
+LedOutput led_output(TIM1);
+
+
+/**
+ * @brief Buzzer driven by the toggling output-compare channel of a timer
+ */
+class BuzzerOutput
+{
+public:
+    void segment(const TIM_TypeDef * tim, Cycles duration)
+    {
+        ++segments_;
+        // Compare value above the auto-reload value never toggles the output
+        if (tim->CCR1 <= tim->ARR)
+            tone_ += duration;
+    }
+
+    void report(std::FILE * report) const
+    {
+        std::fprintf(report, "buzzer: %llu segments, tone %.3f s\n", static_cast<unsigned long long>(segments_),
+                static_cast<double>(tone_) / CORE_CLOCK);
+    }
+
+private:
+    std::uint64_t segments_ = 0;
+    Cycles tone_ = 0;
+};
+
+BuzzerOutput buzzer_output;
+
+
+/**
+ * @brief Counter, update events and DMA requests of a timer
+ *
+ * The update events are simulated only while they request DMA transfers,
+ * otherwise nothing observes them. The prescaler, auto-reload and repetition
+ * counter are loaded on the update events, as with the preload enabled.
+ */
+class Timer
+{
+public:
+    Timer(TIM_TypeDef * regs, std::uint32_t update_request):
+        regs_(regs),
+        update_request_(update_request)
+    { }
+
+    TIM_TypeDef * regs() const { return regs_; }
+
+    std::uint32_t counter() const
+    {
+        if (0 == (regs_->CR1 & TIM_CR1_CEN))
+            return regs_->CNT;
+        const Cycles ticks = (now() - epoch_) / (Cycles{psc_} + 1);
+        return static_cast<std::uint32_t>(ticks % ((Cycles{arr_} & 0xFFFF) + 1));
+    }
+
+    void enabled()
+    {
+        epoch_ = now();
+        last_update_ = now();
+    }
+
+    Cycles nextEvent()
+    {
+        if (0 == (regs_->CR1 & TIM_CR1_CEN) || 0 == (regs_->DIER & TIM_DIER_UDE) || !dma.isServing(update_request_))
+            return NEVER;
+
+        // Skip the update events, which did not request anything
+        const Cycles period = this->period();
+        if (last_update_ + period < now())
+            last_update_ += ((now() - last_update_) / period) * period;
+        return last_update_ + period;
+    }
+
+    void process()
+    {
+        if (now() == nextEvent())
+            update();
+    }
+
+    void update()
+    {
+        last_update_ = now();
+        epoch_ = now();
+        psc_ = regs_->PSC;
+        arr_ = regs_->ARR;
+        rcr_ = regs_->RCR;
+
+        if (&sim_tim16 == regs_)
+            buzzer_output.segment(regs_, period());
+
+        if (regs_->DIER & TIM_DIER_UDE)
+        {
+            // DMA burst issues a request per transferred register
+            burst_index_ = 0;
+            const std::uint32_t requests = (0 == regs_->DCR) ? 1 : ((regs_->DCR & TIM_DCR_DBL_Msk) >> TIM_DCR_DBL_Pos) + 1;
+            for (std::uint32_t n = 0; n != requests; ++n)
+                dma.request(update_request_);
+        }
+    }
+
+    bool read(std::uintptr_t address, std::uint32_t * value)
+    {
+        if (!isWithin(address, regs_))
+            return false;
+        *value = *toRegister(address);
+        return true;
+    }
+
+    bool write(std::uintptr_t address, std::uint32_t value)
+    {
+        if (!isWithin(address, regs_))
+            return false;
+        volatile std::uint32_t * const reg = toRegister(address);
+        *reg = value;
+        if (&sim_tim1 == regs_ && &(regs_->CCR2) == reg)
+            led_output.write(value);
+        return true;
+    }
+
+private:
+    TIM_TypeDef * regs_;
+    std::uint32_t update_request_;
+
+    Cycles epoch_ = 0;
+    Cycles last_update_ = 0;
+    std::uint32_t psc_ = 0;
+    std::uint32_t arr_ = 0xFFFF;
+    std::uint32_t rcr_ = 0;
+    std::uint32_t burst_index_ = 0;
+
+    Cycles period() const
+    {
+        const std::uint32_t arr = (regs_->CR1 & TIM_CR1_ARPE) ? arr_ : regs_->ARR;
+        return (Cycles{psc_} + 1) * ((Cycles{arr} & 0xFFFF) + 1) * (Cycles{rcr_} + 1);
+    }
+
+    /**
+     * @brief Resolve the address, accesses to DMAR are redirected by the DMA burst
+     */
+    volatile std::uint32_t * toRegister(std::uintptr_t address)
+    {
+        if (reinterpret_cast<std::uintptr_t>(&(regs_->DMAR)) != address)
+            return reinterpret_cast<volatile std::uint32_t *>(address);
+
+        const std::uint32_t offset = ((regs_->DCR & TIM_DCR_DBA_Msk) >> TIM_DCR_DBA_Pos) + burst_index_++;
+        switch (offset)
+        {
+        case 10: return &(regs_->PSC);
+        case 11: return &(regs_->ARR);
+        case 12: return &(regs_->RCR);
+        case 13: return &(regs_->CCR1);
+        case 14: return &(regs_->CCR2);
+        case 15: return &(regs_->CCR3);
+        case 16: return &(regs_->CCR4);
+        default: return &(regs_->DMAR);
+        }
+    }
+};
+
+Timer timers[] = {
+    {TIM1, LL_DMAMUX_REQ_TIM1_UP},
+    {TIM3, LL_DMAMUX_REQ_TIM3_UP},
+    {TIM6, 0xFF},
+    {TIM16, LL_DMAMUX_REQ_TIM16_UP},
+};
+
+Timer * findTimer(const TIM_TypeDef * tim)
+{
+    for (auto & timer : timers)
+    {
+        if (timer.regs() == tim)
+            return &timer;
+    }
+    return nullptr;
+}
+
+
+/**
+ * @brief CAT24C256 EEPROM with 16-bit memory addresses
+ *
+ * The EEPROM does not acknowledge its address during the write cycle, which
+ * starts by the STOP condition. Data of a repeated START are written as well.
+ */
+class Eeprom
+{
+public:
+    static const inline std::size_t SIZE = 32768;
+    static const inline std::size_t PAGE_SIZE = 64;
+    static const inline Cycles WRITE_CYCLE = 5 * (CORE_CLOCK / 1000);
+
+    Eeprom()
+    {
+        std::memset(data_, 0xFF, sizeof(data_));
+    }
+
+    void load(const char * path)
+    {
+        path_ = path;
+        if (nullptr == path_)
+            return;
+        if (std::FILE * const file = std::fopen(path_, "rb"))
+        {
+            const std::size_t loaded = std::fread(data_, 1, sizeof(data_), file);
+            (void) loaded;
+            std::fclose(file);
+        }
+    }
+
+    bool acknowledge() const { return now() >= busy_until_; }
+
+    void start(bool read)
+    {
+        finishWrite();
+        address_bytes_ = read ? 2 : 0;
+    }
+
+    void stop()
+    {
+        finishWrite();
+    }
+
+    void write(std::uint8_t value)
+    {
+        if (address_bytes_ < 2)
+        {
+            address_ = ((address_ << 8) | value) & (SIZE - 1);
+            ++address_bytes_;
+            return;
+        }
+        data_[address_] = value;
+        // Address rolls over within the page
+        address_ = (address_ & ~(PAGE_SIZE - 1)) | ((address_ + 1) & (PAGE_SIZE - 1));
+        written_ = true;
+        ++written_bytes_;
+    }
+
+    std::uint8_t read()
+    {
+        const std::uint8_t value = data_[address_];
+        address_ = (address_ + 1) & (SIZE - 1);
+        ++read_bytes_;
+        return value;
+    }
+
+    void report(std::FILE * report) const
+    {
+        std::fprintf(report, "eeprom: %llu bytes read, %llu bytes written in %llu write cycles\n",
+                static_cast<unsigned long long>(read_bytes_), static_cast<unsigned long long>(written_bytes_),
+                static_cast<unsigned long long>(write_cycles_));
+
+        if (nullptr == path_)
+            return;
+        if (std::FILE * const file = std::fopen(path_, "wb"))
+        {
+            std::fwrite(data_, 1, sizeof(data_), file);
+            std::fclose(file);
+        }
+    }
+
+private:
+    std::uint8_t data_[SIZE];
+    const char * path_ = nullptr;
+
+    std::size_t address_ = 0;
+    std::size_t address_bytes_ = 0;
+    bool written_ = false;
+    Cycles busy_until_ = 0;
+
+    std::uint64_t read_bytes_ = 0;
+    std::uint64_t written_bytes_ = 0;
+    std::uint64_t write_cycles_ = 0;
+
+    void finishWrite()
+    {
+        if (!written_)
+            return;
+        written_ = false;
+        busy_until_ = now() + WRITE_CYCLE;
+        ++write_cycles_;
+    }
+};
+
+Eeprom eeprom;
+
+
+/**
+ * @brief I2C master transferring the bytes of a transfer at once, when it ends
+ */
+class I2c
+{
+public:
+    /** @brief Duration of a single byte with the acknowledge bit, SCL runs at 400 kHz */
+    static const inline Cycles BYTE_DURATION = 9 * (CORE_CLOCK / 400000);
+
+    static const inline std::uint32_t EEPROM_ADDRESS = 0b1010000;
+
+    I2c(I2C_TypeDef * regs, IRQn_Type irq, std::uint32_t rx_request, std::uint32_t tx_request):
+        regs_(regs),
+        irq_(irq),
+        rx_request_(rx_request),
+        tx_request_(tx_request)
+    { }
+
+    I2C_TypeDef * regs() const { return regs_; }
+    Cycles nextEvent() const { return done_; }
+
+    void transfer()
+    {
+        regs_->ISR &= ~(I2C_ISR_TC | I2C_ISR_TCR);
+        const std::uint32_t cr2 = regs_->CR2;
+        bytes_ = (cr2 & I2C_CR2_NBYTES_Msk) >> I2C_CR2_NBYTES_Pos;
+        Cycles duration = bytes_ * BYTE_DURATION;
+
+        if (cr2 & I2C_CR2_START)
+        {
+            ++transactions_;
+            read_ = 0 != (cr2 & I2C_CR2_RD_WRN);
+            eeprom_ = EEPROM_ADDRESS == ((cr2 & I2C_CR2_SADD_Msk) >> 1);
+            nack_ = !eeprom_ || !eeprom.acknowledge();
+            if (nack_)
+                duration = 0;
+            else
+                eeprom.start(read_);
+            duration += BYTE_DURATION;
+        }
+        regs_->ISR |= I2C_ISR_BUSY;
+        done_ = now() + duration;
+    }
+
+    void stop()
+    {
+        regs_->ISR &= ~(I2C_ISR_TC | I2C_ISR_TCR | I2C_ISR_BUSY);
+        regs_->CR2 &= ~I2C_CR2_STOP;
+        done_ = NEVER;
+        if (eeprom_)
+            eeprom.stop();
+        eeprom_ = false;
+    }
+
+    void process()
+    {
+        if (now() != done_)
+            return;
+        done_ = NEVER;
+
+        if (nack_)
+        {
+            // The master generates STOP after NACK by itself
+            ++nacks_;
+            regs_->ISR = (regs_->ISR & ~I2C_ISR_BUSY) | I2C_ISR_NACKF;
+            eeprom_ = false;
+            if (regs_->CR1 & I2C_CR1_NACKIE)
+                raiseIrq(irq_);
+            return;
+        }
+
+        for (std::uint32_t n = 0; n != bytes_; ++n)
+        {
+            if (read_)
+            {
+                regs_->RXDR = eeprom.read();
+                if (0 == (regs_->CR1 & I2C_CR1_RXDMAEN) || !dma.request(rx_request_))
+                    ++lost_bytes_;
+            }
+            else if (0 == (regs_->CR1 & I2C_CR1_TXDMAEN) || !dma.request(tx_request_))
+            {
+                ++lost_bytes_;
+            }
+        }
+        transferred_bytes_ += bytes_;
+
+        if (regs_->CR2 & I2C_CR2_RELOAD)
+        {
+            regs_->ISR |= I2C_ISR_TCR;
+        }
+        else if (regs_->CR2 & I2C_CR2_AUTOEND)
+        {
+            stop();
+            return;
+        }
+        else
+        {
+            regs_->ISR |= I2C_ISR_TC;
+        }
+        if (regs_->CR1 & I2C_CR1_TCIE)
+            raiseIrq(irq_);
+    }
+
+    std::uint32_t receive() const { return regs_->RXDR; }
+
+    void transmit(std::uint32_t value)
+    {
+        regs_->TXDR = value;
+        if (eeprom_)
+            eeprom.write(static_cast<std::uint8_t>(value));
+    }
+
+    void report(std::FILE * report) const
+    {
+        std::fprintf(report, "i2c: %llu transactions, %llu not acknowledged, %llu bytes, %llu bytes without DMA\n",
+                static_cast<unsigned long long>(transactions_), static_cast<unsigned long long>(nacks_),
+                static_cast<unsigned long long>(transferred_bytes_), static_cast<unsigned long long>(lost_bytes_));
+    }
+
+private:
+    I2C_TypeDef * regs_;
+    IRQn_Type irq_;
+    std::uint32_t rx_request_;
+    std::uint32_t tx_request_;
+
+    Cycles done_ = NEVER;
+    std::uint32_t bytes_ = 0;
+    bool read_ = false;
+    bool nack_ = false;
+    bool eeprom_ = false;
+
+    std::uint64_t transactions_ = 0;
+    std::uint64_t nacks_ = 0;
+    std::uint64_t transferred_bytes_ = 0;
+    std::uint64_t lost_bytes_ = 0;
+};
+
+I2c i2c1(I2C1, I2C1_IRQn, LL_DMAMUX_REQ_I2C1_RX, LL_DMAMUX_REQ_I2C1_TX);
+
+
+/**
+ * @brief Key presses scripted by the `SIM_KEYS` variable
+ *
+ * The variable is a comma separated list of `<time ms>:<key>[:<duration ms>]`,
+ * where the key is one of `o`, `left`, `up`, `down`, `right` and `x`.
+ */
+class Keys
+{
+public:
+    static const inline Cycles DEFAULT_PRESS = 100 * (CORE_CLOCK / 1000);
+
+    void load(const char * script)
+    {
+        if (nullptr == script)
+            return;
+
+        const std::string text(script);
+        std::size_t pos = 0;
+        while (pos < text.size())
+        {
+            std::size_t end = text.find(',', pos);
+            if (std::string::npos == end)
+                end = text.size();
+            parse(text.substr(pos, end - pos));
+            pos = end + 1;
+        }
+    }
+
+    Cycles nextEvent() const
+    {
+        return next_ == events_.size() ? NEVER : events_[next_].time;
+    }
+
+    void process()
+    {
+        for (; next_ != events_.size() && events_[next_].time == now(); ++next_)
+        {
+            const Event & event = events_[next_];
+            if (event.pressed)
+                event.gpio->IDR &= ~event.pin;
+            else
+                event.gpio->IDR |= event.pin;
+        }
+    }
+
+private:
+    struct Event
+    {
+        Cycles time;
+        GPIO_TypeDef * gpio;
+        std::uint32_t pin;
+        bool pressed;
+    };
+
+    std::vector<Event> events_;
+    std::size_t next_ = 0;
+
+    void parse(const std::string & item)
+    {
+        static const struct
+        {
+            const char * name;
+            GPIO_TypeDef * gpio;
+            std::uint32_t pin;
+        } KEYS[] = {
+            {"o", BTN_O_GPIO_Port, BTN_O_Pin},
+            {"left", BTN_LEFT_GPIO_Port, BTN_LEFT_Pin},
+            {"up", BTN_UP_GPIO_Port, BTN_UP_Pin},
+            {"down", BTN_DOWN_GPIO_Port, BTN_DOWN_Pin},
+            {"right", BTN_RIGHT_GPIO_Port, BTN_RIGHT_Pin},
+            {"x", BTN_X_GPIO_Port, BTN_X_Pin},
+        };
+
+        char * end;
+        const Cycles time = std::strtoull(item.c_str(), &end, 0) * (CORE_CLOCK / 1000);
+        if (':' != *end)
+            return;
+        const std::string rest(end + 1);
+        const std::size_t colon = rest.find(':');
+        const std::string name = rest.substr(0, colon);
+        const Cycles duration = (std::string::npos == colon) ? DEFAULT_PRESS :
+                std::strtoull(rest.c_str() + colon + 1, nullptr, 0) * (CORE_CLOCK / 1000);
+
+        for (const auto & key : KEYS)
+        {
+            if (name != key.name)
+                continue;
+            insert({time, key.gpio, key.pin, true});
+            insert({time + duration, key.gpio, key.pin, false});
+            return;
+        }
+        std::fprintf(stderr, "Unknown key in SIM_KEYS: %s\n", item.c_str());
+    }
+
+    void insert(const Event & event)
+    {
+        auto pos = events_.begin();
+        while (pos != events_.end() && pos->time <= event.time)
+            ++pos;
+        events_.insert(pos, event);
+    }
+};
+
+Keys keys;
+
+
+std::uint32_t readPeripheral(std::uintptr_t address, std::size_t size)
+{
+    std::uint32_t value;
+    for (auto & timer : timers)
+    {
+        if (timer.read(address, &value))
+            return value;
+    }
+    if (isWithin(address, i2c1.regs()))
+        return i2c1.receive();
+    return readMemory(address, size);
+}
+
+void writePeripheral(std::uintptr_t address, std::uint32_t value, std::size_t size)
+{
+    for (auto & timer : timers)
+    {
+        if (timer.write(address, value))
+            return;
+    }
+    if (reinterpret_cast<std::uintptr_t>(&(i2c1.regs()->TXDR)) == address)
+    {
+        i2c1.transmit(value);
+        return;
+    }
+    writeMemory(address, value, size);
+}
+
+
+/**
+ * @brief Read the configuration from the environment before the firmware starts
+ */
+struct Configuration
+{
+    Configuration()
+    {
+        eeprom.load(std::getenv("SIM_EEPROM"));
+        led_output.open(std::getenv("SIM_FRAMES"));
+        keys.load(std::getenv("SIM_KEYS"));
+    }
+};
+
+const Configuration configuration;
+
+}  // namespace
+
+
+namespace peripherals
+{
+
+Cycles nextEvent()
+{
+    Cycles next = std::min(i2c1.nextEvent(), keys.nextEvent());
+    for (auto & timer : timers)
+        next = std::min(next, timer.nextEvent());
+    return next;
+}
+
+void process()
+{
+    for (auto & timer : timers)
+        timer.process();
+    i2c1.process();
+    keys.process();
+}
+
+void finish(std::FILE * report)
+{
+    dma.report(report);
+    led_output.report(report);
+    buzzer_output.report(report);
+    i2c1.report(report);
+    eeprom.report(report);
+}
+
+}  // namespace peripherals
+
+
+std::uint32_t timerCounter(const TIM_TypeDef * tim)
+{
+    const Timer * const timer = findTimer(tim);
+    return nullptr == timer ? 0 : timer->counter();
+}
+
+void timerEnabled(TIM_TypeDef * tim)
+{
+    if (Timer * const timer = findTimer(tim))
+        timer->enabled();
+}
+
+void timerUpdateEvent(TIM_TypeDef * tim)
+{
+    if (Timer * const timer = findTimer(tim))
+        timer->update();
+}
+
+void dmaChannelEnabled(DMA_TypeDef * dma_regs, std::uint32_t channel)
+{
+    (void) dma_regs;
+    dma.enabled(channel);
+}
+
+void i2cTransfer(I2C_TypeDef * i2c)
+{
+    if (i2c == i2c1.regs())
+        i2c1.transfer();
+}
+
+void i2cStop(I2C_TypeDef * i2c)
+{
+    if (i2c == i2c1.regs())
+        i2c1.stop();
+}
+
+}  // namespace sim
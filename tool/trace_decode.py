@@ -0,0 +1,133 @@
+"""Decode the RAM trace ring of the firmware into a timeline
+
+The input is a binary memory dump containing the ring (e.g. the whole RAM
+dumped by a debugger), or the ring saved by a host build. Names of the events
+are read from the `TraceEvent` enumeration of the firmware.
+"""
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+from typing import Iterable, NamedTuple
+
+
+MAGIC = 0x31435254  # "TRC1"
+RING_HEADER = struct.Struct('<IHHI')
+ENTRY = struct.Struct('<HHBB')
+DEFAULT_HEADER = Path(__file__).parent / '..' / 'fw' / 'stm32g0' / 'driver' / 'tools' / 'trace.hpp'
+
+
+class Entry(NamedTuple):
+    index: int
+    timestamp: int
+    payload: int
+    event: int
+
+
+def load_event_names(header: Path) -> dict[int, str]:
+    source = header.read_text()
+    body = re.search(r'enum\s+class\s+TraceEvent\s*:[^{]*\{(.*?)\};', source, re.DOTALL)
+    if body is None:
+        raise ValueError(f"TraceEvent not found in {header}")
+
+    names = {}
+    value = 0
+    for match in re.finditer(r'^\s*([A-Z_][A-Z0-9_]*)\s*(?:=\s*(\w+))?\s*,', body.group(1), re.MULTILINE):
+        if match.group(2) is not None:
+            value = int(match.group(2), 0)
+        names[value] = match.group(1)
+        value += 1
+    return names
+
+
+def find_ring(data: bytes) -> int:
+    for offset in range(0, len(data) - RING_HEADER.size + 1, 4):
+        magic, capacity, entry_size, _ = RING_HEADER.unpack_from(data, offset)
+        if (MAGIC == magic and ENTRY.size == entry_size and 0 != capacity and 0 == (capacity & (capacity - 1)) and
+                offset + RING_HEADER.size + (capacity * entry_size) <= len(data)):
+            return offset
+    raise ValueError("Trace ring not found")
+
+
+def read_entries(data: bytes, offset: int) -> tuple[list[Entry], int]:
+    """Read the valid entries from the oldest one, return them with the number of torn entries"""
+    _, capacity, _, head = RING_HEADER.unpack_from(data, offset)
+    capacity_bits = capacity.bit_length() - 1
+
+    entries = []
+    torn = 0
+    for index in range(max(0, head - capacity), head):
+        timestamp, payload, event, lap = ENTRY.unpack_from(
+            data, offset + RING_HEADER.size + ((index % capacity) * ENTRY.size))
+        # An entry reserved but not written yet (e.g. interrupted by a crash)
+        # still holds the data of the previous lap
+        if lap != ((index >> capacity_bits) & 0xFF):
+            torn += 1
+            continue
+        entries.append(Entry(index, timestamp, payload, event))
+    return entries, torn
+
+
+def describe(name: str, payload: int) -> str:
+    match name:
+        case 'FRAME_START':
+            return f"time={payload} ms"
+        case 'FRAME_DROPPED':
+            return "led dma busy" if 0 == payload else f"skipped={payload}"
+        case 'LED_DMA_HALF' | 'BUZZER_DMA':
+            return f"half={payload}"
+        case 'I2C_DONE':
+            return f"address=0x{payload >> 8:02x} status={payload & 0xFF}"
+        case 'IR_SYMBOL':
+            return f"period={(payload >> 8) * 100} us mark={(payload & 0xFF) * 100} us"
+        case 'SLOT_CHANGE':
+            return f"slot={payload}"
+    return f"payload=0x{payload:04x}"
+
+
+def timeline(entries: Iterable[Entry], names: dict[int, str]) -> Iterable[str]:
+    time = 0
+    previous = None
+    for entry in entries:
+        # Timestamps wrap every 65.536 ms, frames are traced often enough to
+        # unwrap them
+        if previous is not None:
+            time += (entry.timestamp - previous) & 0xFFFF
+        previous = entry.timestamp
+
+        name = names.get(entry.event, f"EVENT_{entry.event}")
+        yield f"{time / 1000:12.3f} ms  #{entry.index:<8} {name:<16} {describe(name, entry.payload)}"
+
+
+def main():
+    arg_parser = argparse.ArgumentParser(description="Tool to decode the trace ring of the firmware")
+    arg_parser.add_argument("dump", metavar="DUMP", help="Binary memory dump containing the trace ring")
+    arg_parser.add_argument(
+        "--header", metavar="HEADER", type=Path, default=DEFAULT_HEADER,
+        help="Header defining the trace events")
+    arg_parser.add_argument(
+        "-e", "--event", metavar="NAME", action='append', default=[],
+        help="Show only given events, can be repeated")
+
+    args = arg_parser.parse_args()
+
+    names = load_event_names(args.header)
+    data = Path(args.dump).read_bytes()
+    offset = find_ring(data)
+    entries, torn = read_entries(data, offset)
+
+    if args.event:
+        wanted = {value for value, name in names.items() if name in args.event}
+        lines = (line for entry, line in zip(entries, timeline(entries, names)) if entry.event in wanted)
+    else:
+        lines = timeline(entries, names)
+
+    print(f"Ring at offset 0x{offset:x}, {len(entries)} entries, {torn} torn")
+    for line in lines:
+        print(line)
+
+
+if __name__ == "__main__":
+    sys.exit(main())